@@ -10,9 +10,17 @@
 #include "fsl_clock.h"
 #include "keypad_driver.h"
 #include "output_mgr.h"
+#include "tamper_mgr.h"
+#include "selftest.h"
+#include "board_pins.h"
 
 static volatile uint32_t g_systemTick = 0;
 
+#if SELFTEST_ENABLE
+static volatile uint32_t g_isrBusy = 0;     // PIT0 counts from reload to ISR exit
+static uint32_t g_loadStartTick = 0;
+#endif
+
 void PIT_Init(void) {
     // 1. Enable Clock & Module
     SIM->SCGC6 |= SIM_SCGC6_PIT_MASK;
@@ -22,10 +30,8 @@ void PIT_Init(void) {
     PIT->CHANNEL[0].TCTRL = 0;
     PIT->CHANNEL[0].TFLG = PIT_TFLG_TIF_MASK;
 
-    // 3. Load Value for 1ms
-    uint32_t busClock = CLOCK_GetFreq(kCLOCK_BusClk);
-    if (busClock == 0) busClock = 24000000U; // Fallback
-    PIT->CHANNEL[0].LDVAL = (busClock / 1000U) - 1U;
+    // 3. Load Value for 1ms (bus clock from the board description)
+    PIT->CHANNEL[0].LDVAL = BOARD_PIT_LDVAL(BOARD_TICK_HZ);
 
     // 4. Enable Interrupts & Timer
     PIT->CHANNEL[0].TCTRL = PIT_TCTRL_TIE_MASK | PIT_TCTRL_TEN_MASK;
@@ -40,6 +46,12 @@ void PIT_IRQHandler(void) {
         
         Keypad_Tick(); // Critical: Scan Matrix every 1ms
         Outputs_Tick(); // Audio Feedback
+#if TAMPER_ENABLE
+        Tamper_SampleTick(); // Background ADC conversion start
+#endif
+#if SELFTEST_ENABLE
+        g_isrBusy += PIT->CHANNEL[0].LDVAL - PIT->CHANNEL[0].CVAL; // Entry latency + run time
+#endif
     }
 }
 
@@ -47,6 +59,34 @@ uint32_t GetTick(void) {
     return g_systemTick;
 }
 
+uint32_t GetMicros(void) {
+    uint32_t tick, cval;
+    do {
+        tick = g_systemTick;
+        cval = PIT->CHANNEL[0].CVAL;
+    } while (tick != g_systemTick);
+
+    uint32_t reload = PIT->CHANNEL[0].LDVAL + 1U;
+    // Counter just reloaded but the ISR has not run yet (IRQs masked)
+    if ((PIT->CHANNEL[0].TFLG & PIT_TFLG_TIF_MASK) && cval > reload / 2U) tick++;
+
+    return tick * 1000U + ((reload - 1U - cval) * 1000U) / reload;
+}
+
+#if SELFTEST_ENABLE
+uint16_t PIT_TakeIsrLoad(void) {
+    uint32_t primask = DisableGlobalIRQ();
+    uint32_t busy = g_isrBusy;
+    uint32_t ticks = g_systemTick - g_loadStartTick;
+    g_isrBusy = 0;
+    g_loadStartTick = g_systemTick;
+    EnableGlobalIRQ(primask);
+
+    uint32_t countsPerMille = ticks * ((PIT->CHANNEL[0].LDVAL + 1U) / 1000U);
+    return (countsPerMille == 0) ? 0 : (uint16_t)(busy / countsPerMille);
+}
+#endif
+
 uint8_t IsTimeout(uint32_t startTick, uint32_t durationMs) {
     return ((g_systemTick - startTick) >= durationMs);
 }
@@ -15,6 +15,12 @@ void PIT_Init(void);
 // Get System Time (ms)
 uint32_t GetTick(void);
 
+// Get System Time (us, PIT0 sub-tick resolution; wraps every ~71 min)
+uint32_t GetMicros(void);
+
+// Self-Test: PIT ISR load since the previous call, in 0.1% units
+uint16_t PIT_TakeIsrLoad(void);
+
 // Check if time elapsed (True if current - start >= duration)
 uint8_t IsTimeout(uint32_t startTick, uint32_t durationMs);
 
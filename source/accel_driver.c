@@ -0,0 +1,221 @@
+/*
+ * accel_driver.c
+ *
+ * [ACCELEROMETER DRIVER - MMA8451Q]
+ * The sensor does the watching: its transient (high-pass) engine triggers
+ * the FIFO, which keeps 16 samples of history and then fills up with the
+ * event itself. Only when the FIFO is full does INT1 fire, so the MCU stays
+ * in WFI and reads the whole event in one burst I2C read.
+ * A separate motion engine (X/Y vs gravity) flags slow tilting that never
+ * looks like a vibration. Assumes the board is mounted flat (Z vertical).
+ */
+
+#include "accel_driver.h"
+
+// ============================================================================
+// REGISTERS & CONSTANTS
+// ============================================================================
+#define MMA_ADDR            0x1DU
+#define MMA_WHO_AM_I_VAL    0x1AU
+
+#define REG_F_STATUS        0x00
+#define REG_OUT_X_MSB       0x01
+#define REG_F_SETUP         0x09
+#define REG_TRIG_CFG        0x0A
+#define REG_INT_SOURCE      0x0C
+#define REG_WHO_AM_I        0x0D
+#define REG_XYZ_DATA_CFG    0x0E
+#define REG_FF_MT_CFG       0x15
+#define REG_FF_MT_SRC       0x16
+#define REG_FF_MT_THS       0x17
+#define REG_FF_MT_COUNT     0x18
+#define REG_TRANSIENT_CFG   0x1D
+#define REG_TRANSIENT_SRC   0x1E
+#define REG_TRANSIENT_THS   0x1F
+#define REG_TRANSIENT_COUNT 0x20
+#define REG_CTRL_REG1       0x2A
+#define REG_CTRL_REG2       0x2B
+#define REG_CTRL_REG4       0x2D
+#define REG_CTRL_REG5       0x2E
+
+#define F_SETUP_TRIGGER     0xC0U   // F_MODE = 11 (trigger)
+#define F_PRE_TRIGGER       16U     // Samples kept before the trigger
+#define F_CNT_MASK          0x3FU
+#define SRC_FIFO            0x40U
+#define SRC_FF_MT           0x04U
+#define INT_FIFO_FF_MT      (SRC_FIFO | SRC_FF_MT)
+
+#define CTRL1_50HZ_FREAD    0x22U   // DR = 50Hz, F_READ (8-bit samples)
+
+// Thresholds (0.063 g/count on the engines, 1/64 g/count on samples)
+#define TRANSIENT_THS_CNT   6U      // ~0.38 g change starts a capture
+#define MOTION_THS_CNT      8U      // ~0.5 g on X/Y = ~30 deg tilt
+#define MOTION_DEBOUNCE     10U     // 200ms @ 50Hz
+#define TILT_SHIFT_COUNTS   10      // ~0.16 g mean shift before vs after
+#define HIT_COUNTS          24      // ~0.38 g deviation from rest
+#define PRY_MIN_BURSTS      3       // Separate jolts within one capture
+#define PRY_MIN_HITS        8       // Or sustained force
+
+static int Abs(int v) { return v < 0 ? -v : v; }
+
+#if ACCEL_ENABLE
+
+#include "i2c_driver.h"
+#include "log_mgr.h"
+#include "fsl_port.h"
+#include "board_pins.h"
+#include "fsl_gpio.h"
+#include "fsl_clock.h"
+#include "MKL25Z4.h"
+
+static volatile bool g_accelIrq = false;
+static AccelClass_t g_lastClass = ACCEL_NONE;
+static bool g_present = false;
+
+// ============================================================================
+// INTERNAL HELPERS
+// ============================================================================
+/* Trigger mode freezes after the FIFO fills; cycle F_MODE to re-arm */
+static void Rearm_Fifo(void) {
+    I2C_WriteReg(MMA_ADDR, REG_F_SETUP, 0x00);
+    I2C_WriteReg(MMA_ADDR, REG_F_SETUP, F_SETUP_TRIGGER | F_PRE_TRIGGER);
+}
+
+static void Drain_Fifo(void) {
+    static int8_t samples[ACCEL_FIFO_SAMPLES * 3];
+    uint8_t status = 0;
+
+    if (!I2C_ReadRegs(MMA_ADDR, REG_F_STATUS, &status, 1)) return;
+    uint8_t count = status & F_CNT_MASK;
+    if (count > ACCEL_FIFO_SAMPLES) count = ACCEL_FIFO_SAMPLES;
+
+    // One burst: with F_READ, reads from OUT_X_MSB stream X,Y,Z of each FIFO entry
+    if (count && I2C_ReadRegs(MMA_ADDR, REG_OUT_X_MSB, (uint8_t*)samples, (uint16_t)count * 3U)) {
+        AccelClass_t cls = Accel_Classify(samples, count);
+        if (cls > g_lastClass) g_lastClass = cls; // Keep the most severe until read
+    }
+
+    uint8_t dummy;
+    I2C_ReadRegs(MMA_ADDR, REG_TRANSIENT_SRC, &dummy, 1); // Clear latch
+    Rearm_Fifo();
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+bool Accel_Init(void) {
+    I2C_Init();
+
+    uint8_t id = 0;
+    if (!I2C_ReadRegs(MMA_ADDR, REG_WHO_AM_I, &id, 1) || id != MMA_WHO_AM_I_VAL) {
+        LOG(SENSOR, ERROR, "MMA8451Q not found (ID 0x%02X)\r\n", id);
+        return false;
+    }
+
+    // Registers are only writable in Standby
+    I2C_WriteReg(MMA_ADDR, REG_CTRL_REG1, 0x00);
+    I2C_WriteReg(MMA_ADDR, REG_XYZ_DATA_CFG, 0x00);              // +/-2g
+    I2C_WriteReg(MMA_ADDR, REG_CTRL_REG2, 0x03);                 // Low-power oversampling
+    I2C_WriteReg(MMA_ADDR, REG_F_SETUP, F_SETUP_TRIGGER | F_PRE_TRIGGER);
+    I2C_WriteReg(MMA_ADDR, REG_TRIG_CFG, 0x20);                  // Trig_TRANS
+
+    // Transient: high-pass filtered, any axis, latched
+    I2C_WriteReg(MMA_ADDR, REG_TRANSIENT_CFG, 0x1E);
+    I2C_WriteReg(MMA_ADDR, REG_TRANSIENT_THS, TRANSIENT_THS_CNT);
+    I2C_WriteReg(MMA_ADDR, REG_TRANSIENT_COUNT, 1);
+
+    // Motion: latched, OR of X/Y above threshold, debounce counter cleared on drop
+    I2C_WriteReg(MMA_ADDR, REG_FF_MT_CFG, 0xD8);
+    I2C_WriteReg(MMA_ADDR, REG_FF_MT_THS, 0x80 | MOTION_THS_CNT);
+    I2C_WriteReg(MMA_ADDR, REG_FF_MT_COUNT, MOTION_DEBOUNCE);
+
+    // FIFO full + motion -> INT1 (active low, push-pull default)
+    I2C_WriteReg(MMA_ADDR, REG_CTRL_REG4, INT_FIFO_FF_MT);
+    I2C_WriteReg(MMA_ADDR, REG_CTRL_REG5, INT_FIFO_FF_MT);
+    I2C_WriteReg(MMA_ADDR, REG_CTRL_REG1, CTRL1_50HZ_FREAD | 0x01); // Active
+
+    // MCU side: INT1 pin (pulled-up input, BoardPins_Init) on falling edge (PORTA IRQ is enabled by PIR_Init)
+    PORT_SetPinInterruptConfig(BOARD_PORT(ACCEL_INT), BOARD_PIN(ACCEL_INT), kPORT_InterruptFallingEdge);
+
+    g_present = true;
+    LOG(SENSOR, INFO, "MMA8451Q Ready (50Hz, FIFO trigger).\r\n");
+    return true;
+}
+
+void Accel_Tick(void) {
+    if (!g_present) return;
+    // Level check too: an edge lost while INT1 was already low would stall us
+    if (!g_accelIrq && (BOARD_GPIO(ACCEL_INT)->PDIR & BOARD_MASK(ACCEL_INT)) != 0U) return;
+    g_accelIrq = false;
+
+    uint8_t src = 0;
+    if (!I2C_ReadRegs(MMA_ADDR, REG_INT_SOURCE, &src, 1)) return;
+
+    if (src & SRC_FF_MT) {
+        uint8_t dummy;
+        I2C_ReadRegs(MMA_ADDR, REG_FF_MT_SRC, &dummy, 1); // Clear latch
+        g_lastClass = ACCEL_TAMPER_MOVED;
+    }
+    if (src & SRC_FIFO) {
+        Drain_Fifo();
+    }
+}
+
+AccelClass_t Accel_CheckEvent(void) {
+    AccelClass_t cls = g_lastClass;
+    g_lastClass = ACCEL_NONE; // Clear on read
+    return cls;
+}
+
+void Accel_PortIrq(void) {
+    if (PORT_GetPinsInterruptFlags(BOARD_PORT(ACCEL_INT)) & BOARD_MASK(ACCEL_INT)) {
+        PORT_ClearPinsInterruptFlags(BOARD_PORT(ACCEL_INT), BOARD_MASK(ACCEL_INT));
+        g_accelIrq = true;
+    }
+}
+
+#endif // ACCEL_ENABLE
+
+// ============================================================================
+// CLASSIFIER (Hardware-independent)
+// ============================================================================
+AccelClass_t Accel_Classify(const int8_t* xyz, uint8_t samples) {
+    if (samples < 4) return ACCEL_NONE;
+
+    uint8_t pre = samples / 2;          // Rest position before the trigger
+    uint8_t post = samples / 4;         // Settled tail after the event
+    int rest[3] = {0}, tail[3] = {0};
+
+    for (uint8_t i = 0; i < pre; i++) {
+        for (uint8_t a = 0; a < 3; a++) rest[a] += xyz[i * 3 + a];
+    }
+    for (uint8_t i = samples - post; i < samples; i++) {
+        for (uint8_t a = 0; a < 3; a++) tail[a] += xyz[i * 3 + a];
+    }
+
+    // 1. Orientation shift: the enclosure did not come back to rest
+    int shift = 0;
+    for (uint8_t a = 0; a < 3; a++) {
+        rest[a] /= pre;
+        shift += Abs(tail[a] / post - rest[a]);
+    }
+    if (shift > TILT_SHIFT_COUNTS) return ACCEL_TAMPER_MOVED;
+
+    // 2. Jolt pattern: one slam = one burst; prying = repeated or sustained force
+    int hits = 0, bursts = 0;
+    bool inBurst = false;
+    for (uint8_t i = 0; i < samples; i++) {
+        bool hit = false;
+        for (uint8_t a = 0; a < 3; a++) {
+            if (Abs(xyz[i * 3 + a] - rest[a]) > HIT_COUNTS) hit = true;
+        }
+        if (hit) {
+            hits++;
+            if (!inBurst) bursts++;
+        }
+        inBurst = hit;
+    }
+
+    if (bursts >= PRY_MIN_BURSTS || hits >= PRY_MIN_HITS) return ACCEL_TAMPER_PRY;
+    return ACCEL_AMBIENT;
+}
@@ -0,0 +1,44 @@
+/*
+ * accel_driver.h
+ *
+ * Driver for the onboard MMA8451Q Accelerometer (Enclosure Tamper).
+ * Optional: build with ACCEL_ENABLE=1.
+ */
+
+#ifndef ACCEL_DRIVER_H
+#define ACCEL_DRIVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef ACCEL_ENABLE
+#define ACCEL_ENABLE 0
+#endif
+
+#define ACCEL_FIFO_SAMPLES 32   // Hardware FIFO depth (X,Y,Z per sample)
+
+typedef enum {
+    ACCEL_NONE = 0,
+    ACCEL_AMBIENT,          // Vibration burst (door slam, traffic): log only
+    ACCEL_TAMPER_PRY,       // Repeated strong jolts (enclosure being forced)
+    ACCEL_TAMPER_MOVED,     // Orientation changed (enclosure tilted/removed)
+} AccelClass_t;
+
+// Initialize I2C0, configure transient-triggered FIFO + motion detection (INT1 = PTA14)
+// Returns false if the sensor does not answer WHO_AM_I.
+bool Accel_Init(void);
+
+// Main loop: drains the FIFO after an interrupt and classifies the burst
+void Accel_Tick(void);
+
+// Returns (and clears) the last classification
+AccelClass_t Accel_CheckEvent(void);
+
+// Hardware-independent classifier: 'xyz' holds 'samples' triplets in 8-bit
+// FIFO format (1/64 g). First half = pre-trigger history.
+AccelClass_t Accel_Classify(const int8_t* xyz, uint8_t samples);
+
+// ISR Hook (Called from PORTA_IRQHandler)
+void Accel_PortIrq(void);
+
+#endif // ACCEL_DRIVER_H
@@ -0,0 +1,47 @@
+/*
+ * admin_auth.h
+ *
+ * Authenticated Admin Frames (per-device AES-128 key, CMAC tag, replay counter).
+ * Frame: <counter, 8 hex>:<tag, 16 hex>:<command>
+ * tag = first 8 bytes of CMAC(key, counter as 4 big-endian bytes || command).
+ * The counter must increase with every frame (persisted in the journal).
+ *
+ * Key change over Bluetooth (only once a key is installed):
+ *   ADMINKEY <32 hex>, the new key XOR AES(current key, counter || "ADMINKEY-WRAP")
+ * where counter is the frame's own counter (4 big-endian bytes), so every
+ * wrap uses a fresh pad and the frame tag authenticates the wrapped key.
+ * The first key is installed on the wired port (wired_port.h).
+ */
+
+#ifndef ADMIN_AUTH_H
+#define ADMIN_AUTH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "storage_mgr.h"
+
+#define ADMIN_TAG_LEN      8       // Truncated CMAC (64 bits, SP 800-38B minimum)
+#define ADMIN_FRAME_HDR    26      // "CCCCCCCC:TTTTTTTTTTTTTTTT:"
+
+// Load the key from the config and the last counter from the journal
+void AdminAuth_Init(void);
+
+// True once a non-zero key is installed (LOGIN sessions are then disabled)
+bool AdminAuth_IsProvisioned(void);
+
+// Verify a frame. Returns the command text inside it, or NULL if rejected.
+char* AdminAuth_Open(char* frame);
+
+// Exactly 32 hex digits -> key bytes
+bool AdminAuth_ParseKey(const char* hex, uint8_t key[ADMIN_KEY_LEN]);
+
+// Unwrap a key sent in the frame just accepted by AdminAuth_Open (false if none)
+bool AdminAuth_UnwrapKey(const uint8_t wrapped[ADMIN_KEY_LEN], uint8_t key[ADMIN_KEY_LEN]);
+
+// Install a new key (all zero = back to LOGIN sessions). Resets the counter.
+bool AdminAuth_SetKey(const uint8_t key[ADMIN_KEY_LEN]);
+
+// Measured AES-128 / CMAC cost on this build (CRYPTO)
+void AdminAuth_PrintBenchmark(void);
+
+#endif // ADMIN_AUTH_H
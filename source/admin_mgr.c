@@ -9,8 +9,18 @@
 #include "admin_mgr.h"
 #include "security_manager.h"
 #include "storage_mgr.h"
+#include "rfid_driver.h"
+#include "wall_clock.h"
+#include "policy_engine.h"
 #include "fsl_debug_console.h"
 #include "uart_driver.h"
+#include "log_mgr.h"
+#include "supervisor.h"
+#include "selftest.h"
+#include "audit_log.h"
+#include "admin_auth.h"
+#include "mem_pool.h"
+#include "timer_driver.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -24,17 +34,64 @@
 #define CMD_DELID    "DELID"
 #define CMD_ADMINPASS "ADMINPASS"
 #define CMD_LISTIDS   "LISTIDS"
+#define CMD_SITEKEY   "SITEKEY"
+#define CMD_HISTORY   "HISTORY"
+#define CMD_TXSTATS   "TXSTATS"
+#define CMD_TIME      "TIME"
+#define CMD_SCHEDCLR  "SCHEDCLR"
+#define CMD_SCHED     "SCHED"
+#define CMD_IDSCHED   "IDSCHED"
+#define CMD_POLICY    "POLICY"
+#define CMD_SUPSTATS  "SUPSTATS"
+#define CMD_SELFTEST  "SELFTEST"
+#define CMD_AUDIT     "AUDIT"
+#define CMD_ADMINKEY  "ADMINKEY"
+#define CMD_CRYPTO    "CRYPTO"
+#define CMD_POOLSTATS "POOLSTATS"
+#define CMD_LOGLEVEL  "LOGLEVEL"
 
-// Temporary Admin Session
+#define ADMIN_SESSION_MS  300000U  // LOGIN session idle timeout (no key provisioned)
+
+// Policy Upload Staging (bytecode arrives in chunks: RX line is 96 chars)
+static uint8_t g_policy_stage[POLICY_MAX_LEN];
+static uint16_t g_policy_len = 0;
+
+// Temporary Admin Session (only while frames are not authenticated)
 static bool g_admin_logged_in = false;
+static uint32_t g_session_last = 0;
+
+/* Removes spaces in place ("DE AD BE EF" -> "DEADBEEF"); the RX line is ours to edit */
+static char* Strip_Spaces(char* s) {
+    char* out = s;
+    for (char* in = s; *in != 0; in++) {
+        if (*in != ' ' && *in != '\n' && *in != '\r') *out++ = *in;
+    }
+    *out = 0;
+    return s;
+}
+
+/* Password, PIN or key in the arguments */
+static bool Cmd_HasSecret(const char* cmd) {
+    return strncmp(cmd, CMD_LOGIN, 5) == 0 || strncmp(cmd, CMD_ADMINKEY, 8) == 0 ||
+           strncmp(cmd, CMD_NEWPASS, 7) == 0 || strncmp(cmd, CMD_ADMINPASS, 9) == 0 ||
+           strncmp(cmd, CMD_SITEKEY, 7) == 0;
+}
 
 void Admin_ProcessCommand(char* cmd) {
     if (cmd == NULL || strlen(cmd) == 0) return;
 
-    UART_Printf("\r\n[ADMIN_RX] Cmd: %s\r\n", cmd);
+    // 0. Key provisioned: every line is a CMAC frame; no LOGIN, no session
+    bool framed = AdminAuth_IsProvisioned();
+    if (framed) {
+        cmd = AdminAuth_Open(cmd);
+        if (cmd == NULL) return;
+    }
+
+    // Commands carrying secrets are never echoed to the log (or HISTORY)
+    if (!Cmd_HasSecret(cmd)) LOG(ADMIN, INFO, "Cmd: %s\r\n", cmd);
 
     // 1. Process LOGIN
-    if (strncmp(cmd, CMD_LOGIN, 5) == 0) {
+    if (!framed && strncmp(cmd, CMD_LOGIN, 5) == 0) {
         // Format: LOGIN <PASS>
         char* token = strtok(cmd, " ");
         token = strtok(NULL, " "); 
@@ -43,20 +100,28 @@ void Admin_ProcessCommand(char* cmd) {
             // Dynamic Password Check
             if (Security_CheckAdminPassword(token)) {
                 g_admin_logged_in = true;
-                UART_Printf("[ADMIN ] LOGIN SUCCESS. Session Active.\r\n");
+                g_session_last = GetTick();
+                LOG(ADMIN, INFO, "LOGIN SUCCESS. Session Active.\r\n");
             } else {
-                UART_Printf("[ADMIN ] LOGIN FAILED. Invalid Credentials.\r\n");
+                LOG(ADMIN, WARN, "LOGIN FAILED. Invalid Credentials.\r\n");
             }
         } else {
-             UART_Printf("[ADMIN ] ERR: Missing Password.\r\n");
+             LOG(ADMIN, WARN, "ERR: Missing Password.\r\n");
         }
         return;
     }
 
-    // 2. Security Check (Session Required)
-    if (!g_admin_logged_in) {
-        UART_Printf("[ADMIN ] ACCESS DENIED. Please LOGIN first.\r\n");
-        return;
+    // 2. Security Check (Session Required, expires when idle)
+    if (!framed) {
+        if (g_admin_logged_in && IsTimeout(g_session_last, ADMIN_SESSION_MS)) {
+            g_admin_logged_in = false;
+            LOG(ADMIN, INFO, "Session expired.\r\n");
+        }
+        if (!g_admin_logged_in) {
+            LOG(ADMIN, WARN, "ACCESS DENIED. Please LOGIN first.\r\n");
+            return;
+        }
+        g_session_last = GetTick();
     }
 
     // 3. Command Dispatch
@@ -66,54 +131,38 @@ void Admin_ProcessCommand(char* cmd) {
         
         if (token != NULL) {
             Security_SetPassword(token);
-            UART_Printf("[ADMIN ] User PIN updated remotely.\r\n");
+            LOG(ADMIN, INFO, "User PIN updated remotely.\r\n");
         } else {
-            UART_Printf("[ADMIN ] ERR: Missing PIN.\r\n");
+            LOG(ADMIN, WARN, "ERR: Missing PIN.\r\n");
         }
     }
     else if (strncmp(cmd, CMD_UNLOCK, 6) == 0) {
-        UART_Printf("[ADMIN ] Feature not implemented. Use RFID/Keypad.\r\n");
+        LOG(ADMIN, INFO, "Feature not implemented. Use RFID/Keypad.\r\n");
     }
     else if (strncmp(cmd, CMD_STATUS, 6) == 0) {
-        UART_Printf("[ADMIN ] System Active. Logged In.\r\n");
+        LOG(ADMIN, INFO, "System Active. Logged In.\r\n");
     }
     // 6. ADDID <HEX>
     else if (strncmp(cmd, CMD_ADDID, 5) == 0) {
         char* token = strtok(cmd, " ");
         token = strtok(NULL, ""); // Get Remainder
         if (token != NULL) {
-             // Clean Spaces
-             char cleanHex[32];
-             int idx = 0;
-             for(int i=0; token[i] != 0 && idx < 16; i++) {
-                 char c = token[i];
-                 if(c != ' ' && c != '\n' && c != '\r') cleanHex[idx++] = c;
-             }
-             cleanHex[idx] = 0;
-            uint32_t uid = (uint32_t)strtoul(cleanHex, NULL, 16);
+            uint32_t uid = (uint32_t)strtoul(Strip_Spaces(token), NULL, 16);
             if (uid != 0) {
-                if (Storage_AddRFID(uid)) UART_Printf("[ADMIN ] ID Added: %X\r\n", uid);
-                else UART_Printf("[ADMIN ] ERR: Storage Full or Save Failed.\r\n");
-            } else UART_Printf("[ADMIN ] ERR: Invalid Hex ID.\r\n");
-        } else UART_Printf("[ADMIN ] ERR: Missing ID.\r\n");
+                if (Storage_AddRFID(uid)) LOG(ADMIN, INFO, "ID Added: %X\r\n", uid);
+                else LOG(ADMIN, ERROR, "ERR: Storage Full or Save Failed.\r\n");
+            } else LOG(ADMIN, WARN, "ERR: Invalid Hex ID.\r\n");
+        } else LOG(ADMIN, WARN, "ERR: Missing ID.\r\n");
     }
     // 7. DELID <HEX>
     else if (strncmp(cmd, CMD_DELID, 5) == 0) {
         char* token = strtok(cmd, " ");
         token = strtok(NULL, ""); // Get Remainder
         if (token != NULL) {
-             // Clean Spaces
-             char cleanHex[32];
-             int idx = 0;
-             for(int i=0; token[i] != 0 && idx < 16; i++) {
-                 char c = token[i];
-                 if(c != ' ' && c != '\n' && c != '\r') cleanHex[idx++] = c;
-             }
-             cleanHex[idx] = 0;
-            uint32_t uid = (uint32_t)strtoul(cleanHex, NULL, 16);
-            if (Storage_RemoveRFID(uid)) UART_Printf("[ADMIN ] ID Removed: %X\r\n", uid);
-            else UART_Printf("[ADMIN ] ERR: ID Not Found.\r\n");
-        } else UART_Printf("[ADMIN ] ERR: Missing ID.\r\n");
+            uint32_t uid = (uint32_t)strtoul(Strip_Spaces(token), NULL, 16);
+            if (Storage_RemoveRFID(uid)) LOG(ADMIN, INFO, "ID Removed: %X\r\n", uid);
+            else LOG(ADMIN, WARN, "ERR: ID Not Found.\r\n");
+        } else LOG(ADMIN, WARN, "ERR: Missing ID.\r\n");
     }
     // 8. ADMINPASS <PASS>
     else if (strncmp(cmd, CMD_ADMINPASS, 9) == 0) {
@@ -123,7 +172,7 @@ void Admin_ProcessCommand(char* cmd) {
         if (token != NULL) {
             Security_SetAdminPassword(token);
         } else {
-            UART_Printf("[ADMIN ] ERR: Missing new password.\r\n");
+            LOG(ADMIN, WARN, "ERR: Missing new password.\r\n");
         }
     }
     // 9. LISTIDS
@@ -131,7 +180,177 @@ void Admin_ProcessCommand(char* cmd) {
         Storage_ListRFIDs();
     }
     
+    // 10. SITEKEY <SITE> <12 HEX KEY A>
+    else if (strncmp(cmd, CMD_SITEKEY, 7) == 0) {
+        char* token = strtok(cmd, " ");
+        char* site = strtok(NULL, " ");
+        token = strtok(NULL, " ");
+        if (site != NULL && token != NULL && strlen(token) == 12) {
+            uint8_t key[6];
+            for (int i = 0; i < 6; i++) {
+                char byteHex[3] = { token[2 * i], token[2 * i + 1], 0 };
+                key[i] = (uint8_t)strtoul(byteHex, NULL, 16);
+            }
+            uint16_t siteCode = (uint16_t)strtoul(site, NULL, 10);
+            if (RFID_SetSiteKey(siteCode, key)) LOG(ADMIN, INFO, "Key cached for site %u.\r\n", siteCode);
+            else LOG(ADMIN, WARN, "ERR: Key cache full.\r\n");
+        } else LOG(ADMIN, WARN, "ERR: Usage SITEKEY <site> <12 hex>.\r\n");
+    }
+    // 11. HISTORY
+    else if (strncmp(cmd, CMD_HISTORY, 7) == 0) {
+        UART_PrintHistory();
+    }
+    // 12. TXSTATS
+    else if (strncmp(cmd, CMD_TXSTATS, 7) == 0) {
+        UART_PrintTxStats();
+    }
+    // 12b. SUPSTATS
+    else if (strncmp(cmd, CMD_SUPSTATS, 8) == 0) {
+        Supervisor_PrintStats();
+    }
+    // 12g. POOLSTATS (block high-water marks, to size POOL_COUNT_*)
+    else if (strncmp(cmd, CMD_POOLSTATS, 9) == 0) {
+        Pool_PrintStats();
+    }
+    // 12h. LOGLEVEL [<category|*> <OFF|ERROR|WARN|INFO|DEBUG>]
+    else if (strncmp(cmd, CMD_LOGLEVEL, 8) == 0) {
+        char* token = strtok(cmd, " ");
+        char* cat = strtok(NULL, " ");
+        token = strtok(NULL, " ");
+        int level = (token != NULL) ? Log_FindLevel(token) : -1;
+
+        if (cat == NULL) {
+            Log_PrintLevels();
+        } else if (level >= 0 && strcmp(cat, "*") == 0) {
+            for (int i = 0; i < LOG_CATEGORIES; i++) Log_SetLevel((LogCategory_t)i, (uint8_t)level);
+            Log_PrintLevels();
+        } else if (level >= 0 && Log_FindCategory(cat) >= 0) {
+            Log_SetLevel((LogCategory_t)Log_FindCategory(cat), (uint8_t)level);
+            Log_PrintLevels();
+        } else UART_Printf("[ADMIN ] ERR: Usage LOGLEVEL [<category|*> <OFF|ERROR|WARN|INFO|DEBUG>].\r\n");
+    }
+#if SELFTEST_ENABLE
+    // 12c. SELFTEST (disarmed system only; runs from the main loop, ~15s, sounds the siren briefly per phase)
+    else if (strncmp(cmd, CMD_SELFTEST, 8) == 0) {
+        if (Selftest_Start()) LOG(ADMIN, INFO, "Self-test started.\r\n");
+        else LOG(ADMIN, WARN, "ERR: Disarm first (valid PIN/card), then SELFTEST.\r\n");
+    }
+#endif
+    // 12d. ADMINKEY <32 hex, wrapped under the current key> (unwraps to all zero = back to LOGIN)
+    // Never in plaintext over Bluetooth: the first key goes in on the wired port
+    else if (strncmp(cmd, CMD_ADMINKEY, 8) == 0) {
+        char* token = strtok(cmd, " ");
+        token = strtok(NULL, " ");
+        uint8_t wrapped[ADMIN_KEY_LEN];
+        uint8_t key[ADMIN_KEY_LEN];
+
+        if (!framed) LOG(ADMIN, WARN, "ERR: No admin key yet. Install it on the wired (USB) port.\r\n");
+        else if (token == NULL || !AdminAuth_ParseKey(token, wrapped)) LOG(ADMIN, WARN, "ERR: Usage ADMINKEY <32 hex wrapped key>.\r\n");
+        else if (AdminAuth_UnwrapKey(wrapped, key) && AdminAuth_SetKey(key)) {
+            g_admin_logged_in = false;
+            LOG(ADMIN, INFO, "Admin Key Saved. %s\r\n", AdminAuth_IsProvisioned() ? "Counter reset." : "LOGIN sessions restored.");
+        }
+        else LOG(ADMIN, ERROR, "ERR: Flash Save Failed.\r\n");
+        memset(key, 0, sizeof(key));
+    }
+    // 12e. CRYPTO (AES / CMAC cost on this build)
+    else if (strncmp(cmd, CMD_CRYPTO, 6) == 0) {
+        AdminAuth_PrintBenchmark();
+    }
+    // 12f. AUDIT | AUDIT QUERY <uid|*> [<from> [<to>]]
+    else if (strncmp(cmd, CMD_AUDIT, 5) == 0) {
+        char* token = strtok(cmd, " ");
+        char* sub = strtok(NULL, " ");
+        char* uid = strtok(NULL, " ");
+        char* from = strtok(NULL, " ");
+        token = strtok(NULL, " ");
+
+        if (sub == NULL) {
+            Audit_PrintSummary();
+        } else if (strcmp(sub, "QUERY") == 0 && uid != NULL) {
+            Audit_Query((strcmp(uid, "*") == 0) ? AUDIT_ANY_UID : (uint32_t)strtoul(uid, NULL, 16),
+                        (from != NULL) ? (uint32_t)strtoul(from, NULL, 10) : 0U,
+                        (token != NULL) ? (uint32_t)strtoul(token, NULL, 10) : 0xFFFFFFFFU);
+        } else LOG(ADMIN, WARN, "ERR: Usage AUDIT [QUERY <uid|*> [<from> [<to>]]].\r\n");
+    }
+    // 13. TIME [<unix seconds>]
+    else if (strncmp(cmd, CMD_TIME, 4) == 0) {
+        char* token = strtok(cmd, " ");
+        token = strtok(NULL, " ");
+        if (token != NULL) {
+            WallClock_SetTime((uint32_t)strtoul(token, NULL, 10));
+            LOG(ADMIN, INFO, "Clock Set.\r\n");
+        }
+        if (WallClock_IsSet()) LOG(ADMIN, INFO, "Time: %u (Hour of Week %d)\r\n", WallClock_GetTime(), WallClock_GetWeekSlot());
+        else LOG(ADMIN, INFO, "Clock not set. Use TIME <unix>.\r\n");
+    }
+    // 14. SCHEDCLR <GRP>  (before SCHED: shared prefix)
+    else if (strncmp(cmd, CMD_SCHEDCLR, 8) == 0) {
+        char* token = strtok(cmd, " ");
+        token = strtok(NULL, " ");
+        if (token != NULL && Storage_ClearSchedule((uint8_t)atoi(token))) LOG(ADMIN, INFO, "Schedule Cleared.\r\n");
+        else LOG(ADMIN, WARN, "ERR: Usage SCHEDCLR <1-%d>.\r\n", MAX_SCHEDULES - 1);
+    }
+    // 15. SCHED <GRP> <DAY 0-6> <START H> <END H>
+    else if (strncmp(cmd, CMD_SCHED, 5) == 0) {
+        char* token = strtok(cmd, " ");
+        char* grp = strtok(NULL, " ");
+        char* day = strtok(NULL, " ");
+        char* from = strtok(NULL, " ");
+        token = strtok(NULL, " ");
+        if (grp != NULL && day != NULL && from != NULL && token != NULL &&
+            Storage_SetScheduleHours((uint8_t)atoi(grp), (uint8_t)atoi(day), (uint8_t)atoi(from), (uint8_t)atoi(token))) {
+            LOG(ADMIN, INFO, "Schedule Updated.\r\n");
+        } else LOG(ADMIN, WARN, "ERR: Usage SCHED <grp> <day 0-6> <from h> <to h>.\r\n");
+    }
+    // 16. IDSCHED <HEX> <GRP>
+    else if (strncmp(cmd, CMD_IDSCHED, 7) == 0) {
+        char* token = strtok(cmd, " ");
+        char* hex = strtok(NULL, " ");
+        token = strtok(NULL, " ");
+        if (hex != NULL && token != NULL &&
+            Storage_AssignSchedule((uint32_t)strtoul(hex, NULL, 16), (uint8_t)atoi(token))) {
+            LOG(ADMIN, INFO, "Schedule Assigned.\r\n");
+        } else LOG(ADMIN, WARN, "ERR: Unknown ID or Group.\r\n");
+    }
+    // 17. POLICY CLR | ADD <hex> | COMMIT | OFF
+    else if (strncmp(cmd, CMD_POLICY, 6) == 0) {
+        char* token = strtok(cmd, " ");
+        char* sub = strtok(NULL, " ");
+        token = strtok(NULL, " ");
+
+        if (sub == NULL) {
+            uint16_t len = 0;
+            if (Storage_GetPolicy(&len) != NULL) LOG(ADMIN, INFO, "Policy Active (%d bytes).\r\n", len);
+            else LOG(ADMIN, INFO, "No Policy. Built-in rules.\r\n");
+        }
+        else if (strcmp(sub, "CLR") == 0) {
+            g_policy_len = 0;
+            LOG(ADMIN, INFO, "Policy Stage Cleared.\r\n");
+        }
+        else if (strcmp(sub, "ADD") == 0 && token != NULL) {
+            size_t n = strlen(token);
+            if ((n & 1U) || g_policy_len + n / 2 > POLICY_MAX_LEN) {
+                LOG(ADMIN, WARN, "ERR: Bad hex or policy too long.\r\n");
+            } else {
+                for (size_t i = 0; i < n; i += 2) {
+                    char byteHex[3] = { token[i], token[i + 1], 0 };
+                    g_policy_stage[g_policy_len++] = (uint8_t)strtoul(byteHex, NULL, 16);
+                }
+                LOG(ADMIN, INFO, "Policy Staged: %d bytes.\r\n", g_policy_len);
+            }
+        }
+        else if (strcmp(sub, "COMMIT") == 0) {
+            if (Storage_SavePolicy(g_policy_stage, g_policy_len)) LOG(ADMIN, INFO, "Policy Installed.\r\n");
+            else LOG(ADMIN, WARN, "ERR: Policy rejected by verifier.\r\n");
+        }
+        else if (strcmp(sub, "OFF") == 0) {
+            if (Storage_SavePolicy(NULL, 0)) LOG(ADMIN, INFO, "Policy Removed.\r\n");
+        }
+        else LOG(ADMIN, WARN, "ERR: Usage POLICY [CLR|ADD <hex>|COMMIT|OFF].\r\n");
+    }
+    
     else {
-        UART_Printf("[ADMIN ] Unknown Command.\r\n");
+        LOG(ADMIN, INFO, "Unknown Command.\r\n");
     }
 }
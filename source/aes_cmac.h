@@ -0,0 +1,48 @@
+/*
+ * aes_cmac.h
+ *
+ * AES-128 (encrypt direction only) and CMAC (NIST SP 800-38B, RFC 4493).
+ * Word-oriented rounds for the Cortex-M0+ (no unaligned loads, RORS for
+ * the table rotations); the key schedule is expanded once per key.
+ */
+
+#ifndef AES_CMAC_H
+#define AES_CMAC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Table / Speed Trade-Off
+// AES_TABLE_SBOX:   256 B S-box, MixColumns computed on packed words (smallest)
+// AES_TABLE_TTABLE: + 1 KB T-table (one table, rotated per row; ~2x faster rounds)
+#define AES_TABLE_SBOX    0
+#define AES_TABLE_TTABLE  1
+#ifndef AES_TABLE_MODE
+#define AES_TABLE_MODE    AES_TABLE_TTABLE
+#endif
+
+#define AES_BLOCK_SIZE    16
+#define AES_ROUNDS        10
+
+// Expanded key (176 B, little-endian column words)
+typedef struct {
+    uint32_t rk[4 * (AES_ROUNDS + 1)];
+} AesKey_t;
+
+// CMAC context: expanded key + subkeys K1/K2 (precomputed by Cmac_Init)
+typedef struct {
+    AesKey_t aes;
+    uint8_t k1[AES_BLOCK_SIZE];
+    uint8_t k2[AES_BLOCK_SIZE];
+} CmacKey_t;
+
+void AES_KeyExpand(AesKey_t* ks, const uint8_t key[AES_BLOCK_SIZE]);
+void AES_Encrypt(const AesKey_t* ks, const uint8_t in[AES_BLOCK_SIZE], uint8_t out[AES_BLOCK_SIZE]);
+
+void Cmac_Init(CmacKey_t* ck, const uint8_t key[AES_BLOCK_SIZE]);
+void Cmac_Compute(const CmacKey_t* ck, const uint8_t* msg, uint32_t len, uint8_t mac[AES_BLOCK_SIZE]);
+
+// Constant-time check of a (possibly truncated, >= 8 bytes) tag
+bool Cmac_Verify(const CmacKey_t* ck, const uint8_t* msg, uint32_t len, const uint8_t* tag, uint8_t tagLen);
+
+#endif // AES_CMAC_H
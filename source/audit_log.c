@@ -0,0 +1,286 @@
+/*
+ * audit_log.c
+ *
+ * [AUDIT LOG]
+ * Append-only ring of 12-byte access records over AUDIT_SECTORS Flash
+ * sectors; the oldest sector is pre-erased from the main loop (Audit_Idle)
+ * before the ring wraps onto it, so Audit_Record normally only programs.
+ * Each sector starts with a sequence number, so the write position
+ * survives resets.
+ * A RAM index keeps, per sector, the wall-clock time range and a 256-bit
+ * UID bloom: a query reads only the sectors that may hold a match.
+ */
+
+#include "audit_log.h"
+#include "storage_mgr.h"
+#include "uart_driver.h"
+#include "log_mgr.h"
+#include "timer_driver.h"
+#include "wall_clock.h"
+#include "power_mgr.h"
+#include <string.h>
+#include <stddef.h>
+
+// ============================================================================
+// LAYOUT
+// ============================================================================
+#define AUDIT_SECTOR_SIZE   1024U
+#define AUDIT_SEQ_ERASED    0xFFFFFFFFU
+#define AUDIT_FREE          0xFFU       // Event byte of an unprogrammed slot
+#define AUDIT_FLAG_UPTIME   0x01U       // Stamp is uptime seconds (clock not set)
+
+#define AUDIT_BLOOM_BITS    256U
+#define AUDIT_BLOOM_WORDS   (AUDIT_BLOOM_BITS / 32U)
+#define AUDIT_BLOOM_HASHES  3U
+#define AUDIT_MAX_HITS      16          // Lines printed per query
+#define AUDIT_PREERASE_AT   (AUDIT_RECORDS_PER_SECTOR * 3U / 4U) // Head fill that triggers the pre-erase
+
+// Event byte is in the last longword: a non-free event means a complete record
+typedef struct {
+    uint32_t stamp;                 // Unix seconds, or uptime seconds (AUDIT_FLAG_UPTIME)
+    uint32_t uid;                   // AUDIT_NO_UID for PIN / alarm events
+    uint8_t door;                   // Partition index
+    uint8_t flags;
+    uint8_t reserved;
+    uint8_t event;                  // AuditEvent_t (0xFF = free slot)
+} AuditRecord_t;
+
+#define AUDIT_RECORDS_PER_SECTOR ((AUDIT_SECTOR_SIZE - sizeof(uint32_t)) / sizeof(AuditRecord_t))
+
+typedef struct {
+    uint32_t seq;                   // Ring order (AUDIT_SEQ_ERASED = unused sector)
+    AuditRecord_t rec[AUDIT_RECORDS_PER_SECTOR];
+} AuditSector_t;
+
+typedef char Audit_Sector_Check[(sizeof(AuditSector_t) <= AUDIT_SECTOR_SIZE) ? 1 : -1];
+
+typedef struct {
+    uint32_t seq;                   // 0 = unused sector
+    uint32_t minStamp;              // Wall-clock records only
+    uint32_t maxStamp;
+    uint16_t used;                  // Slots consumed (incl. cut records)
+    uint16_t records;               // Complete records
+    uint32_t bloom[AUDIT_BLOOM_WORDS];
+} AuditIndex_t;
+
+static AuditIndex_t g_index[AUDIT_SECTORS];
+static int8_t g_head = -1;          // Sector being written (-1 = empty ring)
+static uint32_t g_nextSeq = 1;
+static bool g_nextBlank = false;    // Sector after the head is erased and ready
+
+// ============================================================================
+// INTERNAL HELPERS
+// ============================================================================
+static const AuditSector_t* Sector(int i) {
+    return (const AuditSector_t*)(AUDIT_BASE_ADDR + (uint32_t)i * AUDIT_SECTOR_SIZE);
+}
+
+/* Murmur3 finalizer (same mixing as the credential bloom filter) */
+static uint32_t Mix32(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85EBCA6BU;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35U;
+    h ^= h >> 16;
+    return h;
+}
+
+/* Double Hashing: bit_i = h1 + i*h2 (h2 odd) */
+static void Bloom_Indices(uint32_t uid, uint32_t bit[AUDIT_BLOOM_HASHES]) {
+    uint32_t h1 = Mix32(uid);
+    uint32_t h2 = Mix32(h1 ^ 0x9E3779B9U) | 1U;
+    for (uint32_t i = 0; i < AUDIT_BLOOM_HASHES; i++) {
+        bit[i] = (h1 + i * h2) & (AUDIT_BLOOM_BITS - 1U);
+    }
+}
+
+static void Bloom_Set(uint32_t* bloom, uint32_t uid) {
+    uint32_t bit[AUDIT_BLOOM_HASHES];
+    Bloom_Indices(uid, bit);
+    for (uint32_t i = 0; i < AUDIT_BLOOM_HASHES; i++) bloom[bit[i] >> 5] |= 1UL << (bit[i] & 31U);
+}
+
+/* False: the UID is certainly not in the sector */
+static bool Bloom_Test(const uint32_t* bloom, uint32_t uid) {
+    uint32_t bit[AUDIT_BLOOM_HASHES];
+    Bloom_Indices(uid, bit);
+    for (uint32_t i = 0; i < AUDIT_BLOOM_HASHES; i++) {
+        if (!(bloom[bit[i] >> 5] & (1UL << (bit[i] & 31U)))) return false;
+    }
+    return true;
+}
+
+static void Index_Reset(AuditIndex_t* idx, uint32_t seq) {
+    memset(idx, 0, sizeof(*idx));
+    idx->seq = seq;
+    idx->minStamp = 0xFFFFFFFFU;
+}
+
+static void Index_Add(AuditIndex_t* idx, const AuditRecord_t* rec) {
+    idx->records++;
+    Bloom_Set(idx->bloom, rec->uid);
+    if (rec->flags & AUDIT_FLAG_UPTIME) return;
+    if (rec->stamp < idx->minStamp) idx->minStamp = rec->stamp;
+    if (rec->stamp > idx->maxStamp) idx->maxStamp = rec->stamp;
+}
+
+static bool Slot_Blank(const AuditRecord_t* rec) {
+    const uint32_t* w = (const uint32_t*)rec;
+    return (w[0] == 0xFFFFFFFFU && w[1] == 0xFFFFFFFFU && w[2] == 0xFFFFFFFFU);
+}
+
+/* Erase a sector unless it is already blank; its events leave the index */
+static bool Erase_Sector(int i) {
+    const uint32_t* w = (const uint32_t*)Sector(i);
+    for (uint32_t n = 0; n < AUDIT_SECTOR_SIZE / 4U; n++) {
+        if (w[n] != 0xFFFFFFFFU) {
+            if (!Storage_FlashErase((uint32_t)Sector(i))) return false;
+            break;
+        }
+    }
+    memset(&g_index[i], 0, sizeof(g_index[i]));
+    return true;
+}
+
+/* Erase (fallback, normally done by Audit_Idle) and stamp a sector as the newest in the ring */
+static bool Open_Sector(int i) {
+    if (!g_nextBlank && !Erase_Sector(i)) return false;
+
+    uint32_t seq = g_nextSeq;
+    if (!Storage_FlashProgram((uint32_t)Sector(i), &seq, sizeof(seq))) return false;
+    g_nextSeq++;
+    g_nextBlank = false;
+    Index_Reset(&g_index[i], seq);
+    return true;
+}
+
+static const char* Event_Name(uint8_t event) {
+    static const char* const names[] = { "?       ", "CARD OK ", "CARD DEN", "PIN OK  ", "PIN BAD ", "ALARM   " };
+    return (event < sizeof(names) / sizeof(names[0])) ? names[event] : names[0];
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+void Audit_Init(void) {
+    uint32_t newest = 0;
+    uint32_t total = 0;
+    g_head = -1;
+    g_nextBlank = false;
+
+    for (int i = 0; i < AUDIT_SECTORS; i++) {
+        const AuditSector_t* s = Sector(i);
+        memset(&g_index[i], 0, sizeof(g_index[i]));
+        if (s->seq == AUDIT_SEQ_ERASED || s->seq == 0) continue;
+
+        Index_Reset(&g_index[i], s->seq);
+        AuditIndex_t* idx = &g_index[i];
+        // Whole sector: a slot left blank by a refused program is skipped, not the end
+        for (uint16_t n = 0; n < AUDIT_RECORDS_PER_SECTOR; n++) {
+            if (Slot_Blank(&s->rec[n])) continue;
+            if (s->rec[n].event != AUDIT_FREE) Index_Add(idx, &s->rec[n]);
+            idx->used = n + 1U;
+        }
+        total += idx->records;
+
+        if (s->seq > newest) {
+            newest = s->seq;
+            g_head = (int8_t)i;
+        }
+    }
+    g_nextSeq = newest + 1;
+
+    LOG(SYSTEM, INFO, "Audit log: %u records, index %u B\r\n", total, (unsigned)sizeof(g_index));
+}
+
+void Audit_Idle(void) {
+    if (g_head < 0 || g_nextBlank || g_index[g_head].used < AUDIT_PREERASE_AT) return;
+    g_nextBlank = Erase_Sector((g_head + 1) % AUDIT_SECTORS);
+}
+
+void Audit_Record(AuditEvent_t event, uint32_t uid, uint8_t door) {
+    // No program starts on a sagging rail, so no slot (or sector) is consumed
+    if (Power_IsFailing()) return;
+
+    if (g_head < 0 || g_index[g_head].used >= AUDIT_RECORDS_PER_SECTOR) {
+        // Ring full at the head: the next sector (oldest) is recycled
+        int next = (g_head < 0) ? 0 : (g_head + 1) % AUDIT_SECTORS;
+        if (!Open_Sector(next)) return;
+        g_head = (int8_t)next;
+    }
+
+    AuditRecord_t rec;
+    rec.stamp = WallClock_GetTime();
+    rec.flags = 0;
+    if (rec.stamp == 0) {
+        rec.stamp = GetTick() / 1000U;
+        rec.flags = AUDIT_FLAG_UPTIME;
+    }
+    rec.uid = uid;
+    rec.door = door;
+    rec.reserved = 0xFF;
+    rec.event = (uint8_t)event;
+
+    AuditIndex_t* idx = &g_index[g_head];
+    uint32_t addr = (uint32_t)&Sector(g_head)->rec[idx->used];
+    bool ok = Storage_FlashProgram(addr, (const uint32_t*)&rec, sizeof(rec));
+    idx->used++; // Slot consumed even on failure (may be half programmed)
+    if (ok) Index_Add(idx, &rec);
+}
+
+void Audit_Query(uint32_t uid, uint32_t from, uint32_t to) {
+    const AuditRecord_t* hits[AUDIT_MAX_HITS];
+    uint32_t matches = 0;
+    uint32_t scannedRecords = 0;
+    uint8_t scanned = 0;
+    uint8_t inUse = 0;
+    bool timed = (from != 0 || to != 0xFFFFFFFFU);
+    uint32_t t0 = GetMicros();
+
+    // Newest sector first, newest record first
+    for (int k = 0; k < AUDIT_SECTORS && g_head >= 0; k++) {
+        int i = (g_head - k + AUDIT_SECTORS) % AUDIT_SECTORS;
+        const AuditIndex_t* idx = &g_index[i];
+        if (idx->seq == 0) continue;
+        inUse++;
+
+        // Index pruning: no wall-clock record in range / UID certainly absent
+        if (timed && (idx->maxStamp < from || idx->minStamp > to)) continue;
+        if (uid != AUDIT_ANY_UID && !Bloom_Test(idx->bloom, uid)) continue;
+
+        scanned++;
+        const AuditSector_t* s = Sector(i);
+        for (int n = (int)idx->used - 1; n >= 0; n--) {
+            const AuditRecord_t* r = &s->rec[n];
+            scannedRecords++;
+            if (r->event == AUDIT_FREE) continue;
+            if (uid != AUDIT_ANY_UID && r->uid != uid) continue;
+            if (timed && ((r->flags & AUDIT_FLAG_UPTIME) || r->stamp < from || r->stamp > to)) continue;
+            if (matches < AUDIT_MAX_HITS) hits[matches] = r;
+            matches++;
+        }
+    }
+    uint32_t elapsed = GetMicros() - t0;
+
+    for (uint32_t n = 0; n < matches && n < AUDIT_MAX_HITS; n++) {
+        const AuditRecord_t* r = hits[n];
+        UART_Printf((r->flags & AUDIT_FLAG_UPTIME) ? "[AUDIT ] +%10us %s %08X door %u\r\n"
+                                                    : "[AUDIT ] %11u %s %08X door %u\r\n",
+                    r->stamp, Event_Name(r->event), r->uid, r->door + 1U);
+    }
+    UART_Printf("[AUDIT ] %u match(es)%s. Read %u/%u sectors (%u records) in %u us\r\n",
+                matches, (matches > AUDIT_MAX_HITS) ? ", newest shown" : "",
+                scanned, inUse, scannedRecords, elapsed);
+}
+
+void Audit_PrintSummary(void) {
+    uint32_t total = 0;
+    uint8_t inUse = 0;
+    for (int i = 0; i < AUDIT_SECTORS; i++) {
+        if (g_index[i].seq == 0) continue;
+        inUse++;
+        total += g_index[i].records;
+    }
+    UART_Printf("[AUDIT ] %u records in %u/%u sectors (%u per sector)\r\n",
+                total, inUse, AUDIT_SECTORS, (unsigned)AUDIT_RECORDS_PER_SECTOR);
+}
@@ -0,0 +1,49 @@
+/*
+ * audit_log.h
+ *
+ * Flash Audit Ring (access events) with a per-sector RAM index.
+ * Queries skip every sector whose time range or UID bloom cannot match.
+ */
+
+#ifndef AUDIT_LOG_H
+#define AUDIT_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Ring location: 16 sectors below the journal (0x1B000 - 0x1EFFF).
+// PROGRAM_FLASH (.cproject) ends at AUDIT_BASE_ADDR: code that grows into
+// the data sectors fails to link. Move both together.
+#define AUDIT_BASE_ADDR   0x1B000U
+#define AUDIT_SECTORS     16
+
+#define AUDIT_ANY_UID     0xFFFFFFFFU  // Query wildcard
+#define AUDIT_NO_UID      0U           // Events without a card (PIN, alarm)
+
+typedef enum {
+    AUDIT_CARD_OK = 1,   // Card accepted (enrolled, in schedule)
+    AUDIT_CARD_DENIED,   // Unknown, not enrolled here or outside schedule
+    AUDIT_PIN_OK,
+    AUDIT_PIN_BAD,
+    AUDIT_ALARM,         // Partition entered TRIGGERED
+} AuditEvent_t;
+
+// Scan the ring and rebuild the index (after Storage_Init)
+void Audit_Init(void);
+
+// Append one event (main context; dropped while the supply is failing)
+void Audit_Record(AuditEvent_t event, uint32_t uid, uint8_t door);
+
+// Main loop, outside the FSM: erases the sector the ring wraps onto next
+// once the head is 3/4 full, keeping the sector erase off the access path
+void Audit_Idle(void);
+
+// Print matching events, newest first. uid = AUDIT_ANY_UID matches all.
+// Time range in Unix seconds, inclusive; 0..0xFFFFFFFF = no time filter
+// (events logged before the clock was set only match without a filter).
+void Audit_Query(uint32_t uid, uint32_t from, uint32_t to);
+
+// Record / sector counts
+void Audit_PrintSummary(void);
+
+#endif // AUDIT_LOG_H
@@ -0,0 +1,85 @@
+/*
+ * bloom_filter.c
+ *
+ * [COUNTING BLOOM FILTER]
+ * RAM front for the credential store. Unknown cards are rejected
+ * after a few hash operations without touching Flash.
+ * Counters are 4-bit (2 per byte), saturating at 15 (sticky).
+ */
+
+#include "bloom_filter.h"
+#include <string.h>
+
+#define BLOOM_COUNTERS   (1UL << BLOOM_SIZE_LOG2)
+#define BLOOM_MASK       (BLOOM_COUNTERS - 1U)
+#define BLOOM_MAX_COUNT  15U
+
+static uint8_t g_bloom[BLOOM_COUNTERS / 2];
+
+// ============================================================================
+// INTERNAL HELPERS
+// ============================================================================
+/* Murmur3 finalizer (shift/multiply only; no divide on M0+) */
+static uint32_t Mix32(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85EBCA6BU;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35U;
+    h ^= h >> 16;
+    return h;
+}
+
+static uint8_t Get_Counter(uint32_t idx) {
+    uint8_t b = g_bloom[idx >> 1];
+    return (idx & 1U) ? (b >> 4) : (b & 0x0F);
+}
+
+static void Set_Counter(uint32_t idx, uint8_t val) {
+    uint8_t *b = &g_bloom[idx >> 1];
+    if (idx & 1U) *b = (uint8_t)((*b & 0x0F) | (val << 4));
+    else          *b = (uint8_t)((*b & 0xF0) | (val & 0x0F));
+}
+
+/* Double Hashing: idx_i = h1 + i*h2 (h2 odd -> full period on 2^n table) */
+static void Get_Indices(uint32_t uid, uint32_t idx[BLOOM_NUM_HASHES]) {
+    uint32_t h1 = Mix32(uid);
+    uint32_t h2 = Mix32(h1 ^ 0x9E3779B9U) | 1U;
+    for (uint32_t i = 0; i < BLOOM_NUM_HASHES; i++) {
+        idx[i] = (h1 + i * h2) & BLOOM_MASK;
+    }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+void Bloom_Clear(void) {
+    memset(g_bloom, 0, sizeof(g_bloom));
+}
+
+void Bloom_Add(uint32_t uid) {
+    uint32_t idx[BLOOM_NUM_HASHES];
+    Get_Indices(uid, idx);
+    for (int i = 0; i < BLOOM_NUM_HASHES; i++) {
+        uint8_t c = Get_Counter(idx[i]);
+        if (c < BLOOM_MAX_COUNT) Set_Counter(idx[i], c + 1);
+    }
+}
+
+void Bloom_Remove(uint32_t uid) {
+    uint32_t idx[BLOOM_NUM_HASHES];
+    Get_Indices(uid, idx);
+    for (int i = 0; i < BLOOM_NUM_HASHES; i++) {
+        uint8_t c = Get_Counter(idx[i]);
+        // Saturated counters stay set (count is no longer exact)
+        if (c > 0 && c < BLOOM_MAX_COUNT) Set_Counter(idx[i], c - 1);
+    }
+}
+
+bool Bloom_MayContain(uint32_t uid) {
+    uint32_t idx[BLOOM_NUM_HASHES];
+    Get_Indices(uid, idx);
+    for (int i = 0; i < BLOOM_NUM_HASHES; i++) {
+        if (Get_Counter(idx[i]) == 0) return false;
+    }
+    return true;
+}
@@ -0,0 +1,36 @@
+/*
+ * bloom_filter.h
+ *
+ * Counting Bloom Filter for fast negative RFID lookups.
+ */
+
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Size & Accuracy Tuning
+// Counters = 2^BLOOM_SIZE_LOG2 (4-bit each), RAM = counters / 2 bytes.
+// False-positive rate ~ (1 - e^(-k*n/m))^k
+//   n=50 IDs, m=512, k=4 -> ~1.1%   (256 B)
+//   n=50 IDs, m=1024, k=5 -> ~0.2%  (512 B)
+#ifndef BLOOM_SIZE_LOG2
+#define BLOOM_SIZE_LOG2   9
+#endif
+#ifndef BLOOM_NUM_HASHES
+#define BLOOM_NUM_HASHES  4
+#endif
+
+// Clear all counters
+void Bloom_Clear(void);
+
+// Add / Remove a UID (Remove must only be called for previously added UIDs)
+void Bloom_Add(uint32_t uid);
+void Bloom_Remove(uint32_t uid);
+
+// Returns false if the UID is definitely NOT in the set.
+// Returns true if it MAY be in the set (confirm with the full lookup).
+bool Bloom_MayContain(uint32_t uid);
+
+#endif // BLOOM_FILTER_H
@@ -0,0 +1,45 @@
+/*
+ * board_pins.c
+ *
+ * [BOARD PIN INIT]
+ * Straight-line code generated from board_pins.h: one clock gate write,
+ * then one PCR write per pin and the GPIO direction/level where needed
+ * (keypad lines: one global pin control write per port half). No tables
+ * at run time; every value is a compile-time constant.
+ */
+
+#include "board_pins.h"
+
+#define PORT_CLOCK_OR(name)  | BOARD_CLOCK(name)
+
+#define PIN_INIT(name)                                                        \
+    BOARD_PORT(name)->PCR[BOARD_PIN(name)] = BOARD_PCR(name);                 \
+    if (BOARD_CFG(name) & PIN_CFG_OUTPUT) {                                   \
+        if (BOARD_CFG(name) & PIN_CFG_HIGH) BOARD_GPIO(name)->PSOR = BOARD_MASK(name); \
+        else BOARD_GPIO(name)->PCOR = BOARD_MASK(name);                       \
+        BOARD_GPIO(name)->PDDR |= BOARD_MASK(name);                           \
+    } else if ((BOARD_PCR(name) & PORT_PCR_MUX_MASK) == PORT_PCR_MUX(1)) {     \
+        BOARD_GPIO(name)->PDDR &= ~BOARD_MASK(name);                          \
+    }
+
+#define KP_CLOCK_OR(kp)      | BOARD_KP_ROW_CLOCK(kp) | BOARD_KP_COL_CLOCK(kp)
+
+// Same PCR value on every pin of a mask: two global pin control writes
+#define PORT_PCR_ALL(port, mask, pcr)                                         \
+    (port)->GPCLR = PORT_GPCLR_GPWE((mask) & 0xFFFFUL) | (pcr);               \
+    (port)->GPCHR = PORT_GPCHR_GPWE((mask) >> 16) | (pcr);
+
+// Keypads: rows idle high (outputs), columns pulled-up inputs
+#define KP_INIT(kp)                                                           \
+    PORT_PCR_ALL(BOARD_KP_ROW_PORT_REG(kp), BOARD_KP_ROW_MASK(kp), PIN_CFG_IN) \
+    BOARD_KP_ROW_GPIO(kp)->PSOR = BOARD_KP_ROW_MASK(kp);                      \
+    BOARD_KP_ROW_GPIO(kp)->PDDR |= BOARD_KP_ROW_MASK(kp);                     \
+    PORT_PCR_ALL(BOARD_KP_COL_PORT_REG(kp), BOARD_KP_COL_MASK(kp), PIN_CFG_IN_PULLUP) \
+    BOARD_KP_COL_GPIO(kp)->PDDR &= ~BOARD_KP_COL_MASK(kp);
+
+void BoardPins_Init(void) {
+    SIM->SCGC5 |= 0UL BOARD_PINS(PORT_CLOCK_OR) BOARD_KEYPADS(KP_CLOCK_OR);
+
+    BOARD_PINS(PIN_INIT)
+    BOARD_KEYPADS(KP_INIT)
+}
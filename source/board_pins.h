@@ -0,0 +1,137 @@
+/*
+ * board_pins.h
+ *
+ * Board Description (FRDM-KL25Z + security shield), single source.
+ * Every pin the application uses is described once here; pin-mux init,
+ * port clock gates, GPIO masks, keypad scan tables and timer reload
+ * values are all derived at compile time. Another board = another copy
+ * of this header (select it with -DBOARD_PINS_FILE="board_xyz.h").
+ */
+
+#ifndef BOARD_PINS_H
+#define BOARD_PINS_H
+
+#ifdef BOARD_PINS_FILE
+#include BOARD_PINS_FILE
+#else
+
+#include "MKL25Z4.h"
+#include "clock_config.h"
+
+// ============================================================================
+// CLOCKS & TIMERS
+// ============================================================================
+#define BOARD_CORE_CLOCK_HZ   BOARD_BOOTCLOCKRUN_CORE_CLOCK
+#define BOARD_BUS_CLOCK_HZ    (BOARD_CORE_CLOCK_HZ / 2U)    // OUTDIV4 = /2
+#define BOARD_TICK_HZ         1000U                         // PIT0 system tick
+
+// ============================================================================
+// PIN CONFIGURATIONS (PCR value; bits 30/31 are GPIO direction / level)
+// ============================================================================
+#define PIN_CFG_OUTPUT        (1UL << 30)
+#define PIN_CFG_HIGH          (1UL << 31)
+
+#define PIN_CFG_ANALOG        PORT_PCR_MUX(0)
+#define PIN_CFG_IN            PORT_PCR_MUX(1)
+#define PIN_CFG_IN_PULLUP     (PORT_PCR_MUX(1) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK)
+#define PIN_CFG_IN_PULLDOWN   (PORT_PCR_MUX(1) | PORT_PCR_PE_MASK | PORT_PCR_SRE_MASK)
+#define PIN_CFG_OUT_LOW       (PORT_PCR_MUX(1) | PIN_CFG_OUTPUT)
+#define PIN_CFG_OUT_HIGH      (PORT_PCR_MUX(1) | PIN_CFG_OUTPUT | PIN_CFG_HIGH)
+#define PIN_CFG_ALT(n)        PORT_PCR_MUX(n)
+
+// ============================================================================
+// PINS: <port letter>, <pin>, <configuration>
+// ============================================================================
+#define BOARD_PIN_LED          B, 3,  PIN_CFG_OUT_LOW      // Alarm LED
+#define BOARD_PIN_BUZZER       A, 12, PIN_CFG_ALT(3)       // TPM1_CH0
+#define BOARD_PIN_SERVO        B, 2,  PIN_CFG_ALT(3)       // TPM2_CH0 (SG90)
+#define BOARD_PIN_PIR          A, 5,  PIN_CFG_IN_PULLDOWN  // HC-SR501, rising edge IRQ
+#define BOARD_PIN_ACCEL_INT    A, 14, PIN_CFG_IN_PULLUP    // MMA8451Q INT1, falling edge IRQ
+#define BOARD_PIN_RFID_SCK     C, 5,  PIN_CFG_ALT(2)       // SPI0
+#define BOARD_PIN_RFID_MOSI    C, 6,  PIN_CFG_ALT(2)
+#define BOARD_PIN_RFID_MISO    C, 7,  PIN_CFG_ALT(2)
+#define BOARD_PIN_RFID_CS      C, 4,  PIN_CFG_OUT_HIGH
+#define BOARD_PIN_RFID_RST     C, 0,  PIN_CFG_OUT_HIGH     // NRSTPD
+#define BOARD_PIN_RFID_IRQ     D, 4,  PIN_CFG_IN           // Unused (polled FSM)
+#define BOARD_PIN_BT_RX        D, 2,  PIN_CFG_ALT(3)       // UART2 (HC-05)
+#define BOARD_PIN_BT_TX        D, 3,  PIN_CFG_ALT(3)
+#define BOARD_PIN_BT_STATE     D, 5,  PIN_CFG_IN_PULLUP    // High = client connected
+#define BOARD_PIN_I2C_SCL      E, 24, PIN_CFG_ALT(5)       // I2C0 (onboard MMA8451Q)
+#define BOARD_PIN_I2C_SDA      E, 25, PIN_CFG_ALT(5)
+#define BOARD_PIN_GB_MIC       B, 0,  PIN_CFG_ANALOG       // ADC0_SE8
+#define BOARD_PIN_LOOP_A       E, 29, PIN_CFG_ANALOG       // ADC0_SE4b + CMP0_IN5
+#define BOARD_PIN_LOOP_B       E, 30, PIN_CFG_ANALOG       // ADC0_SE23
+#define BOARD_PIN_RTC_CLKIN    C, 1,  PIN_CFG_IN           // Jumper from CLKOUT
+#define BOARD_PIN_CLKOUT       C, 3,  PIN_CFG_ALT(5)       // 32kHz IRC out
+
+#define BOARD_PINS(X)                                                         \
+    X(LED) X(BUZZER) X(SERVO) X(PIR) X(ACCEL_INT)                             \
+    X(RFID_SCK) X(RFID_MOSI) X(RFID_MISO) X(RFID_CS) X(RFID_RST) X(RFID_IRQ)  \
+    X(BT_RX) X(BT_TX) X(BT_STATE) X(I2C_SCL) X(I2C_SDA)                       \
+    X(GB_MIC) X(LOOP_A) X(LOOP_B) X(RTC_CLKIN) X(CLKOUT)
+
+// ============================================================================
+// KEYPADS: rows on one port (driven low one at a time), columns on one port
+// (pulled up), keymap row-major with one char per key
+// e.g. 4x3 outdoor:  COLS X(2) X(3) X(4),  KEYMAP "123" "456" "789" "*0#"
+//      5x4 panel:    ROWS X(7) .. X(11), KEYMAP "EFGH" "123A" ... (F1-F4 = 'E'-'H')
+// ============================================================================
+#define BOARD_KP_MAIN_ROW_PORT B
+#define BOARD_KP_MAIN_ROWS(X)  X(8) X(9) X(10) X(11)
+#define BOARD_KP_MAIN_COL_PORT E
+#define BOARD_KP_MAIN_COLS(X)  X(2) X(3) X(4) X(5)
+#define BOARD_KP_MAIN_KEYMAP   "123A" "456B" "789C" "*0#D"
+
+#define BOARD_KEYPADS(X)       X(MAIN)
+
+#endif // BOARD_PINS_FILE
+
+// ============================================================================
+// DERIVED (board independent)
+// ============================================================================
+#define BOARD_CAT(a, b)        BOARD_CAT_(a, b)
+#define BOARD_CAT_(a, b)       a##b
+
+// Accessors by pin name, e.g. BOARD_GPIO(LED)->PSOR = BOARD_MASK(LED);
+#define BOARD_PORT(name)       BOARD_PORT_(BOARD_PIN_##name)
+#define BOARD_GPIO(name)       BOARD_GPIO_(BOARD_PIN_##name)
+#define BOARD_PIN(name)        BOARD_NUM_(BOARD_PIN_##name)
+#define BOARD_MASK(name)       (1UL << BOARD_PIN(name))
+#define BOARD_PCR(name)        (BOARD_CFG_(BOARD_PIN_##name) & ~(PIN_CFG_OUTPUT | PIN_CFG_HIGH))
+#define BOARD_CFG(name)        BOARD_CFG_(BOARD_PIN_##name)
+#define BOARD_CLOCK(name)      BOARD_CLOCK_(BOARD_PIN_##name)
+
+#define BOARD_PORT_(d)         BOARD_PORT__(d)
+#define BOARD_PORT__(p, n, c)  PORT##p
+#define BOARD_GPIO_(d)         BOARD_GPIO__(d)
+#define BOARD_GPIO__(p, n, c)  GPIO##p
+#define BOARD_NUM_(d)          BOARD_NUM__(d)
+#define BOARD_NUM__(p, n, c)   (n)
+#define BOARD_CFG_(d)          BOARD_CFG__(d)
+#define BOARD_CFG__(p, n, c)   (c)
+#define BOARD_CLOCK_(d)        BOARD_CLOCK__(d)
+#define BOARD_CLOCK__(p, n, c) SIM_SCGC5_PORT##p##_MASK
+
+// Keypads by name, e.g. BOARD_KP_ROW_MASK(MAIN)
+#define BOARD_KP_ROW_PORT_REG(kp) BOARD_CAT(PORT, BOARD_KP_##kp##_ROW_PORT)
+#define BOARD_KP_ROW_GPIO(kp)  BOARD_CAT(GPIO, BOARD_KP_##kp##_ROW_PORT)
+#define BOARD_KP_ROW_CLOCK(kp) BOARD_CAT(BOARD_CAT(SIM_SCGC5_PORT, BOARD_KP_##kp##_ROW_PORT), _MASK)
+#define BOARD_KP_COL_PORT_REG(kp) BOARD_CAT(PORT, BOARD_KP_##kp##_COL_PORT)
+#define BOARD_KP_COL_GPIO(kp)  BOARD_CAT(GPIO, BOARD_KP_##kp##_COL_PORT)
+#define BOARD_KP_COL_CLOCK(kp) BOARD_CAT(BOARD_CAT(SIM_SCGC5_PORT, BOARD_KP_##kp##_COL_PORT), _MASK)
+
+#define BOARD_BIT_OR_(pin)     | (1UL << (pin))
+#define BOARD_COUNT_(pin)      + 1
+#define BOARD_KP_ROW_MASK(kp)  (0UL BOARD_KP_##kp##_ROWS(BOARD_BIT_OR_))
+#define BOARD_KP_COL_MASK(kp)  (0UL BOARD_KP_##kp##_COLS(BOARD_BIT_OR_))
+#define BOARD_KP_NUM_ROWS(kp)  (0 BOARD_KP_##kp##_ROWS(BOARD_COUNT_))
+#define BOARD_KP_NUM_COLS(kp)  (0 BOARD_KP_##kp##_COLS(BOARD_COUNT_))
+
+// Timers
+#define BOARD_PIT_LDVAL(hz)    (BOARD_BUS_CLOCK_HZ / (hz) - 1U)
+
+// Configure every described pin (port clocks, mux, pulls, GPIO direction/level).
+// Peripheral drivers only add pin interrupts on top.
+void BoardPins_Init(void);
+
+#endif // BOARD_PINS_H
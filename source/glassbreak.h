@@ -0,0 +1,42 @@
+/*
+ * glassbreak.h
+ *
+ * Acoustic Glass-Break Detector (Microphone on ADC0_SE8 / PTB0).
+ * Optional: build with GLASSBREAK_ENABLE=1. The q15 FFT is built in;
+ * GB_USE_CMSIS_DSP=1 uses arm_rfft_q15 instead (link the CMSIS-DSP
+ * Cortex-M0 library, libarm_cortexM0l_math).
+ */
+
+#ifndef GLASSBREAK_H
+#define GLASSBREAK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef GLASSBREAK_ENABLE
+#define GLASSBREAK_ENABLE 0
+#endif
+#ifndef GB_USE_CMSIS_DSP
+#define GB_USE_CMSIS_DSP  0
+#endif
+
+// Sampling
+#define GB_SAMPLE_RATE_HZ  16000U
+#define GB_BLOCK_SIZE      256      // FFT length; 16ms per block at 16kHz
+#define GB_BLOCK_MS        ((GB_BLOCK_SIZE * 1000U) / GB_SAMPLE_RATE_HZ)
+
+// Initialize ADC0 + PIT1 trigger + DMA ping-pong (hardware only)
+void Glassbreak_Init(void);
+
+// Main loop hook: analyses a finished block, if any
+void Glassbreak_Tick(void);
+
+// Feature extraction + detector on one block of q15 samples (mean removed).
+// Hardware independent: a host build can feed it WAV data for offline tuning.
+// Returns true on a glass-break detection.
+bool Glassbreak_ProcessBlock(int16_t* samples);
+
+// Check Detection Flag (True = Glass Break, Clear on read)
+bool Glassbreak_CheckTriggered(void);
+
+#endif // GLASSBREAK_H
@@ -0,0 +1,94 @@
+/*
+ * i2c_driver.c
+ *
+ * [I2C0 MASTER - POLLED]
+ * Short register transactions (< 1ms @ 100kHz except FIFO bursts), every
+ * byte wait is bounded so a stuck bus can never stall the super loop.
+ */
+
+#include "i2c_driver.h"
+#include "fsl_port.h"
+#include "fsl_clock.h"
+#include "MKL25Z4.h"
+#include "board_pins.h"
+
+// Pins: BOARD_PIN_I2C_SCL / _SDA (onboard MMA8451Q bus)
+#define I2C_WAIT_LOOPS   4000U   // ~4x one byte time at 48MHz core
+
+// ============================================================================
+// INTERNAL HELPERS
+// ============================================================================
+static bool Wait_Byte(void) {
+    uint32_t loops = I2C_WAIT_LOOPS;
+    while (!(I2C0->S & I2C_S_IICIF_MASK)) {
+        if (--loops == 0) return false;
+    }
+    I2C0->S = I2C_S_IICIF_MASK; // W1C
+    return true;
+}
+
+static void Stop(void) {
+    I2C0->C1 &= ~(I2C_C1_MST_MASK | I2C_C1_TX_MASK | I2C_C1_TXAK_MASK);
+}
+
+/* START (or repeated START) + address byte, checks ACK */
+static bool Send_Address(uint8_t devAddr, bool read, bool repeated) {
+    if (repeated) {
+        I2C0->C1 |= I2C_C1_RSTA_MASK;
+    } else {
+        if (I2C0->S & I2C_S_BUSY_MASK) return false;
+        I2C0->C1 |= I2C_C1_TX_MASK;
+        I2C0->C1 |= I2C_C1_MST_MASK; // MST 0->1 = START
+    }
+    I2C0->D = (uint8_t)((devAddr << 1) | (read ? 1U : 0U));
+    return Wait_Byte() && !(I2C0->S & I2C_S_RXAK_MASK);
+}
+
+static bool Send_Byte(uint8_t b) {
+    I2C0->D = b;
+    return Wait_Byte() && !(I2C0->S & I2C_S_RXAK_MASK);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+void I2C_Init(void) {
+    CLOCK_EnableClock(kCLOCK_I2c0);
+
+    I2C0->C1 = 0;
+    I2C0->F = I2C_F_MULT(0) | I2C_F_ICR(0x1F); // 24MHz bus / 240 = 100kHz
+    I2C0->S = I2C_S_IICIF_MASK | I2C_S_ARBL_MASK;
+    I2C0->C1 = I2C_C1_IICEN_MASK;
+}
+
+bool I2C_WriteReg(uint8_t devAddr, uint8_t reg, uint8_t value) {
+    bool ok = Send_Address(devAddr, false, false) && Send_Byte(reg) && Send_Byte(value);
+    Stop();
+    return ok;
+}
+
+bool I2C_ReadRegs(uint8_t devAddr, uint8_t reg, uint8_t* buf, uint16_t len) {
+    if (len == 0) return true;
+
+    if (!(Send_Address(devAddr, false, false) && Send_Byte(reg) && Send_Address(devAddr, true, true))) {
+        Stop();
+        return false;
+    }
+
+    // Switch to receive; the dummy read clocks in the first byte
+    I2C0->C1 &= ~I2C_C1_TX_MASK;
+    if (len == 1) I2C0->C1 |= I2C_C1_TXAK_MASK; // NACK the only byte
+    (void)I2C0->D;
+
+    for (uint16_t i = 0; i < len; i++) {
+        if (!Wait_Byte()) { Stop(); return false; }
+
+        if (i == len - 1) {
+            Stop(); // STOP before reading D so no extra byte is clocked
+        } else if (i == len - 2) {
+            I2C0->C1 |= I2C_C1_TXAK_MASK; // NACK the last byte
+        }
+        buf[i] = I2C0->D;
+    }
+    return true;
+}
@@ -0,0 +1,24 @@
+/*
+ * i2c_driver.h
+ *
+ * Blocking I2C0 Master (Register Access Helpers).
+ * Sensor drivers only talk to the bus through these calls, so a host build
+ * can link a register-model stand-in in place of i2c_driver.c.
+ */
+
+#ifndef I2C_DRIVER_H
+#define I2C_DRIVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Initialize I2C0 (PTE24 SCL / PTE25 SDA, 100kHz)
+void I2C_Init(void);
+
+// Write one 8-bit register. Returns false on NACK/timeout.
+bool I2C_WriteReg(uint8_t devAddr, uint8_t reg, uint8_t value);
+
+// Burst read starting at 'reg' (device auto-increments). Returns false on NACK/timeout.
+bool I2C_ReadRegs(uint8_t devAddr, uint8_t reg, uint8_t* buf, uint16_t len);
+
+#endif // I2C_DRIVER_H
@@ -1,144 +1,150 @@
 /*
  * keypad_driver.c
  *
- * [KEYPAD DRIVER - 4x4 MATRIX]
- * Features: Background Scanning (ISR), Software Debounce (20ms), Buffer Timeout.
+ * [KEYPAD DRIVER - MATRIX]
+ * Any number of row/column matrices, each described in board_pins.h.
+ * Features: Background Scanning (ISR), Software Debounce (20 sweeps), Buffer Timeout.
+ * One port read per row; the pressed column comes from bit arithmetic on
+ * that word, so a tick costs the same for 3 or 32 columns.
  */
 
 #include "keypad_driver.h"
 #include "security_manager.h"
-#include "fsl_port.h"
-#include "fsl_gpio.h"
-#include "fsl_clock.h"
+#include "selftest.h"
 #include "MKL25Z4.h"
 #include "timer_driver.h"
-#include "fsl_debug_console.h"
 #include "output_mgr.h"
-#include "uart_driver.h"
+#include "log_mgr.h"
 #include <string.h>
 
 // ============================================================================
 // CONFIGURATION
 // ============================================================================
-#define ROW1_PIN 8U
-#define ROW2_PIN 9U
-#define ROW3_PIN 10U
-#define ROW4_PIN 11U
-
-#define COL1_PIN 2U
-#define COL2_PIN 3U
-#define COL3_PIN 4U
-#define COL4_PIN 5U
-
 #define PASS_LEN 4
 #define TIMEOUT_MS 5000
-
-const char key_map[4][4] = {
-    {'1', '2', '3', 'A'},
-    {'4', '5', '6', 'B'},
-    {'7', '8', '9', 'C'},
-    {'*', '0', '#', 'D'}
-};
-
-static volatile char g_pressed_key = 0;     // Validated, Debounced Key Event
-static volatile char g_raw_key = 0;         // Immediate scan result
-static volatile uint8_t g_stable_count = 0; // Debounce Counter
-
-static char kp_buffer[PASS_LEN + 1];
-static uint8_t kp_index = 0;
-static uint32_t last_key_time_kp = 0;
+#define DEBOUNCE_SWEEPS 20
+
+typedef struct {
+    GPIO_Type* rowGpio;
+    GPIO_Type* colGpio;
+    const uint32_t* rowMask;        // One bit per row, scan order
+    uint32_t colMask;               // All column bits
+    const char* keymap;             // Row-major, numCols chars per row
+    uint8_t numRows;
+    uint8_t numCols;
+} KeypadConfig_t;
+
+typedef struct {
+    // Scan (ISR context)
+    uint8_t row;
+    uint8_t stableCount;
+    char rawKey;                    // Key seen in the current sweep
+    char candidate;
+    char lastValid;
+    volatile char pressedKey;       // Validated, Debounced Key Event
+#if SELFTEST_ENABLE
+    volatile char injectKey;        // Simulated key held on the matrix
+#endif
+    // PIN entry (main loop)
+    char buffer[PASS_LEN + 1];
+    uint8_t index;
+    uint32_t lastKeyTime;
+} KeypadState_t;
+
+// Per keypad: row mask table, keymap size check, config row
+#define KP_MASK_ENTRY(pin) (1UL << (pin)),
+#define KP_ROW_TABLE(kp)                                                      \
+    static const uint32_t g_rowMask_##kp[] = { BOARD_KP_##kp##_ROWS(KP_MASK_ENTRY) }; \
+    typedef char Keypad_##kp##_Keymap_Check[                                  \
+        (sizeof(BOARD_KP_##kp##_KEYMAP) - 1 == BOARD_KP_NUM_ROWS(kp) * BOARD_KP_NUM_COLS(kp)) ? 1 : -1];
+#define KP_CONFIG(kp)                                                         \
+    { BOARD_KP_ROW_GPIO(kp), BOARD_KP_COL_GPIO(kp), g_rowMask_##kp, BOARD_KP_COL_MASK(kp), \
+      BOARD_KP_##kp##_KEYMAP, BOARD_KP_NUM_ROWS(kp), BOARD_KP_NUM_COLS(kp) },
+
+BOARD_KEYPADS(KP_ROW_TABLE)
+
+static const KeypadConfig_t g_kpConfig[KEYPAD_COUNT] = { BOARD_KEYPADS(KP_CONFIG) };
+static KeypadState_t g_kpState[KEYPAD_COUNT];
 
 // ============================================================================
 // INIT
 // ============================================================================
 void Keypad_Init(void) {
-    CLOCK_EnableClock(kCLOCK_PortB);
-    CLOCK_EnableClock(kCLOCK_PortE);
-
-    // Configure Row Pins (Outputs)
-    PORT_SetPinMux(PORTB, ROW1_PIN, kPORT_MuxAsGpio);
-    PORT_SetPinMux(PORTB, ROW2_PIN, kPORT_MuxAsGpio);
-    PORT_SetPinMux(PORTB, ROW3_PIN, kPORT_MuxAsGpio);
-    PORT_SetPinMux(PORTB, ROW4_PIN, kPORT_MuxAsGpio);
-
-    // Set Rows High (Idle)
-    GPIOB->PDDR |= (1U << ROW1_PIN) | (1U << ROW2_PIN) | (1U << ROW3_PIN) | (1U << ROW4_PIN);
-    GPIOB->PSOR |= (1U << ROW1_PIN) | (1U << ROW2_PIN) | (1U << ROW3_PIN) | (1U << ROW4_PIN);
-
-    // Configure Col Pins (Inputs with Pull-Up)
-    PORTE->PCR[COL1_PIN] = PORT_PCR_MUX(1) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;
-    PORTE->PCR[COL2_PIN] = PORT_PCR_MUX(1) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;
-    PORTE->PCR[COL3_PIN] = PORT_PCR_MUX(1) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;
-    PORTE->PCR[COL4_PIN] = PORT_PCR_MUX(1) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;
-    
-    // Ensure inputs
-    GPIOE->PDDR &= ~((1U << COL1_PIN) | (1U << COL2_PIN) | (1U << COL3_PIN) | (1U << COL4_PIN));
+    // Pins (rows = outputs, cols = pulled-up inputs) are set by BoardPins_Init
+    for (int k = 0; k < KEYPAD_COUNT; k++) {
+        const KeypadConfig_t* cfg = &g_kpConfig[k];
+        memset(&g_kpState[k], 0, sizeof(g_kpState[k]));
+        for (int r = 0; r < cfg->numRows; r++) cfg->rowGpio->PSOR = cfg->rowMask[r]; // Idle (high)
+        cfg->rowGpio->PCOR = cfg->rowMask[0];   // First row active
+    }
 }
 
 // ============================================================================
 // SCANNING LOGIC (ISR Context)
 // ============================================================================
-/* 
- * Called every 1ms by PIT Timer.
- * Scans one row per tick (Rotation). Complete scan = 4ms.
- * Debounce requirement: 20 consecutive stable scans.
- */
-void Keypad_Tick(void) {
-    static uint8_t current_row = 0;
-    static char stable_key_candidate = 0;
-    
-    // 1. Read Result directly from inputs (cols)
+/* Set bits in a word (SWAR, no loop: the M0+ has no popcount) */
+static inline uint32_t Bit_Count(uint32_t v) {
+    v = v - ((v >> 1) & 0x55555555U);
+    v = (v & 0x33333333U) + ((v >> 2) & 0x33333333U);
+    v = (v + (v >> 4)) & 0x0F0F0F0FU;
+    return (v * 0x01010101U) >> 24;
+}
+
+/* One row of one keypad: read the row that was driven low last tick, move on */
+static void Keypad_ScanRow(const KeypadConfig_t* cfg, KeypadState_t* st) {
+    // 1. Read Result directly from inputs (cols): lowest active column wins
     char detected_char = 0;
-    uint32_t col_val = GPIOE->PDIR;
-    
-    // Check which Column is LOW (Active)
-    if (!(col_val & (1U << COL1_PIN))) detected_char = key_map[current_row][0];
-    else if (!(col_val & (1U << COL2_PIN))) detected_char = key_map[current_row][1];
-    else if (!(col_val & (1U << COL3_PIN))) detected_char = key_map[current_row][2];
-    else if (!(col_val & (1U << COL4_PIN))) detected_char = key_map[current_row][3];
-    
-    // 2. Disable current Row (Set High)
-    switch(current_row) {
-        case 0: GPIOB->PSOR = (1U << ROW1_PIN); break;
-        case 1: GPIOB->PSOR = (1U << ROW2_PIN); break;
-        case 2: GPIOB->PSOR = (1U << ROW3_PIN); break;
-        case 3: GPIOB->PSOR = (1U << ROW4_PIN); break;
+    uint32_t active = ~cfg->colGpio->PDIR & cfg->colMask;
+    if (active != 0) {
+        uint32_t lowest = active & (0U - active);
+        uint32_t col = Bit_Count(cfg->colMask & (lowest - 1U)); // Column bits below it
+        detected_char = cfg->keymap[st->row * cfg->numCols + col];
     }
-    
-    if (detected_char != 0) g_raw_key = detected_char;
+#if SELFTEST_ENABLE
+    if (st->injectKey != 0) detected_char = st->injectKey;
+#endif
+
+    // 2. Disable current Row (Set High)
+    cfg->rowGpio->PSOR = cfg->rowMask[st->row];
 
-    // 3. Process Stability at end of Scan Cycle (Row 3)
-    if (current_row == 3) {
-        if (g_raw_key != 0 && g_raw_key == stable_key_candidate) {
-            g_stable_count++;
+    if (detected_char != 0) st->rawKey = detected_char;
+
+    // 3. Process Stability at end of Scan Cycle (last row)
+    if (st->row == cfg->numRows - 1U) {
+        if (st->rawKey != 0 && st->rawKey == st->candidate) {
+            if (st->stableCount <= DEBOUNCE_SWEEPS) st->stableCount++;
         } else {
-             stable_key_candidate = g_raw_key;
-             g_stable_count = 0;
+            st->candidate = st->rawKey;
+            st->stableCount = 0;
         }
-        
-        // Edge Logic: Only trigger EVENT on new stable press (after 20ms)
-        static char last_valid_key = 0;
-        if (g_stable_count > 20) {
-             if (stable_key_candidate != last_valid_key) {
-                  g_pressed_key = stable_key_candidate; 
-                  last_valid_key = stable_key_candidate;
-             }
+
+        // Edge Logic: Only trigger EVENT on new stable press
+        if (st->stableCount > DEBOUNCE_SWEEPS) {
+            if (st->candidate != st->lastValid) {
+                st->pressedKey = st->candidate;
+                st->lastValid = st->candidate;
+            }
         } else {
-             if (g_raw_key == 0) last_valid_key = 0; // Release
+            if (st->rawKey == 0) st->lastValid = 0; // Release
         }
-        
-        g_raw_key = 0; // Reset for next sweep
+
+        st->rawKey = 0; // Reset for next sweep
+        st->row = 0;
+    } else {
+        st->row++;
     }
 
-    // 4. Move to Next Row & Enable (Set Low)
-    current_row++;
-    if (current_row > 3) current_row = 0;
+    // 4. Enable Next Row (Set Low)
+    cfg->rowGpio->PCOR = cfg->rowMask[st->row];
+}
 
-    switch(current_row) {
-        case 0: GPIOB->PCOR = (1U << ROW1_PIN); break;
-        case 1: GPIOB->PCOR = (1U << ROW2_PIN); break;
-        case 2: GPIOB->PCOR = (1U << ROW3_PIN); break;
-        case 3: GPIOB->PCOR = (1U << ROW4_PIN); break;
+/*
+ * Called every 1ms by PIT Timer.
+ * Scans one row of each keypad per tick (Rotation): a sweep takes numRows ms.
+ */
+void Keypad_Tick(void) {
+    for (int k = 0; k < KEYPAD_COUNT; k++) {
+        Keypad_ScanRow(&g_kpConfig[k], &g_kpState[k]);
     }
 }
 
@@ -146,49 +152,65 @@ void Keypad_Tick(void) {
 // PUBLIC API
 // ============================================================================
 
-char Keypad_GetKeyNonBlocking(void) {
-    if (g_pressed_key != 0) {
-        char k = g_pressed_key;
-        g_pressed_key = 0; // Event Consumed
+#if SELFTEST_ENABLE
+void Keypad_InjectRaw(char key) {
+    g_kpState[KEYPAD_MAIN].injectKey = key;
+}
+#endif
+
+char Keypad_GetKey(KeypadId_t kp) {
+    KeypadState_t* st = &g_kpState[kp];
+    if (st->pressedKey != 0) {
+        char k = st->pressedKey;
+        st->pressedKey = 0; // Event Consumed
         return k;
     }
     return 0;
 }
 
-int Keypad_CheckPassword(void) {
+int Keypad_CheckPin(KeypadId_t kp) {
+    KeypadState_t* st = &g_kpState[kp];
+
     // 1. Timeout Check: specific for password entry buffer
-    if (kp_index > 0 && IsTimeout(last_key_time_kp, TIMEOUT_MS)) {
-        kp_index = 0;
-        kp_buffer[0] = 0;
-        UART_Printf("\r\n[KEYPAD] TIMEOUT. Buffer Cleared.\r\n");
+    if (st->index > 0 && IsTimeout(st->lastKeyTime, TIMEOUT_MS)) {
+        st->index = 0;
+        st->buffer[0] = 0;
+        LOG(KEYPAD, DEBUG, "TIMEOUT. Buffer Cleared.\r\n");
     }
 
-    char key = Keypad_GetKeyNonBlocking();
+    char key = Keypad_GetKey(kp);
     if (key == 0) return 0;
-    
-    last_key_time_kp = GetTick();
+
+    st->lastKeyTime = GetTick();
     Buzzer_Beep(30); // Tactile Feedback (Short Beep)
-    UART_Printf("\rKEY: %c\r\n", key);
+    LOG(KEYPAD, DEBUG, "Key: %c\r\n", key);
 
     if (key == '#') {
-        kp_index = 0; 
+        st->index = 0;
         return 2; // Trigger Signal
     }
 
     // Append to buffer
-    if (kp_index < PASS_LEN) {
-        kp_buffer[kp_index++] = key;
+    if (st->index < PASS_LEN) {
+        st->buffer[st->index++] = key;
     }
 
     // Validate
-    if (kp_index == PASS_LEN) {
-        kp_buffer[PASS_LEN] = 0;
-        kp_index = 0;
-        
-        UART_Printf("[ACCESS] PIN Submitted: ****\r\n"); // Hide PIN in logs
-        if (Security_CheckPassword(kp_buffer)) return 1;
+    if (st->index == PASS_LEN) {
+        st->buffer[PASS_LEN] = 0;
+        st->index = 0;
+
+        LOG(ACCESS, DEBUG, "PIN Submitted: ****\r\n"); // Hide PIN in logs
+        if (Security_CheckPassword(st->buffer)) return 1;
         else return -1;
     }
     return 0;
 }
- 
\ No newline at end of file
+
+char Keypad_GetKeyNonBlocking(void) {
+    return Keypad_GetKey(KEYPAD_MAIN);
+}
+
+int Keypad_CheckPassword(void) {
+    return Keypad_CheckPin(KEYPAD_MAIN);
+}
@@ -2,24 +2,34 @@
 #define KEYPAD_DRIVER_H
 
 #include <stdint.h>
+#include "board_pins.h"
 
-// Initialize Keypad (Rows=PTB8-11 Out, Cols=PTE2-5 In PullUp)
+// Keypad instances, one per BOARD_KEYPADS entry in board_pins.h (KEYPAD_MAIN, ...)
+#define KEYPAD_ID(kp) KEYPAD_##kp,
+typedef enum {
+    BOARD_KEYPADS(KEYPAD_ID)
+    KEYPAD_COUNT
+} KeypadId_t;
+#undef KEYPAD_ID
+
+// Initialize all keypads (matrix pins and keymaps: BOARD_KP_* in board_pins.h)
 void Keypad_Init(void);
 
-// Scan for key press. Returns char ('0'-'9', 'A'-'D', '*', '#') or 0 if none.
-char Keypad_Scan(void);
+// Tick function called from Timer ISR (e.g. 1ms); scans one row of every keypad
+void Keypad_Tick(void);
 
-// Blocking wait for any key press
-char Keypad_WaitKey(void);
+// Non-blocking Get Key on one keypad. Returns key char or 0 if none.
+char Keypad_GetKey(KeypadId_t kp);
 
-// Non-blocking password check.
-// Returns: 0 (Entering), 1 (Valid), -1 (Invalid)
-int Keypad_CheckPassword(void);
+// Non-blocking password check on one keypad.
+// Returns: 0 (Entering), 1 (Valid), -1 (Invalid), 2 ('#' wakeup key)
+int Keypad_CheckPin(KeypadId_t kp);
 
-// Tick function called from Timer ISR (e.g. 1ms)
-void Keypad_Tick(void);
-
-// Non-blocking Get Key. Returns key char or 0 if none.
+// KEYPAD_MAIN shorthands (PartitionIO_t callbacks of Door 1)
 char Keypad_GetKeyNonBlocking(void);
+int Keypad_CheckPassword(void);
+
+// Self-Test: hold 'key' on KEYPAD_MAIN at scan level (0 = release)
+void Keypad_InjectRaw(char key);
 
 #endif // KEYPAD_DRIVER_H
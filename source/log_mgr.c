@@ -0,0 +1,60 @@
+/*
+ * log_mgr.c
+ *
+ * [LOG LEVELS]
+ * Runtime level table behind LOG(). Formatting, TX priority and idle
+ * recording stay in the UART driver; this module only decides what passes.
+ * Levels start at the compile-time caps (everything built in is shown).
+ */
+
+#include "log_mgr.h"
+#include <string.h>
+
+static const char* const g_catNames[LOG_CATEGORIES] = {
+    "SYSTEM", "ALARM", "ACCESS", "KEYPAD", "SENSOR", "STORAGE", "ADMIN",
+};
+
+static const char* const g_lvlNames[] = { "OFF", "ERROR", "WARN", "INFO", "DEBUG" };
+
+#define NUM_LEVELS (sizeof(g_lvlNames) / sizeof(g_lvlNames[0]))
+
+static const uint8_t g_logMax[LOG_CATEGORIES] = {
+    LOG_MAX_SYSTEM, LOG_MAX_ALARM, LOG_MAX_ACCESS, LOG_MAX_KEYPAD,
+    LOG_MAX_SENSOR, LOG_MAX_STORAGE, LOG_MAX_ADMIN,
+};
+
+uint8_t g_logLevel[LOG_CATEGORIES] = {
+    LOG_MAX_SYSTEM, LOG_MAX_ALARM, LOG_MAX_ACCESS, LOG_MAX_KEYPAD,
+    LOG_MAX_SENSOR, LOG_MAX_STORAGE, LOG_MAX_ADMIN,
+};
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+bool Log_SetLevel(LogCategory_t cat, uint8_t level) {
+    if ((unsigned)cat >= LOG_CATEGORIES || level >= NUM_LEVELS) return false;
+    // Above the cap the calls are compiled out: store what can actually print
+    g_logLevel[cat] = (level > g_logMax[cat]) ? g_logMax[cat] : level;
+    return true;
+}
+
+int Log_FindCategory(const char* name) {
+    for (int i = 0; i < LOG_CATEGORIES; i++) {
+        if (strcmp(name, g_catNames[i]) == 0) return i;
+    }
+    return -1;
+}
+
+int Log_FindLevel(const char* name) {
+    for (int i = 0; i < (int)NUM_LEVELS; i++) {
+        if (strcmp(name, g_lvlNames[i]) == 0) return i;
+    }
+    return -1;
+}
+
+void Log_PrintLevels(void) {
+    UART_Printf("[LOG   ] Category  Level  Built-in\r\n");
+    for (int i = 0; i < LOG_CATEGORIES; i++) {
+        UART_Printf("[LOG   ] %-8s  %-5s  %s\r\n", g_catNames[i], g_lvlNames[g_logLevel[i]], g_lvlNames[g_logMax[i]]);
+    }
+}
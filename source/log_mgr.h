@@ -0,0 +1,106 @@
+/*
+ * log_mgr.h
+ *
+ * Logging Front End: per-category levels, set at run time (LOGLEVEL) and
+ * capped at compile time. LOG() tests the level before its arguments are
+ * evaluated; a call above the compile-time cap is dead code, so the call
+ * and its format string are removed from the image.
+ */
+
+#ifndef LOG_MGR_H
+#define LOG_MGR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "uart_driver.h"
+
+// Levels (lower = more severe)
+#define LOG_LVL_OFF      0
+#define LOG_LVL_ERROR    1
+#define LOG_LVL_WARN     2
+#define LOG_LVL_INFO     3
+#define LOG_LVL_DEBUG    4
+
+// Compile-time cap for every category (Release: LOG_LVL_INFO; admin replies are INFO)
+#ifndef LOG_MAX_LEVEL
+#define LOG_MAX_LEVEL    LOG_LVL_DEBUG
+#endif
+
+typedef enum {
+    LOG_CAT_SYSTEM = 0,  // Boot, arming, door state, supply
+    LOG_CAT_ALARM,       // Alarms, tamper, brute force, invariants
+    LOG_CAT_ACCESS,      // Card / PIN decisions
+    LOG_CAT_KEYPAD,      // Key echo, entry timeout
+    LOG_CAT_SENSOR,      // Accelerometer, glass-break
+    LOG_CAT_STORAGE,     // Flash config / journal
+    LOG_CAT_ADMIN,       // Bluetooth command replies
+    LOG_CATEGORIES
+} LogCategory_t;
+
+// Per-category compile-time caps (override one with e.g. -DLOG_MAX_KEYPAD=LOG_LVL_OFF)
+#ifndef LOG_MAX_SYSTEM
+#define LOG_MAX_SYSTEM   LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_ALARM
+#define LOG_MAX_ALARM    LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_ACCESS
+#define LOG_MAX_ACCESS   LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_KEYPAD
+#define LOG_MAX_KEYPAD   LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_SENSOR
+#define LOG_MAX_SENSOR   LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_STORAGE
+#define LOG_MAX_STORAGE  LOG_MAX_LEVEL
+#endif
+#ifndef LOG_MAX_ADMIN
+#define LOG_MAX_ADMIN    LOG_MAX_LEVEL
+#endif
+
+// Line prefix (joined with the format literal at compile time)
+#define LOG_TAG_SYSTEM   "[SYSTEM] "
+#define LOG_TAG_ALARM    "[ALARM ] "
+#define LOG_TAG_ACCESS   "[ACCESS] "
+#define LOG_TAG_KEYPAD   "[KEYPAD] "
+#define LOG_TAG_SENSOR   "[SENSOR] "
+#define LOG_TAG_STORAGE  "[STORAGE] "
+#define LOG_TAG_ADMIN    "[ADMIN ] "
+
+// TX priority class per category (DEBUG lines always go to UART_TX_DEBUG)
+#define LOG_CLASS_SYSTEM   UART_TX_ACCESS
+#define LOG_CLASS_ALARM    UART_TX_ALARM
+#define LOG_CLASS_ACCESS   UART_TX_ACCESS
+#define LOG_CLASS_KEYPAD   UART_TX_ACCESS
+#define LOG_CLASS_SENSOR   UART_TX_ADMIN
+#define LOG_CLASS_STORAGE  UART_TX_ADMIN
+#define LOG_CLASS_ADMIN    UART_TX_ADMIN
+
+// Runtime levels, read inline by LOG() (write through Log_SetLevel)
+extern uint8_t g_logLevel[LOG_CATEGORIES];
+
+/*
+ * LOG(CATEGORY, LEVEL, "literal format", args...)
+ * e.g. LOG(ACCESS, INFO, "%s: RFID DENIED (UID: %x)\r\n", name, uid);
+ */
+#define LOG(cat, lvl, fmt, ...)                                                             \
+    do {                                                                                    \
+        if (LOG_LVL_##lvl <= LOG_MAX_##cat && LOG_LVL_##lvl <= g_logLevel[LOG_CAT_##cat]) { \
+            UART_LogClass((LOG_LVL_##lvl == LOG_LVL_DEBUG) ? UART_TX_DEBUG : LOG_CLASS_##cat,    \
+                          LOG_TAG_##cat fmt, ##__VA_ARGS__);                                \
+        }                                                                                   \
+    } while (0)
+
+// Runtime level of one category (clamped to its compile-time cap); false if out of range
+bool Log_SetLevel(LogCategory_t cat, uint8_t level);
+
+// Name lookups for LOGLEVEL ("ACCESS", "DEBUG"); -1 if unknown
+int Log_FindCategory(const char* name);
+int Log_FindLevel(const char* name);
+
+// Category table: runtime and compile-time level (LOGLEVEL)
+void Log_PrintLevels(void);
+
+#endif // LOG_MGR_H
@@ -22,7 +22,19 @@
 #include "output_mgr.h"
 #include "timer_driver.h"
 #include "uart_driver.h"
+#include "log_mgr.h"
 #include "storage_mgr.h"
+#include "wall_clock.h"
+#include "glassbreak.h"
+#include "tamper_mgr.h"
+#include "accel_driver.h"
+#include "power_mgr.h"
+#include "supervisor.h"
+#include "selftest.h"
+#include "audit_log.h"
+#include "admin_auth.h"
+#include "board_pins.h"
+#include "wired_port.h"
 
 // Logic Module
 #include "security_manager.h"
@@ -32,10 +44,11 @@ int main(void) {
     // 1. BOARD & CLOCK INIT
     // ============================================================================
     BOARD_InitBootPins();
+    BoardPins_Init(); // Application pins (board_pins.h)
     BOARD_InitBootClocks();
     BOARD_InitBootPeripherals();
-    #ifndef BOARD_INIT_DEBUG_CONSOLE_PERIPHERAL
-    BOARD_InitDebugConsole();
+    #if !defined(BOARD_INIT_DEBUG_CONSOLE_PERIPHERAL) && (SDK_DEBUGCONSOLE != DEBUGCONSOLE_DISABLE)
+    BOARD_InitDebugConsole(); // SDK console on UART0 (not in Release builds)
     #endif
 
     // ============================================================================
@@ -45,26 +58,42 @@ int main(void) {
     // PIT (Periodic Interrupt Timer) - Hard Real-Time 1ms Base
     PIT_Init();
 
+    // RTC Wall Clock (Schedules & Log Timestamps)
+    WallClock_Init();
+
     // Hook into UART0 for Admin Testing
     UART_Bluetooth_Init();
+    WiredPort_Init(); // USB serial: admin key provisioning only
 
-    UART_Printf("\r\n[SYSTEM] *** SECURITY SYSTEM BOOT ***\r\n");
+    LOG(SYSTEM, INFO, "*** SECURITY SYSTEM BOOT ***\r\n");
 
     PIR_Init();     
     RC522_Init();
     Servo_Init(); 
     Keypad_Init();
     Outputs_Init();
+#if GLASSBREAK_ENABLE
+    Glassbreak_Init(); // Needs PIT clock (PIT_Init) for the ADC trigger
+#endif
+#if TAMPER_ENABLE
+    Tamper_Init();
+#endif
+#if ACCEL_ENABLE
+    Accel_Init(); // After PIR_Init (shared PORTA IRQ)
+#endif
     
     // Visual/Audio Confirmation: System Alive
     Output_Startup_Sequence();
     
-    UART_Printf("[SYSTEM] Peripherals Initialized. Waiting for Logic...\r\n");
+    LOG(SYSTEM, INFO, "Peripherals Initialized. Waiting for Logic...\r\n");
 
     // ============================================================================
     // 3. LOGIC STARTUP
     // ============================================================================
     Storage_Init(); // Load Config from Flash BEFORE Security Logic
+    Audit_Init();   // Rebuild the audit ring index
+    AdminAuth_Init(); // Admin frame key + replay counter
+    Power_Init();   // Power-fail journal needs the flash driver
     Security_Init();
     
     // ============================================================================
@@ -72,26 +101,55 @@ int main(void) {
     // ============================================================================
     // Safety feature: Resets system if code freezes for >1s
     // COPT = 3 (Long Timeout ~1024ms), COPCLKS = 0 (1kHz LPO)
+    // Serviced by the supervisor only while every task is healthy
+    // COPC is write-once: Release builds with DISABLE_WDOG=0 so SystemInit()
+    // leaves it alone (Debug keeps it off for breakpoints)
+    Supervisor_Init();
     SIM->COPC = SIM_COPC_COPT(3) | SIM_COPC_COPCLKS(0);
 
     // ============================================================================
     // SUPER LOOP (Power Optimized)
     // ============================================================================
     while(1) {
-        // A. REFRESH WATCHDOG
-        // Service sequence: 0x55 then 0xAA (Must happen < 1s)
-        SIM->SRVCOP = 0x55;
-        SIM->SRVCOP = 0xAA;
-
-        // B. SLEEP 
+        // A. SLEEP 
         // Wait for next Interrupt (PIT 1ms) to save power
         __WFI(); 
+        Supervisor_LoopStart();
         
-        // C. BACKGROUND TASKS (Drivers)
+        // B. BACKGROUND TASKS (Drivers)
+        Power_Tick();
+        Supervisor_TaskBegin(SUP_TASK_RFID);
         RFID_Tick(); 
+        Supervisor_TaskEnd(SUP_TASK_RFID);
+
+        Supervisor_TaskBegin(SUP_TASK_SENSORS);
+#if GLASSBREAK_ENABLE
+        Glassbreak_Tick();
+#endif
+#if TAMPER_ENABLE
+        Tamper_Tick();
+#endif
+#if ACCEL_ENABLE
+        Accel_Tick();
+#endif
+        Supervisor_TaskEnd(SUP_TASK_SENSORS);
 
-        // D. BUSINESS LOGIC (FSM)
+        // C. BUSINESS LOGIC (FSM)
+        Supervisor_TaskBegin(SUP_TASK_SECURITY);
         Security_Update();
+        Supervisor_TaskEnd(SUP_TASK_SECURITY);
+        Audit_Idle(); // Pre-erase the next audit sector (not on the access path)
+
+        // Admin line received by the UART ISR (one per pass)
+        UART_Tick();
+        WiredPort_Tick();
+
+#if SELFTEST_ENABLE
+        Selftest_Tick(); // After the FSM: injected events wait one full loop
+#endif
+
+        // D. REFRESH WATCHDOG (only if every task checked in on time)
+        Supervisor_LoopEnd();
     }
     return 0;
 }
@@ -0,0 +1,111 @@
+/*
+ * mem_pool.c
+ *
+ * [FIXED-BLOCK POOL]
+ * One free list per size class, threaded through the first word of each
+ * free block. The M0+ has no exclusive load/store, so alloc and free mask
+ * interrupts for a few instructions. A full class falls through to the
+ * next larger one before the allocation fails.
+ */
+
+#include "mem_pool.h"
+#include "uart_driver.h"
+#include "fsl_common.h"
+#include <stddef.h>
+
+typedef struct FreeBlock {
+    struct FreeBlock* next;
+} FreeBlock_t;
+
+typedef struct {
+    uint16_t size;
+    uint16_t count;
+    uint8_t* base;                  // Storage: count * size bytes
+    FreeBlock_t* free;
+    uint16_t used;
+    uint16_t high_water;
+    uint16_t failures;              // Requests this class could not serve
+} PoolClass_t;
+
+static uint32_t g_store64[POOL_COUNT_64 * 64 / 4];
+static uint32_t g_store128[POOL_COUNT_128 * 128 / 4];
+
+// Ascending sizes
+static PoolClass_t g_classes[] = {
+    { 64,  POOL_COUNT_64,  (uint8_t*)g_store64,  NULL, 0, 0, 0 },
+    { 128, POOL_COUNT_128, (uint8_t*)g_store128, NULL, 0, 0, 0 },
+};
+
+#define NUM_CLASSES (sizeof(g_classes) / sizeof(g_classes[0]))
+
+static bool g_ready = false;
+
+// ============================================================================
+// INTERNAL HELPERS
+// ============================================================================
+/* Threads every class's free list (first use; no init call ordering to get wrong) */
+static void Pool_Setup(void) {
+    for (uint32_t c = 0; c < NUM_CLASSES; c++) {
+        PoolClass_t* pc = &g_classes[c];
+        pc->free = NULL;
+        for (int i = (int)pc->count - 1; i >= 0; i--) {
+            FreeBlock_t* b = (FreeBlock_t*)(pc->base + (uint32_t)i * pc->size);
+            b->next = pc->free;
+            pc->free = b;
+        }
+    }
+    g_ready = true;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+void* Pool_Alloc(uint16_t size) {
+    void* block = NULL;
+    uint32_t primask = DisableGlobalIRQ();
+    if (!g_ready) Pool_Setup();
+
+    for (uint32_t c = 0; c < NUM_CLASSES && block == NULL; c++) {
+        PoolClass_t* pc = &g_classes[c];
+        if (size > pc->size) continue;
+        if (pc->free == NULL) {
+            pc->failures++;
+            continue;
+        }
+        block = pc->free;
+        pc->free = pc->free->next;
+        if (++pc->used > pc->high_water) pc->high_water = pc->used;
+    }
+    EnableGlobalIRQ(primask);
+    return block;
+}
+
+void Pool_Free(void* block) {
+    if (block == NULL) return;
+
+    // Owning class from the address: constant number of range checks
+    for (uint32_t c = 0; c < NUM_CLASSES; c++) {
+        PoolClass_t* pc = &g_classes[c];
+        uint8_t* p = (uint8_t*)block;
+        if (p < pc->base || p >= pc->base + (uint32_t)pc->count * pc->size) continue;
+
+        uint32_t primask = DisableGlobalIRQ();
+        FreeBlock_t* b = (FreeBlock_t*)(pc->base + ((uint32_t)(p - pc->base) / pc->size) * pc->size);
+        b->next = pc->free;
+        pc->free = b;
+        pc->used--;
+        EnableGlobalIRQ(primask);
+        return;
+    }
+}
+
+void Pool_PrintStats(void) {
+    uint32_t total = 0;
+    UART_Printf("[POOL  ] Size  Blocks  InUse  HighWater  Fails\r\n");
+    for (uint32_t c = 0; c < NUM_CLASSES; c++) {
+        const PoolClass_t* pc = &g_classes[c];
+        UART_Printf("[POOL  ] %4u  %6u  %5u  %9u  %5u\r\n", pc->size, pc->count, pc->used, pc->high_water, pc->failures);
+        total += (uint32_t)pc->size * pc->count;
+    }
+    UART_Printf("[POOL  ] %u B reserved\r\n", total);
+}
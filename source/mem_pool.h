@@ -0,0 +1,35 @@
+/*
+ * mem_pool.h
+ *
+ * Fixed-Block Memory Pool (static, a few size classes).
+ * O(1) alloc/free, safe from any ISR. A block has one owner at a time:
+ * a producer passes the pointer on (e.g. ISR -> main loop) and the
+ * consumer frees it. Block counts are tuned from POOLSTATS high-water marks.
+ */
+
+#ifndef MEM_POOL_H
+#define MEM_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Blocks per class (sizes 64 / 128 B)
+#ifndef POOL_COUNT_64
+#define POOL_COUNT_64    4    // "Last message repeated" lines
+#endif
+#ifndef POOL_COUNT_128
+#define POOL_COUNT_128   8    // Formatted log lines (main + ISR), RX lines in flight, frame MAC input
+#endif
+
+#define POOL_MAX_BLOCK   128
+
+// Smallest free block of at least 'size' bytes (word aligned), or NULL
+void* Pool_Alloc(uint16_t size);
+
+// Return a block (NULL is ignored)
+void Pool_Free(void* block);
+
+// Per class: size, blocks, in use, high-water mark, failed allocations (POOLSTATS)
+void Pool_PrintStats(void);
+
+#endif // MEM_POOL_H
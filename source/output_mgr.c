@@ -12,19 +12,8 @@
 #include "fsl_port.h"
 #include "fsl_clock.h"
 #include "MKL25Z4.h"
-
-// ===================================
-// LED Conf (PTB3)
-// ===================================
-#define LED_GPIO    GPIOB
-#define LED_PORT    PORTB
-#define LED_PIN     3U
-
-// ===================================
-// Buzzer Conf (PTA12 - TPM1_CH0)
-// ===================================
-#define BUZZER_PORT PORTA
-#define BUZZER_PIN  12U
+#include "board_pins.h"
+#include "power_mgr.h"
 
 static void delay_ms_sw(volatile uint32_t ms) {
     volatile uint32_t i;
@@ -34,25 +23,9 @@ static void delay_ms_sw(volatile uint32_t ms) {
 }
 
 void Outputs_Init(void) {
-    // ------------------------------------------------------------------------
-    // 1. LED Init (PTB3 - GPIO)
-    // ------------------------------------------------------------------------
-    CLOCK_EnableClock(kCLOCK_PortB);
-    PORT_SetPinMux(LED_PORT, LED_PIN, kPORT_MuxAsGpio);
-    
-    gpio_pin_config_t led_config = { kGPIO_DigitalOutput, 1 }; 
-    led_config.outputLogic = 0;
-    
-    GPIO_PinInit(LED_GPIO, LED_PIN, &led_config);
+    // LED (GPIO output, off) and Buzzer (TPM1_CH0) pins are set by BoardPins_Init
+    // Buzzer: use TPM1 to avoid resource conflict with Servo (TPM2)
 
-    // ------------------------------------------------------------------------
-    // 2. Buzzer Init (PTA12 - TPM1_CH0)
-    // ------------------------------------------------------------------------
-    // Use TPM1 to avoid resource conflict with Servo (TPM2)
-    
-    CLOCK_EnableClock(kCLOCK_PortA);
-    PORT_SetPinMux(BUZZER_PORT, BUZZER_PIN, kPORT_MuxAlt3); // TPM1_CH0
-    
     // Enable TPM1 Clock
     CLOCK_EnableClock(kCLOCK_Tpm1);
     
@@ -66,29 +39,33 @@ void Outputs_Init(void) {
     // 48MHz / 128 = 375kHz ticks
     TPM1->SC |= TPM_SC_PS(7); 
     
-    // Enable CH0 (PTA12) for Edge Aligned PWM
+    // Enable CH0 (buzzer pin) for Edge Aligned PWM
     TPM1->CONTROLS[0].CnSC = TPM_CnSC_MSB_MASK | TPM_CnSC_ELSB_MASK;
     
     // Start Timer
     TPM1->SC |= TPM_SC_CMOD(1);
 }
 
+// Shed by the LVW interrupt: stays off until Power_Tick sees the supply recover
 void LED_Alarm_On(void) {
-    GPIO_SetPinsOutput(LED_GPIO, 1U << LED_PIN);
+    if (Power_IsFailing()) return;
+    BOARD_GPIO(LED)->PSOR = BOARD_MASK(LED);
 }
 
 void LED_Alarm_Off(void) {
-    GPIO_ClearPinsOutput(LED_GPIO, 1U << LED_PIN);
+    BOARD_GPIO(LED)->PCOR = BOARD_MASK(LED);
 }
 
 void LED_Alarm_Toggle(void) {
-    GPIO_TogglePinsOutput(LED_GPIO, 1U << LED_PIN);
+    if (Power_IsFailing()) return;
+    BOARD_GPIO(LED)->PTOR = BOARD_MASK(LED);
 }
 
 // ----------------------------------------------------------------------------
 // Buzzer Logic (TPM1)
 // ----------------------------------------------------------------------------
 void Buzzer_On(uint16_t pitch, uint8_t volume) {
+    if (Power_IsFailing()) return; // Shed load, as for the LED
     // Limit Volume
     if (volume > 50) volume = 50; 
     if (volume < 1) volume = 1;
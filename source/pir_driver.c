@@ -6,35 +6,20 @@
  */
 
 #include "pir_driver.h"
+#include "accel_driver.h"
+#include "selftest.h"
 #include "fsl_port.h"
 #include "fsl_gpio.h"
 #include "fsl_clock.h"
 #include "MKL25Z4.h"
-
-// Configuration: PTA5 (Input)
-#define PIR_GPIO      GPIOA
-#define PIR_PORT      PORTA
-#define PIR_PIN       5U
+#include "board_pins.h"
 
 static volatile bool g_pirDetected = false;
 
 void PIR_Init(void) {
-    CLOCK_EnableClock(kCLOCK_PortA);
-
-    port_pin_config_t pir_port_options = {0};
-    pir_port_options.pullSelect = kPORT_PullDown; // Internal weak Pull-Down
-    pir_port_options.slewRate = kPORT_SlowSlewRate;
-    pir_port_options.mux = kPORT_MuxAsGpio;
-
+    // Pin (input, weak pull-down) is set by BoardPins_Init
     // Configure Interrupt for Rising Edge (Motion started)
-    PORT_SetPinConfig(PIR_PORT, PIR_PIN, &pir_port_options);
-    PORT_SetPinInterruptConfig(PIR_PORT, PIR_PIN, kPORT_InterruptRisingEdge);
-
-    gpio_pin_config_t pir_config = {
-        kGPIO_DigitalInput,
-        0,
-    };
-    GPIO_PinInit(PIR_GPIO, PIR_PIN, &pir_config);
+    PORT_SetPinInterruptConfig(BOARD_PORT(PIR), BOARD_PIN(PIR), kPORT_InterruptRisingEdge);
     
     // Enable IRQ
     NVIC_SetPriority(PORTA_IRQn, 3);
@@ -43,8 +28,14 @@ void PIR_Init(void) {
 
 bool PIR_Read(void) {
     // Read Pin. If 1 -> Motion Detected.
-    return (GPIO_ReadPinInput(PIR_GPIO, PIR_PIN) == 1U);
+    return (BOARD_GPIO(PIR)->PDIR & BOARD_MASK(PIR)) != 0U;
+}
+
+#if SELFTEST_ENABLE
+void PIR_Inject(void) {
+    g_pirDetected = true; // Same flag the edge ISR sets
 }
+#endif
 
 bool PIR_CheckTriggered(void) {
     if (g_pirDetected) {
@@ -56,12 +47,15 @@ bool PIR_CheckTriggered(void) {
 
 // ISR Handler name predefined in startup code
 void PORTA_IRQHandler(void) {
-    // Check if PTA5 caused the interrupt
-    if (PORT_GetPinsInterruptFlags(PIR_PORT) & (1U << PIR_PIN)) {
+    // Check if the PIR pin caused the interrupt
+    if (PORT_GetPinsInterruptFlags(BOARD_PORT(PIR)) & BOARD_MASK(PIR)) {
         // Clear Flag
-        PORT_ClearPinsInterruptFlags(PIR_PORT, (1U << PIR_PIN));
+        PORT_ClearPinsInterruptFlags(BOARD_PORT(PIR), BOARD_MASK(PIR));
         
         // Set Logic Flag
         g_pirDetected = true;
     }
+#if ACCEL_ENABLE
+    Accel_PortIrq(); // PTA14: MMA8451Q INT1 shares the PORTA vector
+#endif
 }
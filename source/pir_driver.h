@@ -16,6 +16,9 @@ void PIR_Init(void);
 // Read PIR Status (True = Motion)
 bool PIR_Read(void);
 
+// Self-Test: simulate a rising edge
+void PIR_Inject(void);
+
 // Check Interrupt Flag (True = Motion Started)
 bool PIR_CheckTriggered(void);
 
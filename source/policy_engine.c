@@ -0,0 +1,105 @@
+/*
+ * policy_engine.c
+ *
+ * [ACCESS POLICY ENGINE]
+ * Straight-line stack bytecode, verified once at load time.
+ * Worst case: POLICY_MAX_LEN single-byte ops, no loops or jumps.
+ */
+
+#include "policy_engine.h"
+
+// ============================================================================
+// INTERNAL HELPERS
+// ============================================================================
+/* Operand bytes following an opcode, or -1 if unknown */
+static int Operand_Size(uint8_t op) {
+    switch (op) {
+        case POP_PUSH:
+        case POP_CARD_GROUP:
+        case POP_STATE_IS:    return 1;
+        case POP_PIN_WITHIN:
+        case POP_CARD_WITHIN:
+        case POP_OTHER_CARD:  return 2;
+        case POP_CARD_UID:    return 4;
+        case POP_EV_PIN:
+        case POP_EV_CARD:
+        case POP_AND:
+        case POP_OR:
+        case POP_NOT:
+        case POP_SELECT:      return 0;
+        default:              return -1;
+    }
+}
+
+/* Net stack effect and minimum depth required */
+static void Stack_Effect(uint8_t op, int* delta, int* need) {
+    switch (op) {
+        case POP_AND:
+        case POP_OR:     *delta = -1; *need = 2; break;
+        case POP_NOT:    *delta = 0;  *need = 1; break;
+        case POP_SELECT: *delta = -2; *need = 3; break;
+        default:         *delta = 1;  *need = 0; break;
+    }
+}
+
+static bool Within(uint32_t now, uint32_t then, uint16_t windowMs) {
+    return (then != 0) && ((now - then) <= windowMs);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+bool Policy_Verify(const uint8_t* code, uint16_t len) {
+    if (code == 0 || len == 0 || len > POLICY_MAX_LEN) return false;
+
+    int depth = 0;
+    uint16_t pc = 0;
+    while (pc < len) {
+        uint8_t op = code[pc];
+        int opnd = Operand_Size(op);
+        if (opnd < 0 || pc + 1 + opnd > len) return false;
+
+        int delta, need;
+        Stack_Effect(op, &delta, &need);
+        if (depth < need) return false;
+        depth += delta;
+        if (depth > POLICY_STACK_SIZE) return false;
+
+        pc += 1 + opnd;
+    }
+    return depth == 1;
+}
+
+uint8_t Policy_Evaluate(const uint8_t* code, uint16_t len, const PolicyCtx_t* ctx) {
+    uint8_t stack[POLICY_STACK_SIZE];
+    int sp = 0;
+    uint16_t pc = 0;
+
+    while (pc < len) {
+        uint8_t op = code[pc++];
+        uint32_t imm = 0;
+        int opnd = Operand_Size(op);
+        for (int i = 0; i < opnd; i++) imm |= (uint32_t)code[pc++] << (8 * i);
+
+        switch (op) {
+            case POP_PUSH:        stack[sp++] = (uint8_t)imm; break;
+            case POP_EV_PIN:      stack[sp++] = ctx->pin_ok; break;
+            case POP_EV_CARD:     stack[sp++] = ctx->card_ok; break;
+            case POP_CARD_UID:    stack[sp++] = ctx->card_ok && (ctx->card_uid == imm); break;
+            case POP_CARD_GROUP:  stack[sp++] = ctx->card_ok && (ctx->card_group == imm); break;
+            case POP_STATE_IS:    stack[sp++] = (ctx->state == imm); break;
+            case POP_PIN_WITHIN:  stack[sp++] = ctx->pin_ok || Within(ctx->now, ctx->last_pin_time, (uint16_t)imm); break;
+            case POP_CARD_WITHIN: stack[sp++] = ctx->card_ok || Within(ctx->now, ctx->last_card_time, (uint16_t)imm); break;
+            case POP_OTHER_CARD:
+                stack[sp++] = ctx->card_ok && Within(ctx->now, ctx->last_card_time, (uint16_t)imm) &&
+                              (ctx->last_card_uid != ctx->card_uid);
+                break;
+            case POP_AND:    sp--; stack[sp - 1] = stack[sp - 1] && stack[sp]; break;
+            case POP_OR:     sp--; stack[sp - 1] = stack[sp - 1] || stack[sp]; break;
+            case POP_NOT:    stack[sp - 1] = !stack[sp - 1]; break;
+            case POP_SELECT: sp -= 2; stack[sp - 1] = stack[sp - 1] ? stack[sp] : stack[sp + 1]; break;
+            default:         return POLICY_DENY; // Unreachable for verified code
+        }
+    }
+    return (sp == 1) ? stack[0] : POLICY_DENY;
+}
@@ -0,0 +1,89 @@
+/*
+ * policy_engine.h
+ *
+ * Bounded Bytecode Interpreter for Access Policies.
+ *
+ * Programs are straight-line (no jumps, no loops): at most POLICY_MAX_LEN
+ * bytes are executed once, so evaluation has a fixed worst-case cost.
+ * Stack machine, 8 entries, values are 0/1 (conditions) or results.
+ *
+ * Encoding (multi-byte immediates little endian):
+ *   0x01 PUSH  imm8          push imm
+ *   0x02 EV_PIN              push 1 if this event is a valid PIN
+ *   0x03 EV_CARD             push 1 if this event is a valid card
+ *   0x04 CARD_UID imm32      push 1 if the event card UID == imm
+ *   0x05 CARD_GROUP imm8     push 1 if the event card's schedule group == imm
+ *   0x06 STATE_IS imm8       push 1 if the FSM state == imm (POLICY_STATE_*)
+ *   0x07 PIN_WITHIN imm16    push 1 if a valid PIN was seen in the last imm ms
+ *   0x08 CARD_WITHIN imm16   push 1 if a valid card was seen in the last imm ms
+ *   0x09 OTHER_CARD imm16    push 1 if a DIFFERENT valid card was seen in the last imm ms
+ *   0x10 AND / 0x11 OR       pop 2, push result
+ *   0x12 NOT                 pop 1, push !x
+ *   0x13 SELECT              pop b, a, c; push c ? a : b
+ * Result = the single value left on the stack (POLICY_DENY/ALLOW/PENDING).
+ *
+ * Example "card + PIN within 10s":
+ *   07 10 27  08 10 27  10  01 01  03  02  11  01 02  01 00  13 13
+ *   -> (pin&card) ? ALLOW : ((card|pin) ? PENDING : DENY)
+ */
+
+#ifndef POLICY_ENGINE_H
+#define POLICY_ENGINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define POLICY_MAX_LEN    64
+#define POLICY_STACK_SIZE 8
+
+// Results
+#define POLICY_DENY       0
+#define POLICY_ALLOW      1
+#define POLICY_PENDING    2   // More factors needed (not a failed attempt)
+
+// FSM States as seen by STATE_IS (same order as SystemState_t)
+#define POLICY_STATE_ARMED        0
+#define POLICY_STATE_ENTRY_DELAY  1
+#define POLICY_STATE_EXIT_DELAY   2
+#define POLICY_STATE_TRIGGERED    3
+#define POLICY_STATE_DISARMED     4
+#define POLICY_STATE_LOCKED       5
+
+// Opcodes
+enum {
+    POP_PUSH       = 0x01,
+    POP_EV_PIN     = 0x02,
+    POP_EV_CARD    = 0x03,
+    POP_CARD_UID   = 0x04,
+    POP_CARD_GROUP = 0x05,
+    POP_STATE_IS   = 0x06,
+    POP_PIN_WITHIN = 0x07,
+    POP_CARD_WITHIN= 0x08,
+    POP_OTHER_CARD = 0x09,
+    POP_AND        = 0x10,
+    POP_OR         = 0x11,
+    POP_NOT        = 0x12,
+    POP_SELECT     = 0x13,
+};
+
+// Auth Event Context (filled by the Security Manager)
+typedef struct {
+    bool pin_ok;             // This event: valid PIN
+    bool card_ok;            // This event: listed card within schedule
+    uint32_t card_uid;
+    uint8_t card_group;
+    uint8_t state;           // POLICY_STATE_*
+    uint32_t now;            // ms
+    uint32_t last_pin_time;  // ms of last valid PIN (0 = never)
+    uint32_t last_card_time; // ms of last valid card (0 = never)
+    uint32_t last_card_uid;  // UID of that card
+} PolicyCtx_t;
+
+// Static check: known opcodes, operands in bounds, no stack over/underflow,
+// exactly one result. Only verified programs are ever executed.
+bool Policy_Verify(const uint8_t* code, uint16_t len);
+
+// Runs a verified program. Returns POLICY_DENY/ALLOW/PENDING.
+uint8_t Policy_Evaluate(const uint8_t* code, uint16_t len, const PolicyCtx_t* ctx);
+
+#endif // POLICY_ENGINE_H
@@ -0,0 +1,97 @@
+/*
+ * power_mgr.c
+ *
+ * [POWER-FAIL HANDLING - PMC LVW]
+ * LVW trips at 2.92V, well above the 1.6V LVD reset. With ~100uF of
+ * hold-up at ~30mA the rail needs ~4ms to sag to the flash minimum
+ * (1.71V); the path below needs < 50us to shed load plus ~65us per
+ * journal longword (datasheet typ.).
+ *
+ * Order in the ISR:
+ *   1. Shed load: RC522 into hard power-down (antenna off), servo PWM
+ *      stopped and pin floated, buzzer and LED off.
+ *   2. Flash: config writes run with interrupts masked, so this ISR only
+ *      runs between operations. A save caught between its primary and
+ *      shadow copy is flagged; the loader falls back to the shadow copy.
+ *   3. Commit the packed FSM state and one power-fail record (time,
+ *      measured shed and commit latency): four longwords, ~260us.
+ *      The next boot logs both against POWER_HOLDUP_US.
+ */
+
+#include "power_mgr.h"
+#include "MKL25Z4.h"
+#include "fsl_common.h"
+#include "rfid_driver.h"
+#include "servo_driver.h"
+#include "output_mgr.h"
+#include "storage_mgr.h"
+#include "timer_driver.h"
+#include "wall_clock.h"
+#include "log_mgr.h"
+#include "security_manager.h"
+
+#define LVW_LEVEL_2V92   3U     // LVWV with LVDV = low range
+
+static volatile bool g_powerFailing = false;
+static volatile bool g_journalOk = false;
+
+// ============================================================================
+// INTERNAL HELPERS
+// ============================================================================
+/* Microseconds since 'startCount' on the 1ms PIT0 down-counter (< 1ms spans) */
+static uint16_t Elapsed_Us(uint32_t startCount) {
+    uint32_t reload = PIT->CHANNEL[0].LDVAL + 1U;
+    uint32_t now = PIT->CHANNEL[0].CVAL;
+    uint32_t counts = (startCount >= now) ? (startCount - now) : (startCount + reload - now);
+    return (uint16_t)((counts * 1000U) / reload);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+void Power_Init(void) {
+    PMC->LVDSC2 = PMC_LVDSC2_LVWACK_MASK | PMC_LVDSC2_LVWIE_MASK | PMC_LVDSC2_LVWV(LVW_LEVEL_2V92);
+    NVIC_SetPriority(LVD_LVW_IRQn, 0);
+    EnableIRQ(LVD_LVW_IRQn);
+}
+
+void Power_Tick(void) {
+    if (!g_powerFailing) return;
+
+    // LVWF only clears on ACK once VDD is back above the warning level
+    PMC->LVDSC2 |= PMC_LVDSC2_LVWACK_MASK;
+    if (PMC->LVDSC2 & PMC_LVDSC2_LVWF_MASK) return;
+
+    RFID_PowerUp();
+    Servo_Resume();
+    g_powerFailing = false;
+    PMC->LVDSC2 |= PMC_LVDSC2_LVWIE_MASK; // Re-arm
+    LOG(SYSTEM, WARN, "Supply Recovered (journal %s).\r\n", g_journalOk ? "OK" : "FULL");
+}
+
+bool Power_IsFailing(void) {
+    return g_powerFailing;
+}
+
+void LVD_LVW_IRQHandler(void) {
+    if (!(PMC->LVDSC2 & PMC_LVDSC2_LVWF_MASK)) return;
+    uint32_t start = PIT->CHANNEL[0].CVAL;
+
+    // One shot until Power_Tick sees the supply recover
+    PMC->LVDSC2 = (PMC->LVDSC2 & ~PMC_LVDSC2_LVWIE_MASK) | PMC_LVDSC2_LVWACK_MASK;
+    g_powerFailing = true;
+
+    // 1. Shed Load
+    RFID_PowerDown();
+    Servo_Release();
+    Buzzer_Off();
+    LED_Alarm_Off();
+
+    // 2./3. Journal Records (FSM state first: it decides the resume state)
+    // The power-fail record carries the measured shed and FSM commit times
+    uint32_t stamp = WallClock_IsSet() ? WallClock_GetTime() : GetTick();
+    uint16_t shedUs = Elapsed_Us(start);
+    g_journalOk = Storage_JournalAppend(JOURNAL_FSM_STATE, Security_PackState(), stamp);
+    uint16_t commitUs = Elapsed_Us(start) - shedUs;
+    g_journalOk = Storage_JournalAppend(JOURNAL_POWER_FAIL, JOURNAL_PF_INFO(shedUs, commitUs), stamp) && g_journalOk;
+}
@@ -0,0 +1,25 @@
+/*
+ * power_mgr.h
+ *
+ * Supply Supervision: PMC Low-Voltage Warning (LVW) power-fail path.
+ */
+
+#ifndef POWER_MGR_H
+#define POWER_MGR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Hold-up from the LVW trip to the flash minimum (100uF at ~30mA, see power_mgr.c)
+#define POWER_HOLDUP_US  4000U
+
+// Arm the LVW interrupt (highest priority)
+void Power_Init(void);
+
+// Main loop: detects supply recovery and restores shed peripherals
+void Power_Tick(void);
+
+// True from the LVW interrupt until the supply is back above the warning level
+bool Power_IsFailing(void);
+
+#endif // POWER_MGR_H
@@ -13,7 +13,10 @@
 #include "fsl_clock.h"
 #include "timer_driver.h"
 #include "fsl_debug_console.h"
-#include "uart_driver.h"
+#include "log_mgr.h"
+#include "supervisor.h"
+#include "selftest.h"
+#include "board_pins.h"
 #include <string.h>
 
 // ============================================================================
@@ -23,10 +26,15 @@ typedef enum {
     RFID_IDLE,          // Waiting for cycle time
     RFID_REQ_SENT,      // Request Command sent, waiting for IRQ/Data
     RFID_ANTICOLL_SENT, // Anticoll Command sent, waiting for IRQ/Data
+    RFID_WAKE_SENT,     // WUPA sent to re-select the card for the next key
+    RFID_SELECT_SENT,   // Select Command sent, waiting for SAK
+    RFID_AUTH_SENT,     // MFAuthent running in the RC522 (Crypto1 handshake)
+    RFID_READ_SENT,     // Read Command sent, waiting for 16 data bytes
     RFID_HALT_SENT,     // Halt Command Sent (Optional wait) or just Done
 } RFID_State_t;
 
 static volatile RFID_State_t g_rfidState = RFID_IDLE;
+static volatile bool g_powered_down = false; // RST held low (power-fail load shed)
 static uint32_t g_rfid_timer = 0;       // For FSM timeouts
 static uint32_t g_next_scan_time = 0;   // Interval control
 
@@ -37,6 +45,31 @@ static int g_last_valid_result = 0;
 static uint8_t g_last_uid[5] = {0};
 static uint32_t g_last_uid_time = 0;
 
+// Credential Pipeline (SELECT -> AUTH -> READ on a new card)
+static uint8_t g_pending_uid[5] = {0};
+static RFID_Credential_t g_last_credential;
+
+// Sector Key Cache (RAM copy, one key per site)
+typedef struct {
+    uint16_t site_code;
+    uint8_t key[6];
+    bool used;
+} RFID_KeySlot_t;
+
+static RFID_KeySlot_t g_key_cache[RFID_MAX_SITE_KEYS];
+static uint8_t g_key_slot = 0;          // Slot tried first (last key that worked)
+static uint8_t g_keys_tried = 0;        // Keys tried on the pending card
+
+// Recent-UID Hold-Off Cache (Flood Suppression)
+typedef struct {
+    uint32_t uid;
+    uint32_t start;
+    uint32_t duration;
+    uint16_t suppressed;    // Scans dropped during the window
+} RFID_HoldOff_t;
+
+static RFID_HoldOff_t g_holdoff[RFID_HOLDOFF_SLOTS];
+
 // ============================================================================
 // REGISTERS & CONSTANTS
 // ============================================================================
@@ -74,10 +107,21 @@ static uint32_t g_last_uid_time = 0;
 #define CRCResultRegH  0x21
 #define CRCResultRegL  0x22
 #define PICC_ANTICOLL  0x93
+#define PICC_SELECT_NVB 0x70
+#define PICC_AUTHENT1A 0x60
+#define PICC_READ      0x30
+
+#define Status2_MFCrypto1On 0x08
+#define DivIrq_CRCIRq  0x04
+#define CRC_POLL_LIMIT 200     // ~5 bytes at 848 kBd; bounded spin
 
-#define RFID_CS_PIN   4U
-#define RFID_RST_PIN  0U
-#define RFID_IRQ_PIN  4U
+#define RFID_STAGE_TIMEOUT_MS 25   // Per protocol step
+#define RFID_AUTH_TIMEOUT_MS  10   // MFAuthent completes in ~2ms
+
+#define CS_LOW()      (BOARD_GPIO(RFID_CS)->PCOR = BOARD_MASK(RFID_CS))
+#define CS_HIGH()     (BOARD_GPIO(RFID_CS)->PSOR = BOARD_MASK(RFID_CS))
+#define RST_LOW()     (BOARD_GPIO(RFID_RST)->PCOR = BOARD_MASK(RFID_RST))
+#define RST_HIGH()    (BOARD_GPIO(RFID_RST)->PSOR = BOARD_MASK(RFID_RST))
 
 // ============================================================================
 // LOW LEVEL SPI (Synchronous but fast)
@@ -86,14 +130,7 @@ static uint32_t g_last_uid_time = 0;
 
 void SPI0_Init_SDK(void) {
     spi_master_config_t userConfig;
-    CLOCK_EnableClock(kCLOCK_PortC);
-    PORT_SetPinMux(PORTC, 5U, kPORT_MuxAlt2); // SCK
-    PORT_SetPinMux(PORTC, 6U, kPORT_MuxAlt2); // MOSI
-    PORT_SetPinMux(PORTC, 7U, kPORT_MuxAlt2); // MISO
-    PORT_SetPinMux(PORTC, RFID_CS_PIN, kPORT_MuxAsGpio);
-    PORT_SetPinMux(PORTC, RFID_RST_PIN, kPORT_MuxAsGpio);
-    GPIOC->PDDR |= (1U << RFID_CS_PIN) | (1U << RFID_RST_PIN);
-    GPIOC->PSOR |= (1U << RFID_CS_PIN) | (1U << RFID_RST_PIN);
+    // SCK/MOSI/MISO (SPI0) and CS/RST (GPIO, high) are set by BoardPins_Init
 
     SPI_MasterGetDefaultConfig(&userConfig);
     userConfig.baudRate_Bps = 1000000; 
@@ -115,36 +152,31 @@ uint8_t SPI0_Transfer(uint8_t data) {
 }
 
 void WriteReg(uint8_t addr, uint8_t val) {
-    GPIOC->PCOR = (1U << RFID_CS_PIN);
+    CS_LOW();
     SPI0_Transfer((addr << 1) & 0x7E);
     SPI0_Transfer(val);
-    GPIOC->PSOR = (1U << RFID_CS_PIN);
+    CS_HIGH();
 }
 
 uint8_t ReadReg(uint8_t addr) {
     uint8_t val;
-    GPIOC->PCOR = (1U << RFID_CS_PIN);
+    CS_LOW();
     SPI0_Transfer(((addr << 1) & 0x7E) | 0x80);
     val = SPI0_Transfer(0x00);
-    GPIOC->PSOR = (1U << RFID_CS_PIN);
+    CS_HIGH();
     return val;
 }
 
 // ============================================================================
 // INIT
 // ============================================================================
-void RC522_Init(void) {
-    SPI0_Init_SDK();
-    
-    // IRQ pin unused; FSM uses polled status registers.
-    CLOCK_EnableClock(kCLOCK_PortD);
-    PORT_SetPinMux(PORTD, RFID_IRQ_PIN, kPORT_MuxAsGpio);
-
+/* Hard reset + analog/timer register setup (key cache untouched) */
+static void Chip_Setup(void) {
     // Reset Hardware
-    GPIOC->PCOR = (1U << RFID_RST_PIN); 
+    RST_LOW();
     // Hard delay for reset pulse 
 
-    GPIOC->PSOR = (1U << RFID_RST_PIN); 
+    RST_HIGH();
     for(volatile int i=0; i<100000; i++); 
 
     WriteReg(CommandReg, PCD_RESETPHASE); 
@@ -161,6 +193,31 @@ void RC522_Init(void) {
     if (!(temp & 0x03)) WriteReg(TxControlReg, temp | 0x03);
 }
 
+void RC522_Init(void) {
+    SPI0_Init_SDK();
+    
+    // IRQ pin unused (plain input); FSM uses polled status registers.
+
+    Chip_Setup();
+
+    // Default transport key (FF..FF) until a site key is installed
+    static const uint8_t defaultKey[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    memset(g_key_cache, 0, sizeof(g_key_cache));
+    RFID_SetSiteKey(RFID_DEFAULT_SITE, defaultKey);
+}
+
+/* Power-fail path (ISR safe): NRSTPD low = hard power-down, antenna off */
+void RFID_PowerDown(void) {
+    RST_LOW();
+    g_powered_down = true;
+}
+
+void RFID_PowerUp(void) {
+    Chip_Setup();
+    g_rfidState = RFID_IDLE;
+    g_powered_down = false;
+}
+
 // ============================================================================
 // FSM HELPERS
 // ============================================================================
@@ -176,16 +233,162 @@ void Start_Transceive(uint8_t *data, uint8_t len) {
     WriteReg(BitFramingReg, current | 0x80); // Start Send
 }
 
+/* CRC_A via the RC522 coprocessor. Appends 2 bytes at data[len]. */
+static bool Calc_CRC(uint8_t *data, uint8_t len) {
+    WriteReg(CommandReg, PCD_IDLE);
+    WriteReg(DivIrqReg, DivIrq_CRCIRq);  // Clear CRCIRq
+    WriteReg(FIFOLevelReg, 0x80);
+    for (int i = 0; i < len; i++) WriteReg(FIFODataReg, data[i]);
+    WriteReg(CommandReg, PCD_CALCCRC);
+
+    // Coprocessor needs a few us; each SPI poll costs ~16us at 1MHz
+    for (int i = 0; i < CRC_POLL_LIMIT; i++) {
+        if (ReadReg(DivIrqReg) & DivIrq_CRCIRq) {
+            WriteReg(CommandReg, PCD_IDLE);
+            data[len]     = ReadReg(CRCResultRegL);
+            data[len + 1] = ReadReg(CRCResultRegH);
+            return true;
+        }
+    }
+    WriteReg(CommandReg, PCD_IDLE);
+    return false;
+}
+
+/* Polls the running command. Returns: 0 (Busy), 1 (Done OK), -1 (Error/Timeout) */
+static int Poll_Command(uint8_t waitIrq, uint32_t timeoutMs) {
+    if (IsTimeout(g_rfid_timer, timeoutMs)) return -1;
+    uint8_t n = ReadReg(ComIrqReg);
+    if (n & 0x01) return -1;               // TimerIRq: card did not answer
+    if (!(n & waitIrq)) return 0;
+    if (ReadReg(ErrorReg) & 0x1B) return -1;
+    return 1;
+}
+
+/* Halt card (HLTA + CRC) and drop the Crypto1 session */
+static void Halt_Card(void) {
+    uint8_t buffer[4] = { PCD_HALT, 0, 0, 0 };
+    if (Calc_CRC(buffer, 2)) Start_Transceive(buffer, 4);
+    else Start_Transceive(buffer, 2); // Best effort without CRC
+}
+
+static void End_Crypto(void) {
+    WriteReg(Status2Reg, ReadReg(Status2Reg) & ~Status2_MFCrypto1On);
+}
+
+/* True if the UID is inside an active hold-off window (scan is dropped) */
+static bool Is_Held_Off(const uint8_t *uid) {
+    uint32_t u = ((uint32_t)uid[0] << 24) | ((uint32_t)uid[1] << 16) | ((uint32_t)uid[2] << 8) | uid[3];
+    for (int i = 0; i < RFID_HOLDOFF_SLOTS; i++) {
+        RFID_HoldOff_t *h = &g_holdoff[i];
+        if (h->uid != u || h->duration == 0) continue;
+
+        if (!IsTimeout(h->start, h->duration)) {
+            if (h->suppressed < 0xFFFF) h->suppressed++;
+            return true;
+        }
+        // Window over: one summary line instead of N repeats
+        if (h->suppressed > 0) {
+            LOG(ACCESS, DEBUG, "UID %X: %u scans suppressed\r\n", u, h->suppressed);
+            h->suppressed = 0;
+        }
+        return false;
+    }
+    return false;
+}
+
+/* Publishes the pending card to the application layer */
+static void Report_Card(void) {
+    memcpy(g_last_uid, g_pending_uid, 5);
+    g_last_uid_time = GetTick();
+    LOG(ACCESS, INFO, "Card Scanned: [%02X %02X %02X %02X]\r\n",
+                g_last_uid[0], g_last_uid[1], g_last_uid[2], g_last_uid[3]);
+    g_last_valid_result = 1; // 1 = New Card Present
+}
+
+/* SELECT the pending card (ANTICOLL cascade level 1 + UID + CRC_A) */
+static bool Start_Select(void) {
+    uint8_t sel[9] = { PICC_ANTICOLL, PICC_SELECT_NVB };
+    memcpy(&sel[2], g_pending_uid, 5);
+    if (!Calc_CRC(sel, 7)) return false;
+    Start_Transceive(sel, 9);
+    g_rfidState = RFID_SELECT_SENT;
+    g_rfid_timer = GetTick();
+    return true;
+}
+
+/* Moves g_key_slot to the next cached key. False if no other key is left to try. */
+static bool Next_Key(void) {
+    int used = 0;
+    for (int i = 0; i < RFID_MAX_SITE_KEYS; i++) if (g_key_cache[i].used) used++;
+    if (g_keys_tried >= used) return false;
+
+    for (int i = 1; i <= RFID_MAX_SITE_KEYS; i++) {
+        uint8_t slot = (g_key_slot + i) % RFID_MAX_SITE_KEYS;
+        if (g_key_cache[slot].used) { g_key_slot = slot; return true; }
+    }
+    return false;
+}
+
+/* Aborts the credential pipeline: card still reported by UID only */
+static void Abort_Read(void) {
+    End_Crypto();
+    g_last_credential.valid = false;
+    Report_Card();
+    g_rfidState = RFID_IDLE;
+}
+
+static void Start_Auth(void) {
+    RFID_KeySlot_t *slot = &g_key_cache[g_key_slot];
+    uint8_t buf[12];
+    buf[0] = PICC_AUTHENT1A;
+    buf[1] = RFID_CREDENTIAL_BLOCK;
+    memcpy(&buf[2], slot->key, 6);
+    memcpy(&buf[8], g_pending_uid, 4);
+
+    WriteReg(CommandReg, PCD_IDLE);
+    WriteReg(ComIrqReg, 0x7F);
+    WriteReg(FIFOLevelReg, 0x80);
+    for (int i = 0; i < 12; i++) WriteReg(FIFODataReg, buf[i]);
+    WriteReg(CommandReg, PCD_AUTHENT);
+}
+
+/*
+ * Credential Block Layout (16 bytes, big endian):
+ *  [0..1]  Site Code
+ *  [2..5]  User ID
+ *  [6..9]  Valid Until (0 = no expiry)
+ *  [10..14] Reserved
+ *  [15]    XOR Checksum of bytes 0..14
+ * Site and expiry are judged by the application (Check_RFID).
+ */
+static bool Parse_Credential(const uint8_t *blk, uint16_t keySite) {
+    uint8_t chk = 0;
+    for (int i = 0; i < 15; i++) chk ^= blk[i];
+    if (chk != blk[15]) return false;
+
+    g_last_credential.site_code = (uint16_t)((blk[0] << 8) | blk[1]);
+    g_last_credential.user_id = ((uint32_t)blk[2] << 24) | ((uint32_t)blk[3] << 16) | ((uint32_t)blk[4] << 8) | blk[5];
+    g_last_credential.valid_until = ((uint32_t)blk[6] << 24) | ((uint32_t)blk[7] << 16) | ((uint32_t)blk[8] << 8) | blk[9];
+    g_last_credential.key_site = keySite;
+    return true;
+}
+
 // ============================================================================
 // FSM TICK (Called from Main Loop)
 // ============================================================================
 void RFID_Tick(void) {
+    if (g_powered_down) {
+        Supervisor_CheckIn(SUP_TASK_RFID); // Idle on purpose
+        return;
+    }
     uint32_t now = GetTick();
 
     switch(g_rfidState) {
         
         // --- 1. IDLE: Check if time to scan ---
         case RFID_IDLE:
+             Supervisor_CheckIn(SUP_TASK_RFID); // Every transaction ends here
+
              // Clear last UID after 500ms of inactivity to allow re-scan
              if (IsTimeout(g_last_uid_time, 500)) {
                  memset(g_last_uid, 0, 5); 
@@ -193,6 +396,7 @@ void RFID_Tick(void) {
 
             if (IsTimeout(g_next_scan_time, 100)) { // Scan every 100ms
                 g_next_scan_time = now;
+                End_Crypto(); // Plain frames only for REQA
                 
                 // Start Request (REQA)
                 WriteReg(BitFramingReg, 0x07); // 7 bits
@@ -252,31 +456,110 @@ void RFID_Tick(void) {
                              bool same = true;
                              for(i=0; i<4; i++) if (uid[i] != g_last_uid[i]) same = false;
                              
-                             if (!same) {
-                                 // NEW Card detected!
+                             if (!same && Is_Held_Off(uid)) {
+                                 // Recently denied card: debounce silently, no report
                                  memcpy(g_last_uid, uid, 5);
                                  g_last_uid_time = GetTick();
-                                 
-                                 UART_Printf("[ACCESS] Card Scanned: [%02X %02X %02X %02X]\r\n", uid[0], uid[1], uid[2], uid[3]);
-                                 
-                                 
-                                 // We just report "Card Detected"
-                                 g_last_valid_result = 1; // 1 = New Card Present
+                             }
+                             else if (!same) {
+                                 // NEW Card detected! Pipeline SELECT -> AUTH -> READ
+                                 memcpy(g_pending_uid, uid, 5);
+                                 g_keys_tried = 0;
+                                 if (Start_Select()) break;
+                                 Abort_Read();
                              }
                              else {
                                  // Card still present; update timestamp 
                              }
                              
                              // Halt Card (Send Halt Command)
-                             uint8_t buffer[4] = { PCD_HALT, 0, 0, 0 }; 
-                             Start_Transceive(buffer, 2); // Send Halt
-                             // No CRC needed for Halt, just best effort.
+                             Halt_Card();
                          }
                      }
                      g_rfidState = RFID_IDLE; // Done
                  }
             }
             break;
+
+        // --- 4a. WAKE SENT: ATQA, then SELECT the same UID again ---
+        case RFID_WAKE_SENT:
+            {
+                int r = Poll_Command(0x30, RFID_STAGE_TIMEOUT_MS);
+                if (r < 0) { Abort_Read(); break; }
+                if (r == 0) break;
+
+                WriteReg(BitFramingReg, 0x00);
+                if (!Start_Select()) Abort_Read();
+            }
+            break;
+
+        // --- 4. SELECT SENT: Wait for SAK (1 byte + CRC) ---
+        case RFID_SELECT_SENT:
+            {
+                int r = Poll_Command(0x30, RFID_STAGE_TIMEOUT_MS);
+                if (r < 0) { Abort_Read(); break; }
+                if (r == 0) break;
+
+                uint8_t sak = ReadReg(FIFODataReg);
+                if (!(sak & 0x08)) { Abort_Read(); break; } // Not MIFARE Classic
+
+                Start_Auth();
+                g_rfidState = RFID_AUTH_SENT;
+                g_rfid_timer = GetTick();
+            }
+            break;
+
+        // --- 5. AUTH SENT: Wait for Crypto1 session ---
+        case RFID_AUTH_SENT:
+            {
+                int r = Poll_Command(0x10, RFID_AUTH_TIMEOUT_MS); // IdleIRq
+                if (r == 0) break;
+                if (r < 0 || !(ReadReg(Status2Reg) & Status2_MFCrypto1On)) {
+                    // Wrong key: a failed MFAuthent drops the card out of ACTIVE,
+                    // so wake it (WUPA) and SELECT it again for the next cached key
+                    End_Crypto();
+                    g_keys_tried++;
+                    if (!Next_Key()) { Abort_Read(); break; }
+                    WriteReg(BitFramingReg, 0x07); // 7 bits
+                    uint8_t wupa = PICC_REQALL;
+                    Start_Transceive(&wupa, 1);
+                    g_rfidState = RFID_WAKE_SENT;
+                    g_rfid_timer = GetTick();
+                    break;
+                }
+
+                uint8_t rd[4] = { PICC_READ, RFID_CREDENTIAL_BLOCK };
+                if (!Calc_CRC(rd, 2)) { Abort_Read(); break; }
+                Start_Transceive(rd, 4);
+                g_rfidState = RFID_READ_SENT;
+                g_rfid_timer = GetTick();
+            }
+            break;
+
+        // --- 6. READ SENT: 16 Data Bytes + CRC_A ---
+        case RFID_READ_SENT:
+            {
+                int r = Poll_Command(0x30, RFID_STAGE_TIMEOUT_MS);
+                if (r < 0) { Abort_Read(); break; }
+                if (r == 0) break;
+
+                uint8_t blk[18];
+                uint8_t nn = ReadReg(FIFOLevelReg);
+                if (nn != 18) { Abort_Read(); break; }
+                for (int i = 0; i < 18; i++) blk[i] = ReadReg(FIFODataReg);
+
+                // Verify CRC_A of the response with the coprocessor
+                uint8_t chk[18];
+                memcpy(chk, blk, 16);
+                if (!Calc_CRC(chk, 16) || chk[16] != blk[16] || chk[17] != blk[17]) { Abort_Read(); break; }
+
+                g_last_credential.valid = Parse_Credential(blk, g_key_cache[g_key_slot].site_code);
+                Halt_Card();
+                End_Crypto();
+                Report_Card();
+                g_rfidState = RFID_IDLE;
+            }
+            break;
             
         case RFID_HALT_SENT:
             g_rfidState = RFID_IDLE;
@@ -298,6 +581,64 @@ uint32_t RFID_GetLastUID(void) {
     return (uint32_t)((g_last_uid[0] << 24) | (g_last_uid[1] << 16) | (g_last_uid[2] << 8) | g_last_uid[3]);
 }
 
+#if SELFTEST_ENABLE
+/* Self-Test: a UID arriving as if from ANTICOLL (same debounce/hold-off, no SELECT) */
+void RFID_InjectUid(uint32_t uidValue) {
+    uint8_t uid[5] = { (uint8_t)(uidValue >> 24), (uint8_t)(uidValue >> 16), (uint8_t)(uidValue >> 8), (uint8_t)uidValue, 0 };
+    uid[4] = uid[0] ^ uid[1] ^ uid[2] ^ uid[3];
+
+    if (memcmp(uid, g_last_uid, 4) == 0) return;
+    if (Is_Held_Off(uid)) {
+        memcpy(g_last_uid, uid, 5);
+        g_last_uid_time = GetTick();
+        return;
+    }
+    memcpy(g_pending_uid, uid, 5);
+    g_last_credential.valid = false;
+    Report_Card();
+}
+#endif
+
 int RFID_CheckScan(void) {
     return RFID_GetLastScanResult();
 }
+
+bool RFID_GetLastCredential(RFID_Credential_t* out) {
+    if (out == NULL || !g_last_credential.valid) return false;
+    *out = g_last_credential;
+    return true;
+}
+
+void RFID_HoldOff(uint32_t uid, uint32_t durationMs) {
+    RFID_HoldOff_t *slot = &g_holdoff[0];
+
+    // Reuse this UID's slot (escalate), else evict the oldest window
+    for (int i = 0; i < RFID_HOLDOFF_SLOTS; i++) {
+        if (g_holdoff[i].uid == uid && g_holdoff[i].duration != 0) {
+            slot = &g_holdoff[i];
+            // Escalate only if it came back soon after the last window
+            if (!IsTimeout(slot->start, slot->duration + RFID_HOLDOFF_MAX_MS)) durationMs = slot->duration * 2;
+            break;
+        }
+        if ((GetTick() - g_holdoff[i].start) > (GetTick() - slot->start)) slot = &g_holdoff[i];
+    }
+    if (durationMs > RFID_HOLDOFF_MAX_MS) durationMs = RFID_HOLDOFF_MAX_MS;
+
+    slot->uid = uid;
+    slot->start = GetTick();
+    slot->duration = durationMs;
+}
+
+bool RFID_SetSiteKey(uint16_t siteCode, const uint8_t key[6]) {
+    int freeSlot = -1;
+    for (int i = 0; i < RFID_MAX_SITE_KEYS; i++) {
+        if (g_key_cache[i].used && g_key_cache[i].site_code == siteCode) { freeSlot = i; break; }
+        if (!g_key_cache[i].used && freeSlot < 0) freeSlot = i;
+    }
+    if (freeSlot < 0) return false;
+
+    g_key_cache[freeSlot].site_code = siteCode;
+    memcpy(g_key_cache[freeSlot].key, key, 6);
+    g_key_cache[freeSlot].used = true;
+    return true;
+}
@@ -8,10 +8,30 @@
 #define RFID_DRIVER_H
 
 #include <stdint.h>
+#include <stdbool.h>
+
+// Credential Block (Sector 1, Block 0 on MIFARE Classic 1K)
+#define RFID_CREDENTIAL_BLOCK 4
+#define RFID_MAX_SITE_KEYS    4
+#define RFID_DEFAULT_SITE     0x0001
+
+// Data read from the card's credential block
+typedef struct {
+    uint16_t site_code;
+    uint32_t user_id;
+    uint32_t valid_until;  // Unix time, 0 = No Expiry
+    uint16_t key_site;     // Site whose cached key opened the sector
+    bool valid;            // Auth + Read + Checksum OK
+} RFID_Credential_t;
 
 // Initialize RFID (SPI, Pins, Chip)
 void RC522_Init(void);
 
+// Power-Fail Load Shedding: hold the chip in hard power-down (ISR safe)
+void RFID_PowerDown(void);
+// Leave power-down and re-run chip setup (keys are kept)
+void RFID_PowerUp(void);
+
 // Non-blocking Tick for FSM (Call every loop)
 void RFID_Tick(void);
 
@@ -21,9 +41,26 @@ int RFID_GetLastScanResult(void);
 // Returns status: 1 (New Card), 0 (None)
 int RFID_CheckScan(void);
 
+// Self-Test: report a UID through the debounce/hold-off path (no RF exchange)
+void RFID_InjectUid(uint32_t uidValue);
+
 // Returns the last scanned 4-byte UID (0x11223344)
 uint32_t RFID_GetLastUID(void); // Alias
 
+// Copies the credential block of the last scanned card (every cached site key is tried).
+// Returns false if the card had no readable credential (UID-only card).
+bool RFID_GetLastCredential(RFID_Credential_t* out);
+
+// Flood Suppression: ignore a (denied) UID for durationMs.
+// Repeated hold-offs of the same UID double the window up to RFID_HOLDOFF_MAX_MS.
+#define RFID_HOLDOFF_SLOTS   4
+#define RFID_HOLDOFF_MAX_MS  30000U
+void RFID_HoldOff(uint32_t uid, uint32_t durationMs);
+
+// Install/replace a MIFARE Key A for a site in the RAM key cache.
+// Returns false if the cache is full.
+bool RFID_SetSiteKey(uint16_t siteCode, const uint8_t key[6]);
+
 uint8_t ReadReg(uint8_t addr);
 
 #define PICC_REQIDL    0x26
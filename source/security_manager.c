@@ -4,13 +4,17 @@
  * [CORE BUSINESS LOGIC]
  * Handles State Machine (Armed, Disarmed, Triggered), Auth Validation,
  * and Sensor Monitoring.
+ * One FSM instance per partition (door); each partition reaches its
+ * keypad/reader/zone/lock only through its PartitionIO_t binding row.
  */
 
 #include "security_manager.h"
 #include "fsl_debug_console.h"
-#include "uart_driver.h" // For Bluetooth Logs
+#include "log_mgr.h" // For Bluetooth Logs
 #include "MKL25Z4.h"
 #include <ctype.h>
+#include <string.h>
+#include <stddef.h>
 
 // Drivers
 #include "pir_driver.h"
@@ -20,10 +24,20 @@
 #include "output_mgr.h"
 #include "timer_driver.h"
 #include "storage_mgr.h"
+#include "wall_clock.h"
+#include "policy_engine.h"
+#include "glassbreak.h"
+#include "tamper_mgr.h"
+#include "accel_driver.h"
+#include "power_mgr.h"
+#include "supervisor.h"
+#include "audit_log.h"
+#include "selftest.h"
 
 // ============================================================================
 // DEFINITIONS & CONSTANTS
 // ============================================================================
+// Order is part of the policy bytecode ABI (POLICY_STATE_* in policy_engine.h)
 typedef enum {
     STATE_ARMED,        // System Active, Monitoring Sensors
     STATE_ENTRY_DELAY,  // Grace Period (5s) for Auth
@@ -47,18 +61,123 @@ typedef enum {
 #define AUTH_VALID          1       // Credential accepted
 #define AUTH_INVALID       -1       // Credential rejected
 #define AUTH_NONE           0       // No credential presented
+#define AUTH_DENIED        -2       // Enrolled, but refused by door/schedule/policy (no lockout)
+
+#define DENY_HOLDOFF_MS     3000U   // Ignore a denied card this long (doubles on repeat)
+#define ALL_CARD_GROUPS     0xFFU   // Partition admits every schedule group
+#define STUCK_MARGIN_MS     2000U   // Timed state overstay before the supervisor is starved
 
 // ============================================================================
-// STATE VARIABLES
+// PARTITION BINDINGS
+// ============================================================================
+// Inputs follow the driver conventions: check_pin like Keypad_CheckPassword
+// (1 ok, -1 bad, 2 wakeup key, 0 none). NULL = input not fitted.
+typedef struct {
+    const char* name;
+    uint8_t card_groups;               // Schedule groups admitted here (bit n = group n)
+    int (*check_pin)(void);
+    bool (*card_scanned)(void);        // New card presented
+    uint32_t (*card_uid)(void);        // UID of that card
+    bool (*card_credential)(RFID_Credential_t* out); // Its on-card credential (false = UID only)
+    bool (*zone_triggered)(void);      // Interior zone (starts entry delay)
+    bool (*perimeter_triggered)(void); // Instant zone (skips entry delay)
+    void (*door_open)(void);
+    void (*door_close)(void);
+    void (*flush_inputs)(void);        // Drop stale keys/cards/motion
+} PartitionIO_t;
+
+typedef struct {
+    const PartitionIO_t* io;
+    SystemState_t state;
+    uint32_t stateEntryTime;
+    uint32_t lastAlarmToggle;
+    int alarmVolume;
+    uint8_t failedAttempts;
+    bool doorUnlockedMsg;
+    bool waitingForAutoLock;
+    bool blinkPhase;
+    bool authGranted;                  // Set only by a valid auth, cleared on lock
+
+    // Auth Factor Memory (multi-factor policy windows)
+    uint32_t eventCardUid;             // Card of the current event
+    uint8_t eventCardGroup;
+    uint32_t lastPinOkTime;
+    uint32_t lastCardOkTime;
+    uint32_t lastCardOkUid;
+} Partition_t;
+
+// --- Door 1: onboard keypad, RC522, PIR, servo ---
+static bool Door1_CardScanned(void) {
+    return RFID_CheckScan() > 0;
+}
+
+static void Door1_Flush(void) {
+    PIR_CheckTriggered();
+    RFID_GetLastScanResult();
+    Keypad_GetKeyNonBlocking();
+}
+
+#if SELFTEST_ENABLE
+/* Glass break plus the self-test's injected perimeter alarm */
+static bool Door1_Perimeter(void) {
+    bool hit = Selftest_CheckPerimeter();
+#if GLASSBREAK_ENABLE
+    if (Glassbreak_CheckTriggered()) hit = true;
+#endif
+    return hit;
+}
+#define DOOR1_PERIMETER Door1_Perimeter
+#elif GLASSBREAK_ENABLE
+#define DOOR1_PERIMETER Glassbreak_CheckTriggered
+#else
+#define DOOR1_PERIMETER NULL
+#endif
+
+// Add a row per door (2-4 fit in RAM/CPU easily); drivers stay shared services.
+// A door with its own keypad wraps Keypad_CheckPin(KEYPAD_<name>) (board_pins.h).
+static const PartitionIO_t g_partitionIO[] = {
+    { "Door 1", ALL_CARD_GROUPS, Keypad_CheckPassword, Door1_CardScanned, RFID_GetLastUID,
+      RFID_GetLastCredential, PIR_CheckTriggered, DOOR1_PERIMETER, Servo_Open, Servo_Close, Door1_Flush },
+};
+
+#define NUM_PARTITIONS (sizeof(g_partitionIO) / sizeof(g_partitionIO[0]))
+
 // ============================================================================
-static SystemState_t currentState = STATE_TRIGGERED;
-static uint32_t stateEntryTime = 0;   
-static uint32_t lastAlarmToggle = 0; 
-static int alarmVolume = INITIAL_VOLUME;
-static uint8_t failedAttempts = 0;
+// STATE CHECKPOINT (.noinit survives resets; journal survives power loss)
+// ============================================================================
+#define CHECKPOINT_MAGIC       0xC4EC9017U
+#define CHECKPOINT_REFRESH_MS  1000U    // Keeps timer ages fresh between transitions
+#define FLASH_BACKUP_MIN_MS    10000U   // Journal rate limit for non-alarm states
+#define PACK_BITS              4        // Journal: 4 bits of state per partition
+
+typedef struct {
+    uint8_t state;
+    uint8_t failedAttempts;
+    uint8_t alarmVolume;
+    uint8_t reserved;
+    uint32_t stateAge;                 // ms spent in the state at checkpoint time
+} PartitionCheckpoint_t;
 
-static bool doorUnlockedMsg = false;
-static bool waitingForAutoLock = false;
+typedef struct {
+    uint32_t magic;
+    PartitionCheckpoint_t part[NUM_PARTITIONS];
+    uint32_t crc;                      // CRC-32 over everything above
+} Checkpoint_t;
+
+typedef char Pack_Fits_Check[(NUM_PARTITIONS * PACK_BITS <= 16) ? 1 : -1];
+
+// Not touched by the startup code: still valid after COP/pin/lockup resets
+static Checkpoint_t g_checkpoint __attribute__((section(".noinit")));
+
+// ============================================================================
+// STATE VARIABLES
+// ============================================================================
+static Partition_t g_partitions[NUM_PARTITIONS];
+static Partition_t* g_sirenOwner = NULL; // Partition driving the shared buzzer/LED
+static bool g_skipStartupDelay = false;  // Resumed into an alarm: no sensor settle time
+static uint32_t g_lastCheckpoint = 0;
+static uint32_t g_lastFlashBackup = 0;
+static uint16_t g_flashedPack = 0xFFFFU; // Packed state last written to the journal
 
 // Persistent Configuration Copy
 // Persistent Configuration Pointer
@@ -68,282 +187,575 @@ static bool waitingForAutoLock = false;
 // INTERNAL HELPERS
 // ============================================================================
 
+/* Shared annunciator: LOCKED beats TRIGGERED beats EXIT_DELAY, lowest index wins ties */
+static void Update_Siren_Owner(void) {
+    static const uint8_t rank[] = {
+        [STATE_EXIT_DELAY] = 1, [STATE_TRIGGERED] = 2, [STATE_LOCKED] = 3,
+    };
+    uint8_t best = 0;
+    g_sirenOwner = NULL;
+    for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+        if (rank[g_partitions[i].state] > best) {
+            best = rank[g_partitions[i].state];
+            g_sirenOwner = &g_partitions[i];
+        }
+    }
+}
+
+static bool Owns_Siren(const Partition_t* p) {
+    return (g_sirenOwner == NULL || g_sirenOwner == p);
+}
+
+static uint8_t Door_Index(const Partition_t* p) {
+    return (uint8_t)(p - g_partitions);
+}
+
+/* Every way into TRIGGERED locks the door: a board-wide tamper trip can
+ * arrive while a partition is DISARMED with its unlock window open */
+static void Enter_Triggered(Partition_t* p) {
+    Audit_Record(AUDIT_ALARM, AUDIT_NO_UID, Door_Index(p));
+    p->io->door_close();
+    p->authGranted = false;
+    p->waitingForAutoLock = false;
+    p->doorUnlockedMsg = false;
+    p->alarmVolume = INITIAL_VOLUME;
+    p->state = STATE_TRIGGERED;
+    p->lastAlarmToggle = GetTick();
+}
+
+static void Enter_Disarmed(Partition_t* p) {
+    p->authGranted = true;
+    p->state = STATE_DISARMED;
+    p->stateEntryTime = GetTick();
+    p->doorUnlockedMsg = false;
+    p->waitingForAutoLock = false;
+    p->failedAttempts = 0;
+}
+
+static int Check_Pin(Partition_t* p) {
+    int kp = p->io->check_pin ? p->io->check_pin() : 0;
+    if (kp == 1) Audit_Record(AUDIT_PIN_OK, AUDIT_NO_UID, Door_Index(p));
+    else if (kp == -1) Audit_Record(AUDIT_PIN_BAD, AUDIT_NO_UID, Door_Index(p));
+    return kp;
+}
+
+/* On-card credential: a site that does not match the key that opened it is a
+ * forged/cloned block (counts toward lockout); an expired card is only denied.
+ * Returns AUTH_NONE if the credential does not decide. */
+static int Check_Credential(Partition_t* p, const RFID_Credential_t* cred, uint32_t uid) {
+    LOG(ACCESS, DEBUG, "Card Data: Site %u, User %u\r\n", cred->site_code, cred->user_id);
+
+    if (cred->site_code != cred->key_site) {
+        LOG(ACCESS, WARN, "%s: RFID Foreign Site %u (UID: %x)\r\n", p->io->name, cred->site_code, uid);
+        RFID_HoldOff(uid, DENY_HOLDOFF_MS);
+        Audit_Record(AUDIT_CARD_DENIED, uid, Door_Index(p));
+        return AUTH_INVALID;
+    }
+    if (cred->valid_until != 0) {
+        // Fail closed: expiring cards wait for the clock to be set
+        uint32_t now = WallClock_GetTime();
+        if (now == 0 || now > cred->valid_until) {
+            LOG(ACCESS, WARN, "%s: RFID %s (UID: %x)\r\n", p->io->name,
+                (now == 0) ? "Expiry Unchecked, Clock Not Set" : "Expired", uid);
+            RFID_HoldOff(uid, DENY_HOLDOFF_MS);
+            Audit_Record(AUDIT_CARD_DENIED, uid, Door_Index(p));
+            return AUTH_DENIED;
+        }
+    }
+    return AUTH_NONE;
+}
+
+/* Validates a freshly scanned card against the authorized list */
+static int Check_RFID(Partition_t* p) {
+    if (p->io->card_scanned == NULL || !p->io->card_scanned()) return AUTH_NONE;
+
+    uint32_t scannedUid = p->io->card_uid();
+
+    RFID_Credential_t cred;
+    if (p->io->card_credential != NULL && p->io->card_credential(&cred)) {
+        int verdict = Check_Credential(p, &cred, scannedUid);
+        if (verdict != AUTH_NONE) return verdict;
+    }
+
+    // Bloom-filtered lookup of the authorized list
+    int slot = Storage_FindRFID(scannedUid);
+    if (slot >= 0) {
+         // Weekly schedule: constant-time bit test on the cached hour of week
+         SecurityConfig_t* liveConfig = Storage_GetConfig();
+         uint8_t group = liveConfig->uid_schedule[slot];
+         if (!(p->io->card_groups & (1U << group))) {
+             LOG(ACCESS, WARN, "%s: RFID Not Enrolled Here (UID: %x)\r\n", p->io->name, scannedUid);
+             RFID_HoldOff(scannedUid, DENY_HOLDOFF_MS);
+             Audit_Record(AUDIT_CARD_DENIED, scannedUid, Door_Index(p));
+             return AUTH_DENIED;
+         }
+         if (Storage_IsScheduleOpen(liveConfig, group, WallClock_GetWeekSlot())) {
+             p->eventCardUid = scannedUid;
+             p->eventCardGroup = group;
+             LOG(ACCESS, INFO, "%s: RFID Authorized (UID: %x)\r\n", p->io->name, scannedUid);
+             Audit_Record(AUDIT_CARD_OK, scannedUid, Door_Index(p));
+             return AUTH_VALID;
+         }
+         LOG(ACCESS, WARN, "%s: RFID Outside Schedule %d (UID: %x)\r\n", p->io->name, group, scannedUid);
+         RFID_HoldOff(scannedUid, DENY_HOLDOFF_MS);
+         Audit_Record(AUDIT_CARD_DENIED, scannedUid, Door_Index(p));
+         return AUTH_DENIED;
+    }
+    LOG(ACCESS, WARN, "%s: RFID DENIED (UID: %x)\r\n", p->io->name, scannedUid);
+    RFID_HoldOff(scannedUid, DENY_HOLDOFF_MS); // Flood Suppression
+    Audit_Record(AUDIT_CARD_DENIED, scannedUid, Door_Index(p));
+    return AUTH_INVALID;
+}
+
+/* Combines factors of one event; a loaded policy decides over valid factors.
+ * Only a bad PIN or an unknown card counts toward lockout (AUTH_INVALID). */
+static int Resolve_Auth(Partition_t* p, int kp, int rf_auth) {
+    bool pinOk = (kp == 1);
+    bool cardOk = (rf_auth == AUTH_VALID);
+
+    if (!pinOk && !cardOk) {
+        if (kp == -1 || rf_auth == AUTH_INVALID) return AUTH_INVALID;
+        return (rf_auth == AUTH_DENIED) ? AUTH_DENIED : AUTH_NONE;
+    }
+
+    int result = AUTH_VALID;
+    uint32_t now = GetTick();
+    uint16_t len;
+    const uint8_t* policy = Storage_GetPolicy(&len);
+
+    if (policy != NULL) {
+        PolicyCtx_t ctx = {
+            .pin_ok = pinOk,
+            .card_ok = cardOk,
+            .card_uid = cardOk ? p->eventCardUid : 0,
+            .card_group = p->eventCardGroup,
+            .state = (uint8_t)p->state,
+            .now = now,
+            .last_pin_time = p->lastPinOkTime,
+            .last_card_time = p->lastCardOkTime,
+            .last_card_uid = p->lastCardOkUid,
+        };
+        uint8_t verdict = Policy_Evaluate(policy, len, &ctx);
+        if (verdict == POLICY_DENY) {
+            LOG(ACCESS, WARN, "%s: Policy DENIED.\r\n", p->io->name);
+            result = AUTH_DENIED;
+        } else if (verdict == POLICY_PENDING) {
+            LOG(ACCESS, INFO, "Policy: Next Factor Required.\r\n");
+            result = AUTH_NONE;
+        }
+    }
+
+    // Remember factors for the next event; consumed on success
+    if (result == AUTH_VALID) {
+        p->lastPinOkTime = p->lastCardOkTime = p->lastCardOkUid = 0;
+    } else {
+        if (pinOk) p->lastPinOkTime = now;
+        if (cardOk) { p->lastCardOkTime = now; p->lastCardOkUid = p->eventCardUid; }
+    }
+    return result;
+}
+
 /* Checks both Keypad and RFID for valid credentials */
-static int Check_Auth(void) {
+static int Check_Auth(Partition_t* p) {
     // 1. Keypad Check
-    int kp = Keypad_CheckPassword();
+    int kp = Check_Pin(p);
     
     // 2. RFID Check (Dynamic from Flash)
-    int rf_status = RFID_CheckScan(); // 1=Card, 2=Tag (Legacy), -1=Invalid (Not used), 0=None
-    int rf_auth = AUTH_NONE;
+    int rf_auth = Check_RFID(p);
     
-    if (rf_status > 0) { // Card Detected
-        uint32_t scannedUid = RFID_GetLastUID();
-        
-        // Iterate through authorized list
-        bool found = false;
-        SecurityConfig_t* liveConfig = Storage_GetConfig();
-        for (int i = 0; i < MAX_STORED_IDS; i++) {
-             if (liveConfig->authorized_uids[i] != 0 && liveConfig->authorized_uids[i] == scannedUid) {
-                 found = true;
-                 break;
-             }
+    return Resolve_Auth(p, kp, rf_auth);
+}
+
+/* Perimeter zones that skip the entry delay (glass break) */
+static bool Check_Perimeter(Partition_t* p) {
+    if (p->io->perimeter_triggered && p->io->perimeter_triggered()) {
+        LOG(ALARM, ERROR, "%s: PERIMETER ZONE! ALARM TRIGGERED!\r\n", p->io->name);
+        Enter_Triggered(p);
+        return true;
+    }
+    return false;
+}
+
+/* 24h tamper zone & supply supervision (board-wide, active in every state) */
+static void Check_Tamper(void) {
+#if TAMPER_ENABLE
+    TamperEvent_t ev;
+    while (Tamper_GetEvent(&ev)) {
+        switch (ev.type) {
+            case TAMPER_EV_OPEN:
+            case TAMPER_EV_SHORT:
+                LOG(ALARM, ERROR, "TAMPER LOOP %c %s!\r\n", 'A' + ev.loop,
+                                 ev.type == TAMPER_EV_OPEN ? "OPEN" : "SHORTED");
+                for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+                    Partition_t* p = &g_partitions[i];
+                    if (p->state != STATE_TRIGGERED && p->state != STATE_LOCKED) Enter_Triggered(p);
+                }
+                break;
+            case TAMPER_EV_RESTORED:
+                LOG(ALARM, WARN, "Tamper Loop %c Restored.\r\n", 'A' + ev.loop);
+                break;
+            case TAMPER_EV_SUPPLY_LOW:
+                LOG(ALARM, ERROR, "SUPPLY LOW: %d mV\r\n", ev.value);
+                break;
+            case TAMPER_EV_SUPPLY_OK:
+                LOG(SYSTEM, WARN, "Supply OK: %d mV\r\n", ev.value);
+                break;
+            default:
+                break;
         }
-        
-        if (found) {
-             UART_Printf("[ACCESS] RFID Authorized (UID: %x)\r\n", scannedUid);
-             rf_auth = AUTH_VALID;
-        } else {
-             UART_Printf("[ACCESS] RFID DENIED (UID: %x)\r\n", scannedUid);
-             rf_auth = AUTH_INVALID;
+    }
+#endif
+}
+
+/* Enclosure tamper: alarms partitions that are armed or in a delay (DISARMED = maintenance) */
+static void Check_Enclosure(void) {
+#if ACCEL_ENABLE
+    AccelClass_t cls = Accel_CheckEvent();
+    if (cls == ACCEL_NONE) return;
+
+    if (cls == ACCEL_AMBIENT) {
+        LOG(SENSOR, DEBUG, "Ambient vibration ignored.\r\n");
+        return;
+    }
+
+    LOG(ALARM, ERROR, "ENCLOSURE %s!\r\n", cls == ACCEL_TAMPER_MOVED ? "MOVED" : "FORCED");
+    for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+        Partition_t* p = &g_partitions[i];
+        if (p->state == STATE_ARMED || p->state == STATE_ENTRY_DELAY || p->state == STATE_EXIT_DELAY) {
+            Enter_Triggered(p);
         }
     }
-    
-    if (kp == 1 || rf_auth == AUTH_VALID) return AUTH_VALID;
-    if (kp == -1 || rf_auth == AUTH_INVALID) return AUTH_INVALID;
-    return AUTH_NONE;
+#endif
+}
+
+/* Lockout: door shut, panic siren (LOCKED always outranks other partitions) */
+static void Enter_Locked(Partition_t* p) {
+    p->io->door_close();
+    p->state = STATE_LOCKED;
+    p->stateEntryTime = GetTick();
+    p->lastAlarmToggle = GetTick();
+    p->alarmVolume = MAX_VOLUME;
+    Buzzer_On(2000, p->alarmVolume); // Start High Pitch
+    LED_Alarm_On();
 }
 
 /* Manages Brute Force logic */
-static void Check_Brute_Force(void) {
-    failedAttempts++;
-    UART_Printf("\r\n[SECURITY] Invalid Auth! Attempts: %d/%d\r\n", failedAttempts, BRUTE_FORCE_LIMIT);
+static void Check_Brute_Force(Partition_t* p) {
+    p->failedAttempts++;
+    LOG(ALARM, WARN, "%s: Invalid Auth! Attempts: %d/%d\r\n", p->io->name, p->failedAttempts, BRUTE_FORCE_LIMIT);
     
-    if (failedAttempts >= BRUTE_FORCE_LIMIT) {
-        UART_Printf("\r\n[SECURITY] BRUTE FORCE DETECTED! SYSTEM LOCKED.\r\n");
-        currentState = STATE_LOCKED;
-        stateEntryTime = GetTick();
-        
-        // Panic Mode (Siren)
-        alarmVolume = MAX_VOLUME;
-        Buzzer_On(2000, alarmVolume); // Start High Pitch
-        LED_Alarm_On(); 
+    if (p->failedAttempts >= BRUTE_FORCE_LIMIT) {
+        LOG(ALARM, ERROR, "%s: BRUTE FORCE DETECTED! SYSTEM LOCKED.\r\n", p->io->name);
+        Enter_Locked(p);
     }
 }
 
-// ============================================================================
+/* Bitwise CRC-32 (checkpoint is ~30 bytes, no table needed) */
+static uint32_t Crc32(const uint8_t* data, uint32_t len) {
+    uint32_t crc = 0xFFFFFFFFU;
+    while (len--) {
+        crc ^= *data++;
+        for (uint8_t b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xEDB88320U & -(crc & 1U));
+    }
+    return ~crc;
+}
 
-// ======================================
-// PUBLIC API
-// ======================================
-void Security_Init(void) {
-    // Clear Sensors before Arming
-    PIR_CheckTriggered();       // Clear stale motion
-    RFID_GetLastScanResult();   // Clear stale cards
-    Keypad_GetKeyNonBlocking(); // Clear stale keys
-    
-    currentState = STATE_ARMED; 
-    Servo_Close(); 
-    stateEntryTime = GetTick(); 
-    UART_Printf("Security Manager Initialized. State: ARMED\r\n");
+static void Checkpoint_Save(void) {
+    uint32_t now = GetTick();
+    g_checkpoint.magic = CHECKPOINT_MAGIC;
+    for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+        PartitionCheckpoint_t* c = &g_checkpoint.part[i];
+        c->state = (uint8_t)g_partitions[i].state;
+        c->failedAttempts = g_partitions[i].failedAttempts;
+        c->alarmVolume = (uint8_t)g_partitions[i].alarmVolume;
+        c->reserved = 0;
+        c->stateAge = now - g_partitions[i].stateEntryTime;
+    }
+    g_checkpoint.crc = Crc32((const uint8_t*)&g_checkpoint, offsetof(Checkpoint_t, crc));
+    g_lastCheckpoint = now;
 }
 
-bool Security_CheckPassword(char* inputPin) {
-    if (strcmp(inputPin, Storage_GetConfig()->door_pin) == 0) {
-        UART_Printf("[ACCESS] Keypad PIN Accepted.\r\n");
-        return true;
+static bool Checkpoint_IsValid(void) {
+    return (g_checkpoint.magic == CHECKPOINT_MAGIC &&
+            g_checkpoint.crc == Crc32((const uint8_t*)&g_checkpoint, offsetof(Checkpoint_t, crc)));
+}
+
+/* Time a state may last before the partition counts as stuck (0 = untimed) */
+static uint32_t State_Limit(SystemState_t state) {
+    switch (state) {
+        case STATE_ENTRY_DELAY: return ENTRY_DELAY_MS;
+        case STATE_EXIT_DELAY:  return EXIT_DELAY_MS;
+        case STATE_LOCKED:      return LOCKOUT_TIME_MS;
+        case STATE_DISARMED:    return DISARM_WINDOW_MS;
+        default:                return 0; // ARMED / TRIGGERED may last forever
     }
-    UART_Printf("[ACCESS] Keypad PIN Rejected.\r\n");
-    return false;
 }
 
-void Security_SetPassword(const char* newPassword) {
-    if (newPassword == NULL) return;
-    
-    // 1. Length Check
-    size_t len = strlen(newPassword);
-    if (len != 4) {
-        UART_Printf("\r\n[ADMIN ] ERR: PIN must be EXACTLY 4 characters.\r\n");
-        return;
+/* Puts a partition back into a saved state without re-running entry actions */
+static void Resume_State(Partition_t* p, SystemState_t state, uint32_t age) {
+    uint32_t now = GetTick();
+    p->state = state;
+    p->stateEntryTime = now - age; // Timers continue; a reset never extends a delay
+    p->lastAlarmToggle = now;
+
+    switch (state) {
+        case STATE_LOCKED:
+            Buzzer_On(2000, p->alarmVolume);
+            LED_Alarm_On();
+            // fall through
+        case STATE_TRIGGERED:
+            g_skipStartupDelay = true;
+            break;
+        case STATE_DISARMED:
+            // Door was closed by init: continue with auto-lock, never re-open
+            p->doorUnlockedMsg = true;
+            p->waitingForAutoLock = true;
+            p->stateEntryTime = now;
+            break;
+        default:
+            break;
     }
+}
 
-    // 2. Alphanumeric Check (4x4 Keypad: 0-9, A, B, C, D, *, #)
-    for (size_t i = 0; i < len; i++) {
-        char c = newPassword[i];
-        bool isDigit = isdigit((unsigned char)c);
-        bool isAlpha = (c >= 'A' && c <= 'D');
-        bool isSpecial = (c == '*' || c == '#');
-        
-        if (!isDigit && !isAlpha && !isSpecial) {
-            UART_Printf("\r\n[ADMIN ] ERR: PIN Invalid. Use 0-9, A-D, *, #\r\n");
-            return;
+/* Returns true if any partition left ARMED (state was restored) */
+static bool Restore_Checkpoint(void) {
+    bool changed = false;
+
+    if (Checkpoint_IsValid() && !(RCM->SRS0 & RCM_SRS0_POR_MASK)) {
+        // The FSM hung: resuming the same state with its old age would hang again
+        SupTask_t late;
+        bool hung = Supervisor_TakeDeadlineReset(&late) && late == SUP_TASK_SECURITY;
+
+        for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+            PartitionCheckpoint_t* c = &g_checkpoint.part[i];
+            if (c->state > STATE_LOCKED) continue;
+            SystemState_t state = (SystemState_t)c->state;
+            uint32_t age = c->stateAge;
+            if (hung) {
+                uint32_t limit = State_Limit(state);
+                if (limit != 0 && age >= limit) {
+                    LOG(ALARM, ERROR, "%s: Stuck in state %d for %u ms. Resuming TRIGGERED.\r\n",
+                        g_partitions[i].io->name, (int)state, age);
+                    Audit_Record(AUDIT_ALARM, AUDIT_NO_UID, i);
+                    state = STATE_TRIGGERED;
+                }
+                age = 0; // Fresh timers for every partition
+            }
+            g_partitions[i].failedAttempts = c->failedAttempts;
+            g_partitions[i].alarmVolume = (c->alarmVolume <= MAX_VOLUME) ? c->alarmVolume : MAX_VOLUME;
+            Resume_State(&g_partitions[i], state, age);
+            changed |= (state != STATE_ARMED);
         }
+        LOG(SYSTEM, WARN, "State resumed from RAM checkpoint (reset 0x%02X%02X).\r\n", RCM->SRS1, RCM->SRS0);
+        return changed;
     }
 
-    // 3. Save
-    if (Storage_UpdatePIN(newPassword)) {
-         UART_Printf("\r\n[ADMIN ] Password Updated & Saved to Flash.\r\n");
-    } else {
-         UART_Printf("\r\n[ADMIN ] ERR: Flash Save Failed.\r\n");
+    // Power loss: RAM is gone, the journal holds the last state (timers restart)
+    uint16_t packed;
+    if (Storage_JournalGetLast(JOURNAL_FSM_STATE, &packed, NULL)) {
+        for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+            uint8_t st = (packed >> (i * PACK_BITS)) & ((1U << PACK_BITS) - 1U);
+            if (st > STATE_LOCKED) continue;
+            Resume_State(&g_partitions[i], (SystemState_t)st, 0);
+            changed |= (st != STATE_ARMED);
+        }
+        g_flashedPack = packed;
+        LOG(SYSTEM, WARN, "State resumed from flash journal.\r\n");
     }
+    return changed;
 }
 
-bool Security_CheckAdminPassword(char* inputPass) {
-    return (strcmp(inputPass, Storage_GetConfig()->admin_password) == 0);
+/* After each scheduler pass: RAM checkpoint on change/refresh, journal on change */
+static void Checkpoint_Update(void) {
+    uint16_t packed = Security_PackState();
+    bool changed = false;
+    for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+        const PartitionCheckpoint_t* c = &g_checkpoint.part[i];
+        if (c->state != g_partitions[i].state || c->failedAttempts != g_partitions[i].failedAttempts ||
+            c->alarmVolume != g_partitions[i].alarmVolume) changed = true;
+    }
+    if (changed || IsTimeout(g_lastCheckpoint, CHECKPOINT_REFRESH_MS)) Checkpoint_Save();
+
+    // Alarm states go to flash at once; others are rate limited (flash wear)
+    if (packed != g_flashedPack && !Power_IsFailing()) {
+        bool alarm = false;
+        for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+            if (g_partitions[i].state == STATE_TRIGGERED || g_partitions[i].state == STATE_LOCKED) alarm = true;
+        }
+        if (alarm || IsTimeout(g_lastFlashBackup, FLASH_BACKUP_MIN_MS)) {
+            uint32_t stamp = WallClock_IsSet() ? WallClock_GetTime() : GetTick();
+            Storage_JournalLog(JOURNAL_FSM_STATE, packed, stamp);
+            g_flashedPack = packed;
+            g_lastFlashBackup = GetTick();
+        }
+    }
 }
 
-void Security_SetAdminPassword(const char* newPassword) {
-    if (newPassword == NULL) return;
-    
-    // 1. Length Check (Max 9 chars for bluetooth pass)
-    size_t len = strlen(newPassword);
-    if (len < 1 || len > 9) {
-        UART_Printf("\r\n[ADMIN ] ERR: Pass must be 1-9 chars.\r\n");
-        return;
+/* Liveness for the supervisor: no partition overstays a timed state */
+static bool Partitions_Healthy(void) {
+    uint32_t now = GetTick();
+    for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+        uint32_t limit = State_Limit(g_partitions[i].state);
+        if (limit == 0) continue;
+        if (now - g_partitions[i].stateEntryTime > limit + STUCK_MARGIN_MS) return false;
     }
+    return true;
+}
 
-    // 2. Save
-    if (Storage_UpdateAdminPass(newPassword)) {
-         UART_Printf("\r\n[ADMIN ] Admin Password Updated & Saved.\r\n");
-    } else {
-         UART_Printf("\r\n[ADMIN ] ERR: Flash Save Failed.\r\n");
+// Transitions Partition_Update may take (board-wide tamper events are separate)
+#define TO(s) (1U << (s))
+static const uint8_t g_allowedNext[] = {
+    [STATE_ARMED]       = TO(STATE_ENTRY_DELAY) | TO(STATE_DISARMED) | TO(STATE_LOCKED) | TO(STATE_TRIGGERED),
+    [STATE_ENTRY_DELAY] = TO(STATE_TRIGGERED) | TO(STATE_DISARMED) | TO(STATE_LOCKED),
+    [STATE_EXIT_DELAY]  = TO(STATE_ARMED),
+    [STATE_TRIGGERED]   = TO(STATE_DISARMED) | TO(STATE_LOCKED),
+    [STATE_DISARMED]    = TO(STATE_EXIT_DELAY),
+    [STATE_LOCKED]      = TO(STATE_TRIGGERED),
+};
+
+static void Invariant_Failed(Partition_t* p, const char* what) {
+    LOG(ALARM, ERROR, "%s: INVARIANT VIOLATED (%s). Failing secure.\r\n", p->io->name, what);
+}
+
+/* Unlock is only reachable through Enter_Disarmed (valid auth) */
+static void Open_Door(Partition_t* p) {
+    if (!p->authGranted) {
+        Invariant_Failed(p, "unlock without auth");
+        p->io->door_close();
+        Enter_Triggered(p);
+        return;
     }
+    p->io->door_open();
 }
 
-/* Main State Machine Loop - Called periodically from Main */
-void Security_Update(void) {
-    if (GetTick() < STARTUP_DELAY_MS) return;
+/* Safety properties re-checked after every step; a violation forces the safe side */
+static void Check_Invariants(Partition_t* p, SystemState_t before) {
+    if (p->state != before && !(g_allowedNext[before] & TO(p->state))) {
+        Invariant_Failed(p, "illegal transition");
+        p->io->door_close();
+        Enter_Triggered(p);
+    }
+    if (p->state != STATE_DISARMED) {
+        p->authGranted = false; // Auth is consumed by one unlock window
+    }
+    if (p->failedAttempts >= BRUTE_FORCE_LIMIT && p->state != STATE_LOCKED) {
+        Invariant_Failed(p, "lockout skipped");
+        Enter_Locked(p);
+    }
+}
 
-    switch(currentState) {
+/* One FSM step of one partition */
+static void Partition_Update(Partition_t* p) {
+    switch(p->state) {
         
         // --- ARMED STATE: Monitor Sensors ---
         case STATE_ARMED:
             {
-                int kp = Keypad_CheckPassword();
-                int rf = RFID_CheckScan();
-                int rf_auth = AUTH_NONE;
-
-                // Validate RFID immediately if present
-                if (rf > 0) {
-                    uint32_t uid = RFID_GetLastUID();
-                    bool found = false;
-                    SecurityConfig_t* liveConfig = Storage_GetConfig();
-                    
-                    for (int i = 0; i < MAX_STORED_IDS; i++) {
-                         if (liveConfig->authorized_uids[i] != 0 && liveConfig->authorized_uids[i] == uid) {
-                             found = true;
-                             break;
-                         }
-                    }
-                    if (found) {
-                        UART_Printf("[ACCESS] RFID Authorized (UID: %x)\r\n", uid);
-                        rf_auth = AUTH_VALID;
-                    } else {
-                        UART_Printf("[ACCESS] RFID DENIED (UID: %x)\r\n", uid);
-                        rf_auth = AUTH_INVALID;
-                    }
-                }
+                if (Check_Perimeter(p)) break;
+
+                int kp = Check_Pin(p);
+                int rf_auth = Check_RFID(p); // Validate RFID immediately if present
+                int auth = Resolve_Auth(p, kp, rf_auth);
 
                 // 1. Check Explicit Auth (User Action)
-                if (kp == 1 || rf_auth == AUTH_VALID) {
-                    UART_Printf("\r\n[ACCESS] AUTHORIZED! Unlocking Door directly...\r\n");
+                if (auth == AUTH_VALID) {
+                    LOG(ACCESS, INFO, "%s: AUTHORIZED! Unlocking Door directly...\r\n", p->io->name);
                     Buzzer_Beep(200); 
-                    currentState = STATE_DISARMED;
-                    stateEntryTime = GetTick();
-                    doorUnlockedMsg = false;
-                    waitingForAutoLock = false;
-                    failedAttempts = 0;
+                    Enter_Disarmed(p);
                 }
                 // 2. Check Invalid Auth
-                else if (kp == -1 || rf_auth == AUTH_INVALID) {
-                     Check_Brute_Force();
+                else if (auth == AUTH_INVALID) {
+                     Check_Brute_Force(p);
                 }
-                // 3. Check Passive Intrusion (PIR) or Wakeup
-                else if (PIR_CheckTriggered() || kp == 2) {
-                    UART_Printf("\r\n[ALARM ] MOTION DETECTED! Entry Delay Started (5s)...\r\n");
-                    Servo_Close();
-                    currentState = STATE_ENTRY_DELAY;
-                    stateEntryTime = GetTick();
+                // 3. Check Passive Intrusion (Zone) or Wakeup
+                else if ((p->io->zone_triggered && p->io->zone_triggered()) || kp == 2) {
+                    LOG(ALARM, ERROR, "%s: MOTION DETECTED! Entry Delay Started (5s)...\r\n", p->io->name);
+                    p->io->door_close();
+                    p->state = STATE_ENTRY_DELAY;
+                    p->stateEntryTime = GetTick();
                 }
             }
             break;
 
         // --- ENTRY DELAY: 5s Grace Period ---
         case STATE_ENTRY_DELAY:
-            if (IsTimeout(stateEntryTime, ENTRY_DELAY_MS)) {
-                UART_Printf("\r\n[ALARM ] ENTRY TIMEOUT! ALARM TRIGGERED!\r\n");
-                alarmVolume = INITIAL_VOLUME; 
-                currentState = STATE_TRIGGERED;
-                lastAlarmToggle = GetTick();
+            if (Check_Perimeter(p)) break;
+            if (IsTimeout(p->stateEntryTime, ENTRY_DELAY_MS)) {
+                LOG(ALARM, ERROR, "%s: ENTRY TIMEOUT! ALARM TRIGGERED!\r\n", p->io->name);
+                Enter_Triggered(p);
             }
             
-            int authStatus = Check_Auth();
+            int authStatus = Check_Auth(p);
             if (authStatus == AUTH_VALID) {
-                UART_Printf("\r\n[ACCESS] AUTHORIZED.\r\n");
+                LOG(ACCESS, INFO, "%s: AUTHORIZED.\r\n", p->io->name);
                 Buzzer_Beep(200); // Success Chime
-                currentState = STATE_DISARMED;
-                stateEntryTime = GetTick();
-                doorUnlockedMsg = false; 
-                waitingForAutoLock = false; 
-                failedAttempts = 0; 
+                Enter_Disarmed(p);
             } 
             else if (authStatus == AUTH_INVALID) {
-                 UART_Printf("\r\n[ACCESS] DENIED! Retry...\r\n");
+                 LOG(ACCESS, WARN, "DENIED! Retry...\r\n");
                  Buzzer_Beep(800); // Error Buzz
-                 Check_Brute_Force();
+                 Check_Brute_Force(p);
+            }
+            else if (authStatus == AUTH_DENIED) {
+                 Buzzer_Beep(800); // Refused by policy: audited, no attempt counted
             }
             break;
 
         // --- ALARM TRIGGERED: Siren Active ---
         case STATE_TRIGGERED:
-            if (IsTimeout(lastAlarmToggle, ALARM_BLINK_MS)) {
-                lastAlarmToggle = GetTick(); 
-                static int toggle = 0;
-                toggle = !toggle;
-                if (toggle) { Buzzer_On(1000, alarmVolume); LED_Alarm_On(); } 
-                else        { Buzzer_On(500, alarmVolume);  LED_Alarm_Off(); }
+            if (IsTimeout(p->lastAlarmToggle, ALARM_BLINK_MS)) {
+                p->lastAlarmToggle = GetTick(); 
+                p->blinkPhase = !p->blinkPhase;
+                if (Owns_Siren(p)) {
+                    if (p->blinkPhase) { Buzzer_On(1000, p->alarmVolume); LED_Alarm_On(); } 
+                    else               { Buzzer_On(500, p->alarmVolume);  LED_Alarm_Off(); }
+                }
             }
             
-            authStatus = Check_Auth();
+            authStatus = Check_Auth(p);
             if (authStatus == AUTH_VALID) {
-                UART_Printf("\r\n[ACCESS] AUTHORIZED! Silencing Alarm...\r\n");
-                Buzzer_Off(); LED_Alarm_Off();
+                LOG(ACCESS, INFO, "%s: AUTHORIZED! Silencing Alarm...\r\n", p->io->name);
+                if (Owns_Siren(p)) { Buzzer_Off(); LED_Alarm_Off(); }
                 Buzzer_Beep(200); // Success Chime (overrides Off briefly)
-                
-                currentState = STATE_DISARMED;
-                stateEntryTime = GetTick();
-                doorUnlockedMsg = false;
-                waitingForAutoLock = false;
-                failedAttempts = 0; 
+                Enter_Disarmed(p);
             } 
             else if (authStatus == AUTH_INVALID) {
-                UART_Printf("[ACCESS] DENIED! Volume UP.\r\n");
-                alarmVolume += 10;
-                if (alarmVolume > MAX_VOLUME) alarmVolume = MAX_VOLUME;
-                Check_Brute_Force();
+                LOG(ACCESS, WARN, "DENIED! Volume UP.\r\n");
+                p->alarmVolume += 10;
+                if (p->alarmVolume > MAX_VOLUME) p->alarmVolume = MAX_VOLUME;
+                Check_Brute_Force(p);
             }
             break;
             
         // --- LOCKED: Brute Force Penalty ---
         case STATE_LOCKED:
             {
-                if (IsTimeout(lastAlarmToggle, 100)) { 
-                     lastAlarmToggle = GetTick();
-                     static int toggle = 0;
-                     toggle = !toggle;
-                     if (toggle) {
+                if (IsTimeout(p->lastAlarmToggle, 100)) { 
+                     p->lastAlarmToggle = GetTick();
+                     p->blinkPhase = !p->blinkPhase;
+                     if (!Owns_Siren(p)) {
+                         // Another partition holds the annunciator
+                     } else if (p->blinkPhase) {
                          LED_Alarm_On();
-                         Buzzer_On(2500, alarmVolume); // High Pitch
+                         Buzzer_On(2500, p->alarmVolume); // High Pitch
                      } else {
                          LED_Alarm_Off();
-                         Buzzer_On(1500, alarmVolume); // Low Pitch (Siren Effect)
+                         Buzzer_On(1500, p->alarmVolume); // Low Pitch (Siren Effect)
                      }
                 }
                 
                 // Flush Inputs during lock
-                RFID_GetLastScanResult(); 
-                Keypad_GetKeyNonBlocking();
+                p->io->flush_inputs();
 
-                if (IsTimeout(stateEntryTime, LOCKOUT_TIME_MS)) {
-                     UART_Printf("\r\n[ALARM ] LOCKOUT EXPIRED. ALARM ACTIVE! Auth Required.\r\n");
+                if (IsTimeout(p->stateEntryTime, LOCKOUT_TIME_MS)) {
+                     LOG(ALARM, ERROR, "%s: LOCKOUT EXPIRED. ALARM ACTIVE! Auth Required.\r\n", p->io->name);
                      
                      // Transition to Triggered to ensure alarm sounds
-                     currentState = STATE_TRIGGERED; 
-                     lastAlarmToggle = GetTick();
-                     failedAttempts = 0; 
+                     p->state = STATE_TRIGGERED; 
+                     p->lastAlarmToggle = GetTick();
+                     p->failedAttempts = 0; 
 
-                     RFID_GetLastScanResult();
-                     Keypad_GetKeyNonBlocking();
+                     p->io->flush_inputs();
                 }
             }
             break;
@@ -351,22 +763,21 @@ void Security_Update(void) {
         // --- EXIT DELAY: 10s to leave ---
         case STATE_EXIT_DELAY:
             {
-                if (IsTimeout(lastAlarmToggle, 1000)) { 
-                     lastAlarmToggle = GetTick();
-                     static int toggle = 0;
-                     toggle = !toggle;
-                     if (toggle) LED_Alarm_On(); else LED_Alarm_Off();
+                if (IsTimeout(p->lastAlarmToggle, 1000)) { 
+                     p->lastAlarmToggle = GetTick();
+                     p->blinkPhase = !p->blinkPhase;
+                     if (Owns_Siren(p)) {
+                         if (p->blinkPhase) LED_Alarm_On(); else LED_Alarm_Off();
+                     }
                 }
 
-                if (IsTimeout(stateEntryTime, EXIT_DELAY_MS)) {
-                     UART_Printf("[SYSTEM] System ARMED. Monitoring Active.\r\n");
-                     currentState = STATE_ARMED;
-                     LED_Alarm_Off();
+                if (IsTimeout(p->stateEntryTime, EXIT_DELAY_MS)) {
+                     LOG(SYSTEM, INFO, "%s: ARMED. Monitoring Active.\r\n", p->io->name);
+                     p->state = STATE_ARMED;
+                     if (Owns_Siren(p)) LED_Alarm_Off();
                      
-                     // Clear PIR buffer
-                     PIR_CheckTriggered();
-                     RFID_GetLastScanResult(); 
-                     Keypad_GetKeyNonBlocking();
+                     // Clear zone/card/key buffers
+                     p->io->flush_inputs();
                 }
             }
             break;
@@ -374,32 +785,32 @@ void Security_Update(void) {
         // --- DISARMED: Door Access ---
         case STATE_DISARMED:
             {
-                uint32_t elapsed = GetTick() - stateEntryTime;
+                uint32_t elapsed = GetTick() - p->stateEntryTime;
                 
-                // 1. Unlock Phase
-                if (elapsed < DISARM_WINDOW_MS) {
-                    if (!doorUnlockedMsg) {
-                        Servo_Open();
-                        UART_Printf("[SYSTEM] Door UNLOCKED. Closing in 5s...\r\n");
-                        doorUnlockedMsg = true;
+                // 1. Unlock Phase (never re-entered once auto-lock restarted the timer)
+                if (!p->waitingForAutoLock && elapsed < DISARM_WINDOW_MS) {
+                    if (!p->doorUnlockedMsg) {
+                        Open_Door(p);
+                        LOG(SYSTEM, INFO, "%s UNLOCKED. Closing in 5s...\r\n", p->io->name);
+                        p->doorUnlockedMsg = true;
                     }
                 } 
                 // 2. Auto-Lock Phase
                 else {
-                    if (!waitingForAutoLock) {
-                        UART_Printf("[SYSTEM] Auto-Locking...\r\n");
-                        Servo_Close();
-                        stateEntryTime = GetTick();
-                        waitingForAutoLock = true;
+                    if (!p->waitingForAutoLock) {
+                        LOG(SYSTEM, INFO, "%s: Auto-Locking...\r\n", p->io->name);
+                        p->io->door_close();
+                        p->stateEntryTime = GetTick();
+                        p->waitingForAutoLock = true;
                     }
                     
-                    if (waitingForAutoLock) {
+                    if (p->waitingForAutoLock) {
                          // Start Exit Delay after lock
-                         if (IsTimeout(stateEntryTime, AUTO_LOCK_DELAY_MS)) {
-                             UART_Printf("[SYSTEM] Exit Delay Started (10s). Leaving...\r\n");
-                             currentState = STATE_EXIT_DELAY;
-                             stateEntryTime = GetTick(); 
-                             waitingForAutoLock = false;
+                         if (IsTimeout(p->stateEntryTime, AUTO_LOCK_DELAY_MS)) {
+                             LOG(SYSTEM, INFO, "%s: Exit Delay Started (10s). Leaving...\r\n", p->io->name);
+                             p->state = STATE_EXIT_DELAY;
+                             p->stateEntryTime = GetTick(); 
+                             p->waitingForAutoLock = false;
                          }
                     }
                 }
@@ -407,3 +818,149 @@ void Security_Update(void) {
             break;
     }
 }
+
+// ============================================================================
+
+// ======================================
+// PUBLIC API
+// ======================================
+void Security_Init(void) {
+    for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+        Partition_t* p = &g_partitions[i];
+        memset(p, 0, sizeof(*p));
+        p->io = &g_partitionIO[i];
+        p->alarmVolume = INITIAL_VOLUME;
+
+        // Clear Sensors before Arming
+        p->io->flush_inputs();
+        p->io->door_close();
+        p->state = STATE_ARMED;
+        p->stateEntryTime = GetTick();
+    }
+
+    if (Restore_Checkpoint()) {
+        LOG(SYSTEM, INFO, "Security Manager Initialized. %d Partition(s) RESUMED\r\n", (int)NUM_PARTITIONS);
+    } else {
+        LOG(SYSTEM, INFO, "Security Manager Initialized. %d Partition(s) ARMED\r\n", (int)NUM_PARTITIONS);
+    }
+    Checkpoint_Save();
+}
+
+uint16_t Security_PackState(void) {
+    uint16_t packed = 0;
+    for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+        packed |= (uint16_t)(g_partitions[i].state << (i * PACK_BITS));
+    }
+    return packed;
+}
+
+bool Security_IsDisarmed(void) {
+    for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+        SystemState_t state = g_partitions[i].state;
+        if (state != STATE_DISARMED && state != STATE_EXIT_DELAY) return false;
+    }
+    return true;
+}
+
+#if SELFTEST_ENABLE
+/* Self-test: every partition back to ARMED (no exit delay), siren off, inputs flushed */
+void Security_ForceArmed(void) {
+    for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+        Partition_t* p = &g_partitions[i];
+        p->io->door_close();
+        p->io->flush_inputs();
+        p->state = STATE_ARMED;
+        p->stateEntryTime = GetTick();
+        p->alarmVolume = INITIAL_VOLUME;
+        p->failedAttempts = 0;
+        p->authGranted = false;
+        p->waitingForAutoLock = false;
+    }
+    g_sirenOwner = NULL;
+    Buzzer_Off();
+    LED_Alarm_Off();
+}
+#endif
+
+bool Security_CheckPassword(char* inputPin) {
+    if (strcmp(inputPin, Storage_GetConfig()->door_pin) == 0) {
+        LOG(ACCESS, INFO, "Keypad PIN Accepted.\r\n");
+        return true;
+    }
+    LOG(ACCESS, WARN, "Keypad PIN Rejected.\r\n");
+    return false;
+}
+
+void Security_SetPassword(const char* newPassword) {
+    if (newPassword == NULL) return;
+    
+    // 1. Length Check
+    size_t len = strlen(newPassword);
+    if (len != 4) {
+        LOG(ADMIN, WARN, "ERR: PIN must be EXACTLY 4 characters.\r\n");
+        return;
+    }
+
+    // 2. Alphanumeric Check (4x4 Keypad: 0-9, A, B, C, D, *, #)
+    for (size_t i = 0; i < len; i++) {
+        char c = newPassword[i];
+        bool isDigit = isdigit((unsigned char)c);
+        bool isAlpha = (c >= 'A' && c <= 'D');
+        bool isSpecial = (c == '*' || c == '#');
+        
+        if (!isDigit && !isAlpha && !isSpecial) {
+            LOG(ADMIN, WARN, "ERR: PIN Invalid. Use 0-9, A-D, *, #\r\n");
+            return;
+        }
+    }
+
+    // 3. Save
+    if (Storage_UpdatePIN(newPassword)) {
+         LOG(ADMIN, INFO, "Password Updated & Saved to Flash.\r\n");
+    } else {
+         LOG(ADMIN, ERROR, "ERR: Flash Save Failed.\r\n");
+    }
+}
+
+bool Security_CheckAdminPassword(char* inputPass) {
+    return (strcmp(inputPass, Storage_GetConfig()->admin_password) == 0);
+}
+
+void Security_SetAdminPassword(const char* newPassword) {
+    if (newPassword == NULL) return;
+    
+    // 1. Length Check (Max 9 chars for bluetooth pass)
+    size_t len = strlen(newPassword);
+    if (len < 1 || len > 9) {
+        LOG(ADMIN, WARN, "ERR: Pass must be 1-9 chars.\r\n");
+        return;
+    }
+
+    // 2. Save
+    if (Storage_UpdateAdminPass(newPassword)) {
+         LOG(ADMIN, INFO, "Admin Password Updated & Saved.\r\n");
+    } else {
+         LOG(ADMIN, ERROR, "ERR: Flash Save Failed.\r\n");
+    }
+}
+
+/* Main Scheduler - Called periodically from Main; steps every partition once */
+void Security_Update(void) {
+    if (!g_skipStartupDelay && GetTick() < STARTUP_DELAY_MS) {
+        Supervisor_CheckIn(SUP_TASK_SECURITY);
+        return;
+    }
+
+    Check_Tamper();
+    Check_Enclosure();
+
+    Update_Siren_Owner();
+    for (uint8_t i = 0; i < NUM_PARTITIONS; i++) {
+        SystemState_t before = g_partitions[i].state;
+        Partition_Update(&g_partitions[i]);
+        Check_Invariants(&g_partitions[i], before);
+    }
+    Checkpoint_Update();
+
+    if (Partitions_Healthy()) Supervisor_CheckIn(SUP_TASK_SECURITY);
+}
@@ -11,6 +11,15 @@ void Security_Init(void);
 // Handles Sensor checks, FSM transitions, Alarms, Locks.
 void Security_Update(void);
 
+// Packed FSM state, 4 bits per partition (ISR safe; power-fail journal)
+uint16_t Security_PackState(void);
+
+// True while every partition is disarmed by a valid auth and not yet re-armed (DISARMED / EXIT_DELAY)
+bool Security_IsDisarmed(void);
+
+// Self-Test only: force every partition to ARMED with outputs off
+void Security_ForceArmed(void);
+
 // Password Management API (Door)
 bool Security_CheckPassword(char* inputPin);
 void Security_SetPassword(const char* newPassword);
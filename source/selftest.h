@@ -0,0 +1,35 @@
+/*
+ * selftest.h
+ *
+ * On-Device Input-Flood Self-Test.
+ * Floods keypad / UART / card / PIR inputs through the driver hooks,
+ * injects a perimeter alarm mid-flood and bounds its FSM latency.
+ * Optional: build with SELFTEST_ENABLE=1 (bench builds only).
+ */
+
+#ifndef SELFTEST_H
+#define SELFTEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef SELFTEST_ENABLE
+#define SELFTEST_ENABLE 0
+#endif
+
+#define SELFTEST_PHASE_MS       3000U   // Flood duration per phase
+#define SELFTEST_INJECT_MS      2000U   // Perimeter alarm injected this far into a phase
+#define ALARM_LATENCY_MAX_US    20000U  // Injection -> FSM reaction bound (pass/fail)
+
+// Start a run (SELFTEST admin command, main loop). Refused (false) unless
+// Security_IsDisarmed(): the phases force ARMED and clear alarms, so a run
+// never overrides a live armed system. The system is left ARMED.
+bool Selftest_Start(void);
+
+// Main loop hook: drives the floods and the report
+void Selftest_Tick(void);
+
+// Perimeter input of Door 1: true once per injected alarm
+bool Selftest_CheckPerimeter(void);
+
+#endif // SELFTEST_H
@@ -3,40 +3,32 @@
  *
  * [SERVO DRIVER - SG90]
  * Uses TPM PWM (50Hz) to control locking mechanism.
- * Pin: PTB2 (TPM2_CH0).
+ * Pin: BOARD_PIN_SERVO (TPM2_CH0).
  */
 
 #include "servo_driver.h"
 #include "fsl_port.h"
 #include "fsl_clock.h"
 #include "fsl_tpm.h"
+#include "board_pins.h"
 
 #define BOARD_TPM_BASEADDR TPM2
 #define BOARD_TPM_CHANNEL  0U 
 
-// Pin Mux: PTB2 (Alt3 for TPM2_CH0)
-#define SERVO_PORT   PORTB
-#define SERVO_PIN    2U
-#define SERVO_ALT    kPORT_MuxAlt3
-
 void Servo_Init(void) {
     tpm_config_t tpmInfo;
     tpm_chnl_pwm_signal_param_t tpmParam;
 
-    // 1. Clocks
-    CLOCK_EnableClock(kCLOCK_PortB);
+    // 1. Clocks (pin mux: BoardPins_Init)
     CLOCK_SetTpmClock(1U); // PLLFLLSEL
 
-    // 2. Pin Mux (PTA2 = TPM2_CH1)
-    PORT_SetPinMux(SERVO_PORT, SERVO_PIN, SERVO_ALT);
-
-    // 3. TPM Init
+    // 2. TPM Init
     TPM_GetDefaultConfig(&tpmInfo);
     // Prescale 16 (from user code)
     tpmInfo.prescale = kTPM_Prescale_Divide_16; 
     TPM_Init(BOARD_TPM_BASEADDR, &tpmInfo);
 
-    // 4. Setup PWM at 50Hz (20ms)
+    // 3. Setup PWM at 50Hz (20ms)
     // Initial Duty = 2% (approx 0.4ms - Closed)
     tpmParam.chnlNumber = (tpm_chnl_t)BOARD_TPM_CHANNEL;
     tpmParam.level = kTPM_HighTrue;
@@ -78,3 +70,15 @@ void Servo_Close(void) {
 void Servo_Open(void) {
     Servo_SetDuty(SERVO_OPEN_DUTY);
 }
+
+/* Pin disabled and TPM stopped: Servo_Open/Close only latch the duty,
+ * which takes effect on Servo_Resume */
+void Servo_Release(void) {
+    BOARD_PORT(SERVO)->PCR[BOARD_PIN(SERVO)] = PIN_CFG_ANALOG; // Pin disabled
+    TPM_StopTimer(BOARD_TPM_BASEADDR);
+}
+
+void Servo_Resume(void) {
+    TPM_StartTimer(BOARD_TPM_BASEADDR, kTPM_SystemClock);
+    BOARD_PORT(SERVO)->PCR[BOARD_PIN(SERVO)] = BOARD_PCR(SERVO);
+}
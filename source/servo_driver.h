@@ -19,6 +19,10 @@ void Servo_SetDuty(uint8_t dutyCyclePercent);
 void Servo_Open(void);
 void Servo_Close(void);
 
+// Power-Fail Load Shedding: stop PWM, pin to high-Z (ISR safe) / restore
+void Servo_Release(void);
+void Servo_Resume(void);
+
 #endif // SERVO_DRIVER_H
 
 
@@ -4,6 +4,9 @@
  * [PERSISTENT STORAGE MANAGER]
  * Uses Internal Flash (Last Sector) to save/load System Configuration.
  * Addresses: 0x1FC00 on MKL25Z128.
+ * Config is written primary-then-shadow, so a brown-out mid-save always
+ * leaves one complete copy (magic is programmed last). A pre-erased journal
+ * sector takes power-fail records without an erase.
  */
 
 #include "storage_mgr.h"
@@ -12,7 +15,12 @@
 #include "MKL25Z4.h"
 #include "output_mgr.h"
 #include "uart_driver.h"
+#include "log_mgr.h"
+#include "bloom_filter.h"
+#include "policy_engine.h"
+#include "power_mgr.h"
 #include <string.h>
+#include <stddef.h>
 
 // FLASH Configuration
 // KL25Z128 has 128KB Flash. Address range: 0x00000 - 0x1FFFF.
@@ -20,6 +28,31 @@
 #define STORAGE_SECTOR_ADDR   0x1FC00
 #define STORAGE_SECTOR_SIZE   1024
 
+// Access Policy Bytecode lives in the sector below the config
+#define POLICY_SECTOR_ADDR    0x1F800
+#define POLICY_MAGIC          0x50C7B1E5
+
+// Shadow copy of the config (fallback if the primary write was cut)
+#define STORAGE_SHADOW_ADDR   0x1F400
+
+// Append-only journal, erased at boot when full (never in the power-fail path)
+#define JOURNAL_SECTOR_ADDR   0x1F000
+#define JOURNAL_RECORDS       (STORAGE_SECTOR_SIZE / sizeof(JournalRecord_t))
+#define JOURNAL_FREE          0xFFFFU
+
+typedef struct {
+    uint16_t type;                  // JOURNAL_* (0xFFFF = erased slot)
+    uint16_t info;
+    uint32_t stamp;                 // Unix time, or uptime ms if the clock is unset
+} JournalRecord_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t len;                   // 0 = No policy (built-in rules)
+    uint16_t reserved;
+    uint8_t code[POLICY_MAX_LEN];
+} StoredPolicy_t;
+
 static flash_config_t g_flashDriver;
 static uint32_t pflashBlockBase = 0;
 static uint32_t pflashTotalSize = 0;
@@ -28,13 +61,129 @@ static uint32_t pflashSectorSize = 0;
 // Internal Cache of Config to avoid reading Flash constantly
 static SecurityConfig_t g_cachedConfig;
 
+// Journal write position (JOURNAL_RECORDS = full)
+static uint16_t g_journalNext = 0;
+
+// Set while either copy of a config save is being written
+static volatile bool g_saveInFlight = false;
+
+// Policy sector already verified (skip re-verify on every auth event)
+static const StoredPolicy_t* g_verifiedPolicy = NULL;
+
+// Layout before the admin key was added (STORAGE_MAGIC_V2)
+typedef struct {
+    char door_pin[5];
+    char admin_password[10];
+    uint32_t authorized_uids[MAX_STORED_IDS];
+    uint8_t uid_schedule[MAX_STORED_IDS];
+    uint32_t schedules[MAX_SCHEDULES][SCHEDULE_WORDS];
+    uint32_t magic_header;
+} SecurityConfigV2_t;
+
+// Layout before weekly schedules were added (STORAGE_MAGIC_V1)
+typedef struct {
+    char door_pin[5];
+    char admin_password[10];
+    uint32_t authorized_uids[MAX_STORED_IDS];
+    uint32_t magic_header;
+} SecurityConfigV1_t;
+
 // ============================================================================
 // INTERNAL HELPERS
 // ============================================================================
 static void Print_Flash_Error(status_t status) {
     if (status != kStatus_FLASH_Success) {
-        UART_Printf("[STORAGE] Flash Error Code: %d\r\n", status);
+        LOG(STORAGE, ERROR, "Flash Error Code: %d\r\n", status);
+    }
+}
+
+/* Schedules: everyone in group 0 (24/7), other groups closed */
+static void Default_Schedules(SecurityConfig_t* cfg) {
+    memset(cfg->uid_schedule, 0, sizeof(cfg->uid_schedule));
+    memset(cfg->schedules, 0, sizeof(cfg->schedules));
+    memset(cfg->schedules[0], 0xFF, sizeof(cfg->schedules[0]));
+}
+
+/* Rebuilds the RAM bloom filter from the cached credential set */
+static void Rebuild_Bloom(void) {
+    Bloom_Clear();
+    for (int i = 0; i < MAX_STORED_IDS; i++) {
+        if (g_cachedConfig.authorized_uids[i] != 0) Bloom_Add(g_cachedConfig.authorized_uids[i]);
+    }
+}
+
+/* Newest record of 'type' (flags ignored), or NULL */
+static const JournalRecord_t* Journal_FindLast(uint16_t type) {
+    const JournalRecord_t* journal = (const JournalRecord_t*)JOURNAL_SECTOR_ADDR;
+    for (int i = (int)g_journalNext - 1; i >= 0; i--) {
+        if ((journal[i].type & ~JOURNAL_FLAG_SAVE_CUT) == type) return &journal[i];
+    }
+    return NULL;
+}
+
+/* Erase the full journal, carrying the newest FSM state and admin counter over.
+ * Carry, erase and re-append form one critical section: an LVW record can
+ * neither be wiped after the carry was taken nor land in the erased range. */
+static void Journal_Erase(void) {
+    static const uint16_t kept[] = { JOURNAL_FSM_STATE, JOURNAL_ADMIN_CTR };
+    JournalRecord_t carry[sizeof(kept) / sizeof(kept[0])];
+
+    uint32_t primask = DisableGlobalIRQ();
+    if (Power_IsFailing()) {
+        EnableGlobalIRQ(primask); // Never erase on a sagging rail
+        return;
+    }
+    for (uint32_t i = 0; i < sizeof(kept) / sizeof(kept[0]); i++) {
+        const JournalRecord_t* last = Journal_FindLast(kept[i]);
+        carry[i].type = JOURNAL_FREE;
+        if (last != NULL) carry[i] = *last;
+    }
+
+    status_t res = FLASH_Erase(&g_flashDriver, JOURNAL_SECTOR_ADDR, STORAGE_SECTOR_SIZE, kFLASH_ApiEraseKey);
+    g_journalNext = 0;
+    for (uint32_t i = 0; i < sizeof(kept) / sizeof(kept[0]); i++) {
+        if (carry[i].type != JOURNAL_FREE) Storage_JournalAppend(carry[i].type, carry[i].info, carry[i].stamp);
+    }
+    EnableGlobalIRQ(primask);
+    Print_Flash_Error(res);
+}
+
+/* Erase + Program one sector with interrupts masked */
+static bool Flash_WriteSector(uint32_t addr, const uint32_t* data, uint32_t size) {
+    status_t result;
+
+    // Never start an erase on a sagging rail
+    if (Power_IsFailing()) {
+        LOG(STORAGE, WARN, "Write refused: supply low.\r\n");
+        return false;
+    }
+
+    // Critical Section (Disable Interrupts)
+    LED_Alarm_On(); // Visual Feedback: Start Write
+    __disable_irq();
+
+    // Erase Sector
+    // Erase full 1KB sector before writing
+    result = FLASH_Erase(&g_flashDriver, addr, STORAGE_SECTOR_SIZE, kFLASH_ApiEraseKey);
+    if (result != kStatus_FLASH_Success) {
+        __enable_irq();
+        LED_Alarm_Off(); // Error: Turn Off
+        Print_Flash_Error(result);
+        return false;
+    }
+
+    // Program Data
+    // SDK requires Source Array to be uint32_t aligned
+    result = FLASH_Program(&g_flashDriver, addr, (uint32_t*)data, size);
+    
+    __enable_irq();
+    LED_Alarm_Off(); // Visual Feedback: End Write
+
+    if (result != kStatus_FLASH_Success) {
+         Print_Flash_Error(result);
+         return false;
     }
+    return true;
 }
 
 // ============================================================================
@@ -47,7 +196,7 @@ void Storage_Init(void) {
     // For MKL25Z, standard init.
     status_t result = FLASH_Init(&g_flashDriver);
     if (result != kStatus_FLASH_Success) {
-        UART_Printf("[STORAGE] Driver Init Failed!\r\n");
+        LOG(STORAGE, ERROR, "Driver Init Failed!\r\n");
         return;
     }
 
@@ -56,12 +205,32 @@ void Storage_Init(void) {
     FLASH_GetProperty(&g_flashDriver, kFLASH_PropertyPflashTotalSize, &pflashTotalSize);
     FLASH_GetProperty(&g_flashDriver, kFLASH_PropertyPflashSectorSize, &pflashSectorSize);
 
-    UART_Printf("[STORAGE] Flash Initialized. Total: %d KB, Sector: %d B\r\n", 
+    LOG(STORAGE, INFO, "Flash Initialized. Total: %d KB, Sector: %d B\r\n", 
             pflashTotalSize / 1024, pflashSectorSize);
             
-    // 3. Load at Startup to populate Cache
+    // 3. Journal: find the write position, report the last power-fail
+    const JournalRecord_t* journal = (const JournalRecord_t*)JOURNAL_SECTOR_ADDR;
+    g_journalNext = 0;
+    while (g_journalNext < JOURNAL_RECORDS && journal[g_journalNext].type != JOURNAL_FREE) g_journalNext++;
+    if (g_journalNext > 0) {
+        const JournalRecord_t* last = &journal[g_journalNext - 1];
+        if ((last->type & ~JOURNAL_FLAG_SAVE_CUT) == JOURNAL_POWER_FAIL) {
+            // Measured in the LVW ISR; the power-fail record itself costs another commit
+            uint32_t shed = JOURNAL_PF_SHED_US(last->info);
+            uint32_t commit = JOURNAL_PF_COMMIT_US(last->info);
+            LOG(STORAGE, WARN, "Last Power Fail @%u: shed %u us, commit %u us/record, ~%u of %u us hold-up%s\r\n",
+                last->stamp, shed, commit, shed + 2U * commit, POWER_HOLDUP_US,
+                (last->type & JOURNAL_FLAG_SAVE_CUT) ? ", config save interrupted" : "");
+        }
+    }
+    if (g_journalNext >= JOURNAL_RECORDS) {
+        Journal_Erase();
+    }
+
+    // 4. Load at Startup to populate Cache
     Storage_LoadConfig(&g_cachedConfig);
-    UART_Printf("[STORAGE] Config Loaded. PIN: %s\r\n", g_cachedConfig.door_pin);
+    Rebuild_Bloom();
+    LOG(STORAGE, DEBUG, "Config Loaded. PIN: %s\r\n", g_cachedConfig.door_pin);
 }
 
 void Storage_LoadConfig(SecurityConfig_t* outConfig) {
@@ -71,15 +240,47 @@ void Storage_LoadConfig(SecurityConfig_t* outConfig) {
     SecurityConfig_t* stored = (SecurityConfig_t*)STORAGE_SECTOR_ADDR;
     
     // Check Integrity
+    SecurityConfigV2_t* storedV2 = (SecurityConfigV2_t*)STORAGE_SECTOR_ADDR;
+    SecurityConfigV1_t* storedV1 = (SecurityConfigV1_t*)STORAGE_SECTOR_ADDR;
+    SecurityConfig_t* shadow = (SecurityConfig_t*)STORAGE_SHADOW_ADDR;
     if (stored->magic_header == STORAGE_MAGIC) {
         // Valid Config Found
         memcpy(outConfig, stored, sizeof(SecurityConfig_t));
+        if (memcmp(shadow, stored, sizeof(SecurityConfig_t)) != 0) {
+            // Shadow write was cut (or never made): re-mirror from the RAM copy
+            LOG(STORAGE, WARN, "Shadow config stale. Rewriting.\r\n");
+            Flash_WriteSector(STORAGE_SHADOW_ADDR, (const uint32_t*)outConfig, sizeof(SecurityConfig_t));
+        }
+    } else if (shadow->magic_header == STORAGE_MAGIC) {
+        // Primary write was cut by a power loss: previous config survives in the shadow
+        LOG(STORAGE, WARN, "Primary config incomplete. Restored from shadow.\r\n");
+        memcpy(outConfig, shadow, sizeof(SecurityConfig_t));
+        Storage_SaveConfig(outConfig);
+    } else if (storedV2->magic_header == STORAGE_MAGIC_V2) {
+        // Previous Layout: everything kept, frame authentication not provisioned
+        LOG(STORAGE, INFO, "Migrating config to admin-key layout.\r\n");
+        memcpy(outConfig, storedV2, offsetof(SecurityConfigV2_t, magic_header));
+        memset(outConfig->admin_key, 0, sizeof(outConfig->admin_key));
+        outConfig->magic_header = STORAGE_MAGIC;
+        Storage_SaveConfig(outConfig);
+    } else if (storedV1->magic_header == STORAGE_MAGIC_V1) {
+        // Old Layout: keep credentials, add 24/7 schedules
+        LOG(STORAGE, INFO, "Migrating config to schedule layout.\r\n");
+        memcpy(outConfig->door_pin, storedV1->door_pin, sizeof(outConfig->door_pin));
+        memcpy(outConfig->admin_password, storedV1->admin_password, sizeof(outConfig->admin_password));
+        memcpy(outConfig->authorized_uids, storedV1->authorized_uids, sizeof(outConfig->authorized_uids));
+        Default_Schedules(outConfig);
+        memset(outConfig->admin_key, 0, sizeof(outConfig->admin_key));
+        outConfig->magic_header = STORAGE_MAGIC;
+        Storage_SaveConfig(outConfig);
     } else {
         // Invalid or Fresh Chip -> Load Defaults
-        UART_Printf("[STORAGE] No valid config found. Loading Defaults.\r\n");
+        LOG(STORAGE, WARN, "No valid config found. Loading Defaults.\r\n");
         strcpy(outConfig->door_pin, "1234");
         strcpy(outConfig->admin_password, "123456");
         memset(outConfig->authorized_uids, 0, sizeof(outConfig->authorized_uids));
+        Default_Schedules(outConfig);
+        memset(outConfig->admin_key, 0, sizeof(outConfig->admin_key));
         outConfig->magic_header = STORAGE_MAGIC;
         
         // Auto-Save Defaults to initialize sector
@@ -88,40 +289,99 @@ void Storage_LoadConfig(SecurityConfig_t* outConfig) {
 }
 
 bool Storage_SaveConfig(const SecurityConfig_t* inConfig) {
-    status_t result;
-    
     // 1. Update Cache
     memcpy(&g_cachedConfig, inConfig, sizeof(SecurityConfig_t));
 
-    // 2. Critical Section (Disable Interrupts)
-    LED_Alarm_On(); // Visual Feedback: Start Write
-    __disable_irq();
+    // 2. Erase & Program: primary, then shadow (one copy is always complete)
+    g_saveInFlight = true;
+    bool ok = Flash_WriteSector(STORAGE_SECTOR_ADDR, (const uint32_t*)inConfig, sizeof(SecurityConfig_t));
+    if (ok) ok = Flash_WriteSector(STORAGE_SHADOW_ADDR, (const uint32_t*)inConfig, sizeof(SecurityConfig_t));
+    g_saveInFlight = false;
+    if (ok) LOG(STORAGE, INFO, "Save Success.\r\n");
+    return ok;
+}
 
-    // 3. Erase Sector
-    // Erase full 1KB sector before writing
-    result = FLASH_Erase(&g_flashDriver, STORAGE_SECTOR_ADDR, STORAGE_SECTOR_SIZE, kFLASH_ApiEraseKey);
-    if (result != kStatus_FLASH_Success) {
-        __enable_irq();
-        LED_Alarm_Off(); // Error: Turn Off
-        Print_Flash_Error(result);
+/* Power-fail path (LVW ISR): two longword programs into the pre-erased journal.
+ * The slot is claimed and programmed in one critical section, so the LVW
+ * ISR (priority 0) and a main-context append never share a slot. */
+bool Storage_JournalAppend(uint16_t type, uint16_t info, uint32_t stamp) {
+    if (g_saveInFlight && type == JOURNAL_POWER_FAIL) type |= JOURNAL_FLAG_SAVE_CUT;
+    JournalRecord_t rec = { type, info, stamp };
+
+    uint32_t primask = DisableGlobalIRQ();
+    if (g_journalNext >= JOURNAL_RECORDS) {
+        EnableGlobalIRQ(primask);
         return false;
     }
+    uint32_t addr = JOURNAL_SECTOR_ADDR + g_journalNext * sizeof(JournalRecord_t);
+    g_journalNext++; // Slot consumed even on failure (may be half programmed)
+    status_t result = FLASH_Program(&g_flashDriver, addr, (uint32_t*)&rec, sizeof(rec));
+    EnableGlobalIRQ(primask);
 
-    // 4. Program Data
-    // SDK requires Source Array to be uint32_t aligned
-    result = FLASH_Program(&g_flashDriver, STORAGE_SECTOR_ADDR, (uint32_t*)inConfig, sizeof(SecurityConfig_t));
-    
-    __enable_irq();
-    LED_Alarm_Off(); // Visual Feedback: End Write
+    return (result == kStatus_FLASH_Success);
+}
 
-    if (result == kStatus_FLASH_Success) {
-        UART_Printf("[STORAGE] Save Success.\r\n");
-        return true;
-    } else {
-         Print_Flash_Error(result);
-         return false;
+bool Storage_JournalLog(uint16_t type, uint16_t info, uint32_t stamp) {
+    if (Power_IsFailing()) return Storage_JournalAppend(type, info, stamp);
+    if (g_journalNext >= JOURNAL_RECORDS) Journal_Erase();
+    return Storage_JournalAppend(type, info, stamp);
+}
+
+bool Storage_JournalGetLast(uint16_t type, uint16_t* outInfo, uint32_t* outStamp) {
+    const JournalRecord_t* rec = Journal_FindLast(type);
+    if (rec == NULL) return false;
+    if (outInfo != NULL) *outInfo = rec->info;
+    if (outStamp != NULL) *outStamp = rec->stamp;
+    return true;
+}
+
+bool Storage_FlashErase(uint32_t addr) {
+    if (Power_IsFailing()) return false;
+
+    uint32_t primask = DisableGlobalIRQ();
+    status_t result = FLASH_Erase(&g_flashDriver, addr, STORAGE_SECTOR_SIZE, kFLASH_ApiEraseKey);
+    EnableGlobalIRQ(primask);
+    Print_Flash_Error(result);
+    return (result == kStatus_FLASH_Success);
+}
+
+bool Storage_FlashProgram(uint32_t addr, const uint32_t* data, uint32_t size) {
+    if (Power_IsFailing()) return false;
+
+    uint32_t primask = DisableGlobalIRQ();
+    status_t result = FLASH_Program(&g_flashDriver, addr, (uint32_t*)data, size);
+    EnableGlobalIRQ(primask);
+    Print_Flash_Error(result);
+    return (result == kStatus_FLASH_Success);
+}
+
+bool Storage_SavePolicy(const uint8_t* code, uint16_t len) {
+    if (len > POLICY_MAX_LEN || (len > 0 && !Policy_Verify(code, len))) return false;
+
+    StoredPolicy_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = POLICY_MAGIC;
+    rec.len = len;
+    if (len > 0) memcpy(rec.code, code, len);
+
+    g_verifiedPolicy = NULL;
+    if (!Flash_WriteSector(POLICY_SECTOR_ADDR, (const uint32_t*)&rec, sizeof(rec))) return false;
+    LOG(STORAGE, INFO, "Policy Saved (%d bytes).\r\n", len);
+    return true;
+}
+
+const uint8_t* Storage_GetPolicy(uint16_t* outLen) {
+    // Memory Mapped; re-verified so a corrupt sector can never execute
+    const StoredPolicy_t* stored = (const StoredPolicy_t*)POLICY_SECTOR_ADDR;
+    if (stored->magic != POLICY_MAGIC || stored->len == 0) return NULL;
+    if (stored != g_verifiedPolicy) {
+        if (!Policy_Verify(stored->code, stored->len)) return NULL;
+        g_verifiedPolicy = stored;
     }
+    if (outLen != NULL) *outLen = stored->len;
+    return stored->code;
 }
+
 // ============================================================================
 // HIGH LEVEL MANAGERS
 // ============================================================================
@@ -142,13 +402,18 @@ bool Storage_UpdateAdminPass(const char* newPass) {
     return Storage_SaveConfig(&g_cachedConfig);
 }
 
+bool Storage_UpdateAdminKey(const uint8_t key[ADMIN_KEY_LEN]) {
+    memcpy(g_cachedConfig.admin_key, key, ADMIN_KEY_LEN);
+    return Storage_SaveConfig(&g_cachedConfig);
+}
+
 bool Storage_AddRFID(uint32_t uid) {
     if (uid == 0) return false;
 
     // Check if already exists
     for (int i = 0; i < MAX_STORED_IDS; i++) {
         if (g_cachedConfig.authorized_uids[i] == uid) {
-             UART_Printf("[STORAGE] UID %X already exists.\r\n", uid);
+             LOG(STORAGE, WARN, "UID %X already exists.\r\n", uid);
              return false; // Fail duplicate
         }
     }
@@ -157,12 +422,14 @@ bool Storage_AddRFID(uint32_t uid) {
     for (int i = 0; i < MAX_STORED_IDS; i++) {
         if (g_cachedConfig.authorized_uids[i] == 0) {
             g_cachedConfig.authorized_uids[i] = uid;
-            UART_Printf("[STORAGE] UID %x added at slot %d.\r\n", uid, i);
+            g_cachedConfig.uid_schedule[i] = 0; // 24/7 until assigned
+            Bloom_Add(uid);
+            LOG(STORAGE, INFO, "UID %x added at slot %d.\r\n", uid, i);
             return Storage_SaveConfig(&g_cachedConfig);
         }
     }
 
-    UART_Printf("[STORAGE] Memory Full! Delete an old ID first.\r\n");
+    LOG(STORAGE, WARN, "Memory Full! Delete an old ID first.\r\n");
     return false;
 }
 
@@ -171,28 +438,57 @@ bool Storage_RemoveRFID(uint32_t uid) {
     for (int i = 0; i < MAX_STORED_IDS; i++) {
         if (g_cachedConfig.authorized_uids[i] == uid) {
             g_cachedConfig.authorized_uids[i] = 0; // Clear
+            Bloom_Remove(uid);
             found = true;
         }
     }
     
     if (found) {
-        UART_Printf("[STORAGE] UID %x removed.\r\n", uid);
+        LOG(STORAGE, INFO, "UID %x removed.\r\n", uid);
         return Storage_SaveConfig(&g_cachedConfig); 
     } else {
-        UART_Printf("[STORAGE] UID %x not found.\r\n", uid);
+        LOG(STORAGE, WARN, "UID %x not found.\r\n", uid);
         return false;
     }
 }
 
 void Storage_FactoryReset(void) {
-    SecurityConfig_t def;
-    strcpy(def.door_pin, "1234");
-    strcpy(def.admin_password, "123456");
-    memset(def.authorized_uids, 0, sizeof(def.authorized_uids));
+    // Defaults written over the cache (no second copy of the config on the stack)
+    SecurityConfig_t* def = &g_cachedConfig;
+    strcpy(def->door_pin, "1234");
+    strcpy(def->admin_password, "123456");
+    memset(def->authorized_uids, 0, sizeof(def->authorized_uids));
+    Default_Schedules(def);
+    memset(def->admin_key, 0, sizeof(def->admin_key));
+
+    def->magic_header = STORAGE_MAGIC;
+    Storage_SaveConfig(def);
+    Rebuild_Bloom();
+    LOG(STORAGE, INFO, "Factory Reset Complete.\r\n");
+}
+
+bool Storage_SetScheduleHours(uint8_t group, uint8_t day, uint8_t startHour, uint8_t endHour) {
+    if (group == 0 || group >= MAX_SCHEDULES || day > 6 || startHour >= endHour || endHour > 24) return false;
+
+    for (int h = startHour; h < endHour; h++) {
+        int slot = day * 24 + h;
+        g_cachedConfig.schedules[group][slot >> 5] |= (1UL << (slot & 31));
+    }
+    return Storage_SaveConfig(&g_cachedConfig);
+}
+
+bool Storage_ClearSchedule(uint8_t group) {
+    if (group == 0 || group >= MAX_SCHEDULES) return false;
+    memset(g_cachedConfig.schedules[group], 0, sizeof(g_cachedConfig.schedules[group]));
+    return Storage_SaveConfig(&g_cachedConfig);
+}
 
-    def.magic_header = STORAGE_MAGIC;
-    Storage_SaveConfig(&def);
-    UART_Printf("[STORAGE] Factory Reset Complete.\r\n");
+bool Storage_AssignSchedule(uint32_t uid, uint8_t group) {
+    if (group >= MAX_SCHEDULES) return false;
+    int slot = Storage_FindRFID(uid);
+    if (slot < 0) return false;
+    g_cachedConfig.uid_schedule[slot] = group;
+    return Storage_SaveConfig(&g_cachedConfig);
 }
 
 void Storage_ListRFIDs(void) {
@@ -200,13 +496,30 @@ void Storage_ListRFIDs(void) {
     int count = 0;
     for (int i = 0; i < MAX_STORED_IDS; i++) {
         if (g_cachedConfig.authorized_uids[i] != 0) {
-            UART_Printf("  [%d]: %X\r\n", i + 1, g_cachedConfig.authorized_uids[i]);
+            UART_Printf("  [%d]: %X (Sched %d)\r\n", i + 1, g_cachedConfig.authorized_uids[i], g_cachedConfig.uid_schedule[i]);
             count++;
         }
     }
     if (count == 0) UART_Printf("  (None)\r\n");
 }
 
+int Storage_FindRFID(uint32_t uid) {
+    if (uid == 0) return -1;
+
+    // 1. Bloom Front: most unknown cards stop here
+    if (!Bloom_MayContain(uid)) return -1;
+
+    // 2. Full Lookup (possible false positive)
+    for (int i = 0; i < MAX_STORED_IDS; i++) {
+        if (g_cachedConfig.authorized_uids[i] == uid) return i;
+    }
+    return -1;
+}
+
+bool Storage_IsAuthorizedRFID(uint32_t uid) {
+    return Storage_FindRFID(uid) >= 0;
+}
+
 SecurityConfig_t* Storage_GetConfig(void) {
     return &g_cachedConfig;
 }
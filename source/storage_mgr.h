@@ -7,14 +7,26 @@
 // Max number of stored RFIDs
 #define MAX_STORED_IDS 50
 
+// Weekly Access Schedules (168 hourly bits per group)
+#define MAX_SCHEDULES      8       // Group 0 = 24/7 (fixed)
+#define SCHEDULE_SLOTS     168
+#define SCHEDULE_WORDS     ((SCHEDULE_SLOTS + 31) / 32)
+
 // Magic Header to validate Flash Content
-#define STORAGE_MAGIC 0xA5A5A5A7
+#define STORAGE_MAGIC    0xA5A5A5A9
+#define STORAGE_MAGIC_V2 0xA5A5A5A8   // Pre-admin-key layout (migrated on load)
+#define STORAGE_MAGIC_V1 0xA5A5A5A7   // Pre-schedule layout (migrated on load)
+
+#define ADMIN_KEY_LEN    16           // AES-128 frame authentication key
 
 // Persistent Configuration Structure
 typedef struct {
     char door_pin[5];              // 4 chars + Null (e.g., "1234")
     char admin_password[10];        // Bluetooth Login Password (e.g., "123456")
     uint32_t authorized_uids[MAX_STORED_IDS]; // List of UIDs (0 = Empty)
+    uint8_t uid_schedule[MAX_STORED_IDS];     // Schedule Group per UID slot
+    uint32_t schedules[MAX_SCHEDULES][SCHEDULE_WORDS]; // Bit n = Hour of Week n
+    uint8_t admin_key[ADMIN_KEY_LEN]; // All zero = not provisioned (LOGIN sessions)
     uint32_t magic_header;          // Integrity Check
 } SecurityConfig_t;
 
@@ -23,13 +35,61 @@ void Storage_Init(void);
 void Storage_LoadConfig(SecurityConfig_t* outConfig);
 bool Storage_SaveConfig(const SecurityConfig_t* inConfig);
 
+// Power-Fail Journal (pre-erased sector, one 8-byte record = 2 longword programs)
+#define JOURNAL_POWER_FAIL      0x0001U  // info = JOURNAL_PF_INFO(shed us, record commit us)
+#define JOURNAL_FSM_STATE       0x0002U  // info = packed partition states
+#define JOURNAL_ADMIN_CTR       0x0003U  // stamp = last accepted admin frame counter
+#define JOURNAL_FLAG_SAVE_CUT   0x8000U  // Set if a config save was in progress
+
+// Power-fail timing: shed in us (bits 0-9), one record commit in 16 us units (bits 10-15)
+#define JOURNAL_PF_INFO(shedUs, commitUs) \
+    (uint16_t)(((shedUs) > 1023U ? 1023U : (shedUs)) | (((commitUs) > 1008U ? 63U : (commitUs) / 16U) << 10))
+#define JOURNAL_PF_SHED_US(info)   ((info) & 0x3FFU)
+#define JOURNAL_PF_COMMIT_US(info) (((uint32_t)(info) >> 10) * 16U)
+// ISR safe; never erases. Returns false if the journal is full.
+bool Storage_JournalAppend(uint16_t type, uint16_t info, uint32_t stamp);
+// Main context: erases a full journal first (newest FSM state is kept)
+bool Storage_JournalLog(uint16_t type, uint16_t info, uint32_t stamp);
+// Newest record of a type. Returns false if none.
+bool Storage_JournalGetLast(uint16_t type, uint16_t* outInfo, uint32_t* outStamp);
+
+// Raw Flash access for append-only logs (main context; refused on a failing supply)
+// Erase: one 1KB sector. Program: longword aligned, size multiple of 4, pre-erased area.
+bool Storage_FlashErase(uint32_t addr);
+bool Storage_FlashProgram(uint32_t addr, const uint32_t* data, uint32_t size);
+
+// Access Policy Bytecode (separate Flash sector, verified before save)
+// len = 0 removes the policy (built-in PIN-or-card rules).
+bool Storage_SavePolicy(const uint8_t* code, uint16_t len);
+// Returns the verified policy or NULL if none is installed
+const uint8_t* Storage_GetPolicy(uint16_t* outLen);
+
 // Helpers
 bool Storage_UpdatePIN(const char* newPin);
 bool Storage_UpdateAdminPass(const char* newPass);
+bool Storage_UpdateAdminKey(const uint8_t key[ADMIN_KEY_LEN]);
 bool Storage_AddRFID(uint32_t uid);
 bool Storage_RemoveRFID(uint32_t uid);
 void Storage_FactoryReset(void);
 void Storage_ListRFIDs(void);
+
+// Credential Lookup (Bloom filter front + full scan on possible hit)
+bool Storage_IsAuthorizedRFID(uint32_t uid);
+// Returns the UID's slot index, or -1 if not stored
+int Storage_FindRFID(uint32_t uid);
+
+// Weekly Schedules
+// Opens hours [startHour, endHour) on day (0 = Monday .. 6 = Sunday) for a group
+bool Storage_SetScheduleHours(uint8_t group, uint8_t day, uint8_t startHour, uint8_t endHour);
+bool Storage_ClearSchedule(uint8_t group);
+bool Storage_AssignSchedule(uint32_t uid, uint8_t group);
+
+// O(1) bit test. weekSlot = hour of week (-1 = clock not set -> only group 0 opens)
+static inline bool Storage_IsScheduleOpen(const SecurityConfig_t* cfg, uint8_t group, int weekSlot) {
+    if (group == 0) return true;
+    if (weekSlot < 0 || group >= MAX_SCHEDULES) return false;
+    return (cfg->schedules[group][weekSlot >> 5] >> (weekSlot & 31)) & 1U;
+}
 SecurityConfig_t* Storage_GetConfig(void);
 
 #endif // STORAGE_MGR_H
@@ -0,0 +1,217 @@
+/*
+ * supervisor.c
+ *
+ * [TASK SUPERVISOR + COP SERVICE]
+ * Each task has a check-in deadline (liveness) and a run-time budget.
+ * Budget overruns, loop overruns and long COP gaps are counted and kept
+ * in a small event ring, and runs above 75% of a budget are recorded as
+ * near misses, so budgets can be tuned before anything resets.
+ * A task past its deadline stops the COP service: the hardware resets
+ * the board ~1s later. A .noinit marker tells the next boot which task
+ * was late, so the FSM resumes into a safe state instead of re-entering
+ * the state that hung (Supervisor_TakeDeadlineReset).
+ */
+
+#include "supervisor.h"
+#include "timer_driver.h"
+#include "uart_driver.h"
+#include "log_mgr.h"
+#include "MKL25Z4.h"
+#include "fsl_common.h"
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+#define LOOP_BUDGET_US     5000U   // Work per loop pass (excl. WFI)
+#define COP_NEAR_MISS_MS   500U    // Kick gap worth recording (COP ~1024ms)
+#define NEAR_MISS_PCT      75U
+#define SUP_EVENT_SLOTS    8
+#define SUP_CAUSE_MAGIC    0x5D1EAD00U // Deadline marker (low byte = task)
+
+typedef struct {
+    const char* name;
+    uint16_t deadline_ms;   // Max time between check-ins (0 = no liveness check)
+    uint32_t budget_us;     // Max run time of one call
+} SupTaskConfig_t;
+
+static const SupTaskConfig_t g_taskCfg[SUP_TASKS] = {
+    { "RFID    ", 500, 2000 },
+    { "SENSORS ", 0,   2000 },
+    { "SECURITY", 500, 3000 },
+    { "ADMIN   ", 0,   250000 }, // Two flash sector writes + UART dumps
+};
+
+typedef enum {
+    SUP_EV_NEAR_MISS,
+    SUP_EV_OVERRUN,
+    SUP_EV_DEADLINE,
+    SUP_EV_LOOP,
+    SUP_EV_COP_GAP,
+} SupEventKind_t;
+
+typedef struct {
+    uint32_t tick;
+    uint32_t value;         // us (ms for DEADLINE / COP_GAP)
+    uint8_t task;           // SupTask_t, or SUP_TASKS for the loop
+    uint8_t kind;
+} SupEvent_t;
+
+typedef struct {
+    uint32_t last_checkin;
+    uint32_t start_us;
+    uint32_t max_us;
+    uint16_t overruns;
+    uint16_t near_misses;
+    bool late;              // Deadline missed (COP withheld)
+} SupTaskState_t;
+
+// ============================================================================
+// STATE
+// ============================================================================
+static SupTaskState_t g_tasks[SUP_TASKS];
+static SupEvent_t g_events[SUP_EVENT_SLOTS];
+static uint8_t g_eventHead = 0;
+
+static uint32_t g_loopStart = 0;
+static uint32_t g_loopMax = 0;
+static uint32_t g_windowMax = 0;       // Loop max since the last Supervisor_TakeLoopMax
+static uint16_t g_loopOverruns = 0;
+static uint32_t g_lastKick = 0;
+static uint32_t g_maxKickGap = 0;
+
+// Not touched by the startup code: survives the COP reset it announces
+static uint32_t g_resetCause __attribute__((section(".noinit")));
+
+// ============================================================================
+// INTERNAL HELPERS
+// ============================================================================
+static void Record_Event(uint8_t task, SupEventKind_t kind, uint32_t value) {
+    uint32_t primask = DisableGlobalIRQ(); // ADMIN records from the UART ISR
+    SupEvent_t* ev = &g_events[g_eventHead];
+    ev->tick = GetTick();
+    ev->value = value;
+    ev->task = task;
+    ev->kind = (uint8_t)kind;
+    g_eventHead = (g_eventHead + 1) % SUP_EVENT_SLOTS;
+    EnableGlobalIRQ(primask);
+}
+
+static void Kick_Cop(void) {
+    uint32_t now = GetTick();
+    uint32_t gap = now - g_lastKick;
+    if (gap > g_maxKickGap) g_maxKickGap = gap;
+    if (gap >= COP_NEAR_MISS_MS) Record_Event(SUP_TASKS, SUP_EV_COP_GAP, gap);
+    g_lastKick = now;
+    g_resetCause = 0; // Recovered before the COP fired
+
+    // Service sequence: 0x55 then 0xAA
+    SIM->SRVCOP = 0x55;
+    SIM->SRVCOP = 0xAA;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+void Supervisor_Init(void) {
+    uint32_t now = GetTick();
+    for (int i = 0; i < SUP_TASKS; i++) {
+        g_tasks[i].last_checkin = now;
+    }
+    g_lastKick = now;
+    g_resetCause = 0;
+}
+
+bool Supervisor_TakeDeadlineReset(SupTask_t* task) {
+    uint32_t cause = g_resetCause;
+    g_resetCause = 0;
+    if (!(RCM->SRS0 & RCM_SRS0_WDOG_MASK) || (cause & ~0xFFU) != SUP_CAUSE_MAGIC) return false;
+    if ((cause & 0xFFU) >= SUP_TASKS) return false;
+
+    *task = (SupTask_t)(cause & 0xFFU);
+    LOG(SYSTEM, ERROR, "COP reset: task %s missed its deadline.\r\n", g_taskCfg[*task].name);
+    return true;
+}
+
+void Supervisor_CheckIn(SupTask_t task) {
+    g_tasks[task].last_checkin = GetTick();
+}
+
+void Supervisor_TaskBegin(SupTask_t task) {
+    g_tasks[task].start_us = GetMicros();
+}
+
+void Supervisor_TaskEnd(SupTask_t task) {
+    SupTaskState_t* t = &g_tasks[task];
+    uint32_t run = GetMicros() - t->start_us;
+    uint32_t budget = g_taskCfg[task].budget_us;
+
+    if (run > t->max_us) t->max_us = run;
+    if (run > budget) {
+        t->overruns++;
+        Record_Event(task, SUP_EV_OVERRUN, run);
+    } else if (run > (budget / 100U) * NEAR_MISS_PCT) {
+        t->near_misses++;
+        Record_Event(task, SUP_EV_NEAR_MISS, run);
+    }
+}
+
+void Supervisor_LoopStart(void) {
+    g_loopStart = GetMicros();
+}
+
+void Supervisor_LoopEnd(void) {
+    uint32_t loop = GetMicros() - g_loopStart;
+    if (loop > g_loopMax) g_loopMax = loop;
+    if (loop > g_windowMax) g_windowMax = loop;
+    if (loop > LOOP_BUDGET_US) {
+        g_loopOverruns++;
+        Record_Event(SUP_TASKS, SUP_EV_LOOP, loop);
+    }
+
+    bool healthy = true;
+    uint32_t now = GetTick();
+    for (int i = 0; i < SUP_TASKS; i++) {
+        SupTaskState_t* t = &g_tasks[i];
+        if (g_taskCfg[i].deadline_ms == 0) continue;
+
+        bool late = (now - t->last_checkin) > g_taskCfg[i].deadline_ms;
+        if (late && !t->late) {
+            Record_Event((uint8_t)i, SUP_EV_DEADLINE, now - t->last_checkin);
+            g_resetCause = SUP_CAUSE_MAGIC | (uint32_t)i;
+            LOG(ALARM, ERROR, "Task %s missed its deadline. COP service stopped.\r\n", g_taskCfg[i].name);
+        }
+        t->late = late;
+        if (late) healthy = false;
+    }
+
+    if (healthy) Kick_Cop();
+}
+
+uint32_t Supervisor_TakeLoopMax(void) {
+    uint32_t max = g_windowMax;
+    g_windowMax = 0;
+    return max;
+}
+
+uint16_t Supervisor_GetLoopOverruns(void) {
+    return g_loopOverruns;
+}
+
+void Supervisor_PrintStats(void) {
+    static const char* const kinds[] = { "NEAR  ", "OVRRUN", "DEADLN", "LOOP  ", "COPGAP" };
+
+    UART_Printf("[SUPER ] Task     MaxRun(us)  Budget(us)  Overruns  NearMiss\r\n");
+    for (int i = 0; i < SUP_TASKS; i++) {
+        UART_Printf("[SUPER ] %s %10u  %10u  %8u  %8u%s\r\n", g_taskCfg[i].name, g_tasks[i].max_us,
+                    g_taskCfg[i].budget_us, g_tasks[i].overruns, g_tasks[i].near_misses, g_tasks[i].late ? "  LATE" : "");
+    }
+    UART_Printf("[SUPER ] Loop max %u us (budget %u), overruns %u, max COP gap %u ms\r\n",
+                g_loopMax, LOOP_BUDGET_US, g_loopOverruns, g_maxKickGap);
+
+    for (int n = 0; n < SUP_EVENT_SLOTS; n++) {
+        const SupEvent_t* ev = &g_events[(g_eventHead + n) % SUP_EVENT_SLOTS];
+        if (ev->tick == 0 && ev->value == 0) continue; // Unused slot
+        UART_Printf("[SUPER ] @%u %s %s %u\r\n", ev->tick, kinds[ev->kind],
+                    ev->task < SUP_TASKS ? g_taskCfg[ev->task].name : "LOOP    ", ev->value);
+    }
+}
@@ -0,0 +1,49 @@
+/*
+ * supervisor.h
+ *
+ * Software Watchdog Supervisor.
+ * Services the COP only while every task is alive and within budget.
+ */
+
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    SUP_TASK_RFID,      // Checks in when the reader FSM is back in IDLE
+    SUP_TASK_SENSORS,   // Glass-break / tamper / accelerometer ticks (run time only)
+    SUP_TASK_SECURITY,  // Checks in while no partition is stuck in a timed state
+    SUP_TASK_ADMIN,     // Bluetooth command (main loop via UART_Tick, run time only)
+    SUP_TASKS
+} SupTask_t;
+
+// Call right before enabling the COP
+void Supervisor_Init(void);
+
+// True (once) if the last reset was the COP firing after a missed deadline.
+// Valid before Supervisor_Init; logs the late task.
+bool Supervisor_TakeDeadlineReset(SupTask_t* task);
+
+// Liveness: the task made progress (resets its deadline)
+void Supervisor_CheckIn(SupTask_t task);
+
+// Run-time measurement around one task call
+void Supervisor_TaskBegin(SupTask_t task);
+void Supervisor_TaskEnd(SupTask_t task);
+
+// Main loop frame: Start after WFI, End services the COP if all tasks are healthy
+void Supervisor_LoopStart(void);
+void Supervisor_LoopEnd(void);
+
+// Worst loop time since the previous call (measurement windows, e.g. self-test)
+uint32_t Supervisor_TakeLoopMax(void);
+
+// Loop budget overruns since boot
+uint16_t Supervisor_GetLoopOverruns(void);
+
+// Dump per-task metrics and recent near-miss events (SUPSTATS)
+void Supervisor_PrintStats(void);
+
+#endif // SUPERVISOR_H
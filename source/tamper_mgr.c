@@ -0,0 +1,216 @@
+/*
+ * tamper_mgr.c
+ *
+ * [ANALOG SUPERVISION - ADC0 + DMA1 + CMP0]
+ * Loops are wired with a 10k pull-up to VDD and a 10k end-of-line
+ * resistor to GND, so a healthy loop reads ~VDD/2.
+ *
+ * Background path (no CPU wait): the 1ms tick writes ADC0->SC1A to start
+ * one 32x hardware-averaged conversion; DMA1 copies each result into a
+ * 16-entry circular buffer (DMOD). The main loop reads new entries and
+ * only reports qualified state changes.
+ * Instant path: CMP0 watches Loop A against 3/4 VDD with its digital
+ * filter; a cut wire interrupts within microseconds (also wakes from Stop).
+ */
+
+#include "tamper_mgr.h"
+
+#if TAMPER_ENABLE
+
+#include "glassbreak.h"
+#include "MKL25Z4.h"
+#include "fsl_clock.h"
+#include "fsl_port.h"
+#include "board_pins.h"
+#include <string.h>
+
+#if GLASSBREAK_ENABLE
+#error "TAMPER_ENABLE and GLASSBREAK_ENABLE both need ADC0"
+#endif
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+#define ADC_CH_LOOP_A     4U    // BOARD_PIN_LOOP_A (MUXSEL = b)
+#define ADC_CH_LOOP_B     23U   // BOARD_PIN_LOOP_B
+#define ADC_CH_BANDGAP    27U   // 1.00V internal reference
+#define BANDGAP_MV        1000U
+
+#define SAMPLE_PERIOD_MS  5U    // One conversion per period (round robin)
+#define RING_LEN          16    // Entries (uint16); power of 2, DMOD = 32 bytes
+#define DMA_CH            1U    // DMA0 belongs to the glass-break path
+#define DMA_REARM_BYTES   0xFFFF0U
+
+#define LOOP_SHORT_MAX    800U  // Counts (12-bit): below = shorted
+#define LOOP_OPEN_MIN     3300U // Counts: above = open
+#define LOOP_QUALIFY      4     // Consecutive samples before a state change
+#define SUPPLY_LOW_MV     3000U
+#define SUPPLY_HYST_MV    100U
+#define SUPPLY_QUALIFY    8
+
+#define EVENT_QUEUE_LEN   8
+
+// Conversion order; 4 divides RING_LEN so ring slot i is always seq[i & 3]
+static const uint8_t g_seq[4] = { ADC_CH_LOOP_A, ADC_CH_LOOP_B, ADC_CH_LOOP_A, ADC_CH_BANDGAP };
+
+// ============================================================================
+// STATE
+// ============================================================================
+typedef enum { LOOP_NORMAL, LOOP_OPEN, LOOP_SHORT } LoopState_t;
+
+typedef struct {
+    LoopState_t state;
+    LoopState_t candidate;
+    uint8_t count;
+} LoopQual_t;
+
+static volatile uint16_t g_ring[RING_LEN] __attribute__((aligned(32)));
+static volatile uint8_t g_seq_idx = 0;       // Next conversion to start (ISR)
+static uint8_t g_read_idx = 0;               // Next ring slot to consume (main)
+
+static LoopQual_t g_loops[2];
+static bool g_supply_low = false;
+static uint8_t g_supply_count = 0;
+static uint16_t g_supply_mv = 0;
+
+static TamperEvent_t g_events[EVENT_QUEUE_LEN];
+static volatile uint8_t g_ev_head = 0, g_ev_tail = 0;
+
+// ============================================================================
+// INTERNAL HELPERS
+// ============================================================================
+static void Post_Event(TamperEventType_t type, uint8_t loop, uint16_t value) {
+    uint32_t primask = DisableGlobalIRQ();
+    uint8_t next = (g_ev_head + 1) % EVENT_QUEUE_LEN;
+    if (next != g_ev_tail) { // Full: newest dropped, state stays latched
+        g_events[g_ev_head].type = type;
+        g_events[g_ev_head].loop = loop;
+        g_events[g_ev_head].value = value;
+        g_ev_head = next;
+    }
+    EnableGlobalIRQ(primask);
+}
+
+static void Qualify_Loop(uint8_t loop, uint16_t counts) {
+    LoopQual_t* q = &g_loops[loop];
+    LoopState_t now = LOOP_NORMAL;
+    if (counts > LOOP_OPEN_MIN) now = LOOP_OPEN;
+    else if (counts < LOOP_SHORT_MAX) now = LOOP_SHORT;
+
+    if (now == q->state) { q->count = 0; return; }
+    if (now != q->candidate) { q->candidate = now; q->count = 0; }
+    if (++q->count < LOOP_QUALIFY) return;
+
+    q->state = now;
+    q->count = 0;
+    Post_Event(now == LOOP_OPEN ? TAMPER_EV_OPEN : (now == LOOP_SHORT ? TAMPER_EV_SHORT : TAMPER_EV_RESTORED), loop, counts);
+}
+
+static void Qualify_Supply(uint16_t bandgapCounts) {
+    if (bandgapCounts == 0) return;
+    g_supply_mv = (uint16_t)((BANDGAP_MV * 4095U) / bandgapCounts);
+
+    bool low = g_supply_low ? (g_supply_mv < SUPPLY_LOW_MV + SUPPLY_HYST_MV) : (g_supply_mv < SUPPLY_LOW_MV);
+    if (low == g_supply_low) { g_supply_count = 0; return; }
+    if (++g_supply_count < SUPPLY_QUALIFY) return;
+
+    g_supply_low = low;
+    g_supply_count = 0;
+    Post_Event(low ? TAMPER_EV_SUPPLY_LOW : TAMPER_EV_SUPPLY_OK, 0, g_supply_mv);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+void Tamper_Init(void) {
+    // 1. Bandgap buffer (analog loop pins: BoardPins_Init)
+    PMC->REGSC |= PMC_REGSC_BGBE_MASK;
+
+    // 2. ADC0: 12-bit, long sample, 32x hardware average, DMA request on COCO
+    CLOCK_EnableClock(kCLOCK_Adc0);
+    ADC0->CFG1 = ADC_CFG1_ADIV(2) | ADC_CFG1_ADLSMP_MASK | ADC_CFG1_MODE(1);
+    ADC0->CFG2 = ADC_CFG2_MUXSEL_MASK;
+    ADC0->SC2 = ADC_SC2_DMAEN_MASK; // Software trigger
+    ADC0->SC3 = ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(3);
+
+    // 3. DMA1: ADC0->R[0] -> 32-byte circular ring, no interrupt
+    CLOCK_EnableClock(kCLOCK_Dmamux0);
+    CLOCK_EnableClock(kCLOCK_Dma0);
+    DMAMUX0->CHCFG[DMA_CH] = 0;
+    DMA0->DMA[DMA_CH].SAR = (uint32_t)&ADC0->R[0];
+    DMA0->DMA[DMA_CH].DAR = (uint32_t)g_ring;
+    DMA0->DMA[DMA_CH].DSR_BCR = DMA_DSR_BCR_BCR(DMA_REARM_BYTES);
+    DMA0->DMA[DMA_CH].DCR = DMA_DCR_ERQ_MASK | DMA_DCR_CS_MASK | DMA_DCR_SSIZE(2) |
+                            DMA_DCR_DINC_MASK | DMA_DCR_DSIZE(2) | DMA_DCR_DMOD(2);
+    DMAMUX0->CHCFG[DMA_CH] = DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_SOURCE(40); // ADC0
+
+    // 4. CMP0: Loop A (IN5) vs DAC at 48/64 VDD, filtered, rising edge = open
+    CLOCK_EnableClock(kCLOCK_Cmp0);
+    CMP0->CR1 = 0;
+    CMP0->CR0 = CMP_CR0_FILTER_CNT(7);
+    CMP0->FPR = CMP_FPR_FILT_PER(0xFF);
+    CMP0->DACCR = CMP_DACCR_DACEN_MASK | CMP_DACCR_VRSEL_MASK | CMP_DACCR_VOSEL(47);
+    CMP0->MUXCR = CMP_MUXCR_PSEL(5) | CMP_MUXCR_MSEL(7);
+    CMP0->SCR = CMP_SCR_CFR_MASK | CMP_SCR_CFF_MASK | CMP_SCR_IER_MASK;
+    CMP0->CR1 = CMP_CR1_EN_MASK;
+    NVIC_SetPriority(CMP0_IRQn, 1);
+    EnableIRQ(CMP0_IRQn);
+
+    memset(g_loops, 0, sizeof(g_loops));
+}
+
+/* 1ms ISR context: one register write every SAMPLE_PERIOD_MS */
+void Tamper_SampleTick(void) {
+    static uint8_t divider = 0;
+    if (++divider < SAMPLE_PERIOD_MS) return;
+    divider = 0;
+
+    if (ADC0->SC2 & ADC_SC2_ADACT_MASK) return; // Previous average still running
+    ADC0->SC1[0] = ADC_SC1_ADCH(g_seq[g_seq_idx & 3]);
+    g_seq_idx++;
+}
+
+void Tamper_Tick(void) {
+    // Ring slots the DMA has written since the last call
+    uint8_t write_idx = (uint8_t)(((DMA0->DMA[DMA_CH].DAR - (uint32_t)g_ring) / sizeof(uint16_t)) & (RING_LEN - 1));
+
+    while (g_read_idx != write_idx) {
+        uint16_t counts = g_ring[g_read_idx];
+        switch (g_seq[g_read_idx & 3]) {
+            case ADC_CH_LOOP_A:  Qualify_Loop(0, counts); break;
+            case ADC_CH_LOOP_B:  Qualify_Loop(1, counts); break;
+            case ADC_CH_BANDGAP: Qualify_Supply(counts); break;
+        }
+        g_read_idx = (g_read_idx + 1) & (RING_LEN - 1);
+    }
+
+    // Keep the endless ring running (BCR counts down ~400 B/s)
+    if ((DMA0->DMA[DMA_CH].DSR_BCR & DMA_DSR_BCR_BCR_MASK) < 0x100U) {
+        uint32_t primask = DisableGlobalIRQ();
+        DMA0->DMA[DMA_CH].DSR_BCR = DMA_DSR_BCR_BCR(DMA_REARM_BYTES);
+        EnableGlobalIRQ(primask);
+    }
+}
+
+bool Tamper_GetEvent(TamperEvent_t* out) {
+    if (g_ev_tail == g_ev_head) return false;
+    *out = g_events[g_ev_tail];
+    g_ev_tail = (g_ev_tail + 1) % EVENT_QUEUE_LEN;
+    return true;
+}
+
+uint16_t Tamper_GetSupplyMv(void) {
+    return g_supply_mv;
+}
+
+/* Instant trip: Loop A went above the DAC threshold (wire cut) */
+void CMP0_IRQHandler(void) {
+    CMP0->SCR |= CMP_SCR_CFR_MASK; // W1C (keeps IER)
+    if (g_loops[0].state != LOOP_OPEN) {
+        g_loops[0].state = LOOP_OPEN;   // ADC path will confirm/restore
+        g_loops[0].count = 0;
+        Post_Event(TAMPER_EV_OPEN, 0, 0);
+    }
+}
+
+#endif // TAMPER_ENABLE
@@ -0,0 +1,49 @@
+/*
+ * tamper_mgr.h
+ *
+ * Analog Supervision: Tamper Loops & Supply Rail.
+ * Optional: build with TAMPER_ENABLE=1. Shares ADC0 with the glass-break
+ * detector, so only one of the two can be enabled.
+ */
+
+#ifndef TAMPER_MGR_H
+#define TAMPER_MGR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef TAMPER_ENABLE
+#define TAMPER_ENABLE 0
+#endif
+
+typedef enum {
+    TAMPER_EV_NONE = 0,
+    TAMPER_EV_OPEN,         // Loop cut (CMP instant trip or ADC)
+    TAMPER_EV_SHORT,        // Loop bridged
+    TAMPER_EV_RESTORED,     // Loop back in the normal band
+    TAMPER_EV_SUPPLY_LOW,
+    TAMPER_EV_SUPPLY_OK,
+} TamperEventType_t;
+
+typedef struct {
+    TamperEventType_t type;
+    uint8_t loop;           // 0 = Loop A (PTE29), 1 = Loop B (PTE30)
+    uint16_t value;         // ADC counts, or mV for supply events
+} TamperEvent_t;
+
+// Initialize ADC0 averaging, DMA1 ring, CMP0 trip (Loop A)
+void Tamper_Init(void);
+
+// ISR Hook (Called every 1ms): starts the next background conversion
+void Tamper_SampleTick(void);
+
+// Main loop: qualifies new ring samples into state-change events
+void Tamper_Tick(void);
+
+// Pops one qualified event. Returns false if none.
+bool Tamper_GetEvent(TamperEvent_t* out);
+
+// Last supply measurement (mV), 0 if not measured yet
+uint16_t Tamper_GetSupplyMv(void);
+
+#endif // TAMPER_MGR_H
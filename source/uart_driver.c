@@ -3,6 +3,12 @@
  *
  * [BLUETOOTH DRIVER]
  * Driver for HC-05 Module using UART2 (Interrupt-based).
+ * TX: One queue per priority class, drained by the TDRE interrupt.
+ * Any context reserves a whole frame, fills it and commits it; only
+ * committed frames are sent, so lines never interleave. Between frames
+ * the highest class with a committed frame wins (Alarm > Access > Admin > Debug).
+ * RX: the ISR edits the line in a pool block and hands complete lines to
+ * the main loop (UART_Tick), which runs the admin command and frees it.
  */
 
 #include "uart_driver.h"
@@ -11,36 +17,511 @@
 #include "fsl_port.h"
 #include "fsl_clock.h"
 #include "MKL25Z4.h"
+#include "timer_driver.h"
+#include "wall_clock.h"
+#include "supervisor.h"
+#include "selftest.h"
+#include "mem_pool.h"
+#include "board_pins.h"
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 
 #define TARGET_UART UART2
 #define TARGET_IRQ  UART2_IRQn
 
-#define RX_BUFFER_SIZE 64
+#define RX_BUFFER_SIZE 96  // Fits an authenticated admin frame (26 B header)
+#define RX_LINE_SLOTS  2   // Complete lines waiting for the main loop (power of 2)
+#define LOG_LINE_SIZE  128
+#define LOG_REPEAT_SIZE 48
+#define LOG_REPEAT_FLUSH_MS 2000U   // Summary of a run still going on
 
-static char rx_buffer[RX_BUFFER_SIZE];
+// HC-05 STATE Pin (BOARD_PIN_BT_STATE): High = Client Connected.
+// Pulled up so an unwired pin behaves as "always connected".
+
+// Deferred Log Ring (used while no client is connected)
+#define LOG_HISTORY_SIZE  16
+#define LOG_MAX_ARGS      4
+#define LOG_FLASH_END     0x00020000U   // %s args outside Flash are not kept
+#define LOG_SPEC_MAX      12            // Longest conversion spec replayed ("%-08.3lX")
+#define LOG_ARGS_UNFIT    0xFF          // nargs: format cannot be replayed from words
+
+typedef struct {
+    uint32_t tick;                  // Unix seconds (clock set) or ms uptime
+    bool wall;                      // True if tick is wall-clock time
+    uint8_t nargs;                  // Words used in args[], or LOG_ARGS_UNFIT
+    const char* fmt;                // Format string (Flash literal)
+    uint32_t args[LOG_MAX_ARGS];    // Raw 32-bit argument words
+} LogEvent_t;
+
+// Argument type of one conversion (what va_arg / the replay must use)
+typedef enum {
+    LOG_ARG_PERCENT,                // "%%": no argument
+    LOG_ARG_INT,                    // d i c (and h/hh forms: promoted to int)
+    LOG_ARG_UINT,                   // u x X o
+    LOG_ARG_LONG,                   // ld li
+    LOG_ARG_ULONG,                  // lu lx lX lo
+    LOG_ARG_STR,                    // s
+    LOG_ARG_PTR,                    // p
+    LOG_ARG_UNFIT                   // 64-bit, floating point, %n, unknown
+} LogArg_t;
+
+static LogEvent_t g_log_history[LOG_HISTORY_SIZE];
+static uint8_t g_log_head = 0;      // Next write slot
+static uint8_t g_log_count = 0;
+
+// TX Queues (sizes must be powers of 2)
+// Frame layout in queue: [len][commit][tick lo][tick hi][len bytes]
+// Producers claim space by advancing 'reserve' (CAS), fill it with IRQs
+// enabled, then set the commit byte. The TX ISR sends only committed
+// frames and zeroes every byte it pops, so free space never holds a
+// stale commit marker.
+#define TX_FRAME_HDR      4
+#define TX_MAX_FRAME      255
+#define TX_COMMITTED      0xC5
+
+typedef struct {
+    uint8_t* buf;
+    uint16_t mask;
+    volatile uint16_t reserve;  // Claim index (producers, any context)
+    volatile uint16_t tail;     // Read index (TX ISR)
+} TxQueue_t;
+
+static uint8_t g_txq_alarm[256];
+static uint8_t g_txq_access[256];
+static uint8_t g_txq_admin[1024];   // LISTIDS / HISTORY dumps
+static uint8_t g_txq_debug[128];
+
+static TxQueue_t g_txq[UART_TX_CLASSES] = {
+    { g_txq_alarm,  sizeof(g_txq_alarm)  - 1, 0, 0 },
+    { g_txq_access, sizeof(g_txq_access) - 1, 0, 0 },
+    { g_txq_admin,  sizeof(g_txq_admin)  - 1, 0, 0 },
+    { g_txq_debug,  sizeof(g_txq_debug)  - 1, 0, 0 },
+};
+static UART_TxStats_t g_tx_stats[UART_TX_CLASSES];
+
+static volatile uint8_t g_tx_class = 0;       // Class of the frame on the wire
+static volatile uint16_t g_tx_remaining = 0;  // Bytes left in that frame
+
+static char* g_rx_line = NULL;                // Line being edited (owned by the ISR)
 static uint8_t rx_index = 0;
+static char* g_rx_ready[RX_LINE_SLOTS];       // Complete lines (owned by the main loop)
+static volatile uint8_t g_rx_head = 0;        // Written by the ISR
+static volatile uint8_t g_rx_tail = 0;        // Written by UART_Tick
+static volatile uint32_t g_rx_overflows = 0;  // Line buffer overruns + hardware OR
+
+// Repeat Collapsing for LOG() events ("Last message repeated N times").
+// Shared by main loop and ISRs: only touched with IRQs disabled.
+static char g_last_line[LOG_LINE_SIZE];       // Text of the last event line sent
+static uint8_t g_repeat_class = 0;            // Its TX class
+static uint16_t g_repeat_count = 0;           // Copies dropped since
+static uint32_t g_repeat_start = 0;           // Tick of the first dropped copy
+
+// ============================================================================
+// TX SCHEDULER
+// ============================================================================
+static uint16_t Tx_Used(const TxQueue_t* q) {
+    return (uint16_t)((q->reserve - q->tail) & q->mask);
+}
+
+static uint8_t Tx_Pop(TxQueue_t* q) {
+    uint8_t b = q->buf[q->tail];
+    q->buf[q->tail] = 0; // Free space stays zero (no stale commit marker)
+    q->tail = (q->tail + 1) & q->mask;
+    return b;
+}
+
+static bool Tx_FrontCommitted(const TxQueue_t* q) {
+    return ((volatile uint8_t*)q->buf)[(q->tail + 1) & q->mask] == TX_COMMITTED;
+}
+
+/*
+ * Compare-and-swap on a queue index. The M0+ has no LDREX/STREX and the
+ * BME only decorates peripheral space, so the compare and the store run
+ * under PRIMASK: a few cycles, independent of the frame length.
+ */
+static bool Tx_Cas(volatile uint16_t* p, uint16_t expect, uint16_t desired) {
+    uint32_t primask = DisableGlobalIRQ();
+    bool ok = (*p == expect);
+    if (ok) *p = desired;
+    EnableGlobalIRQ(primask);
+    return ok;
+}
+
+/* Sends one byte. Called from the TDRE ISR or with IRQs masked. */
+static void Tx_Service(void) {
+    if (g_tx_remaining == 0) {
+        // Frame boundary: strict priority pick among committed frames.
+        // A frame still being filled (preempted producer) holds back its class only.
+        uint8_t c;
+        for (c = 0; c < UART_TX_CLASSES; c++) {
+            if (Tx_FrontCommitted(&g_txq[c])) break;
+        }
+        if (c == UART_TX_CLASSES) {
+            UART_DisableInterrupts(TARGET_UART, kUART_TxDataRegEmptyInterruptEnable);
+            return;
+        }
+
+        TxQueue_t* q = &g_txq[c];
+        uint16_t len = Tx_Pop(q);
+        (void)Tx_Pop(q); // Commit marker
+        uint16_t t = Tx_Pop(q);
+        t |= (uint16_t)(Tx_Pop(q) << 8);
+
+        uint16_t latency = (uint16_t)((uint16_t)GetTick() - t);
+        if (latency > g_tx_stats[c].max_latency_ms) g_tx_stats[c].max_latency_ms = latency;
+        g_tx_stats[c].frames++;
+
+        g_tx_class = c;
+        g_tx_remaining = len;
+        if (len == 0) return;
+    }
+
+    UART_WriteByte(TARGET_UART, Tx_Pop(&g_txq[g_tx_class]));
+    g_tx_remaining--;
+}
+
+/* Queues one frame from any context (incl. nested ISRs); lines never interleave.
+ * Debug frames are dropped when full; other classes wait, pumping the UART by
+ * polling, unless the space is held by a frame a preempted context is filling. */
+static bool Tx_Enqueue(UART_TxClass_t cls, const uint8_t* data, uint16_t len) {
+    TxQueue_t* q = &g_txq[cls];
+    if (len > TX_MAX_FRAME) len = TX_MAX_FRAME;
+    uint16_t need = len + TX_FRAME_HDR;
+    uint16_t r;
+
+    // 1. Reserve
+    while (1) {
+        r = q->reserve;
+        uint16_t used = (uint16_t)((r - q->tail) & q->mask);
+
+        if ((uint16_t)(q->mask - used) >= need) {
+            if (!Tx_Cas(&q->reserve, r, (r + need) & q->mask)) continue; // Preempted: retry
+            if (used + need > g_tx_stats[cls].max_depth) g_tx_stats[cls].max_depth = used + need;
+            break;
+        }
+
+        bool draining = Tx_FrontCommitted(q) || (g_tx_remaining != 0 && g_tx_class == cls);
+        if (cls == UART_TX_DEBUG || need > q->mask || !draining) {
+            g_tx_stats[cls].dropped++;
+            return false;
+        }
+
+        // Full: drain by polling until space frees up (the TX ISR may be masked by our caller)
+        uint32_t primask = DisableGlobalIRQ();
+        if (UART_GetStatusFlags(TARGET_UART) & kUART_TxDataRegEmptyFlag) Tx_Service();
+        EnableGlobalIRQ(primask);
+    }
+
+    // 2. Fill (IRQs enabled; nested producers claim space after ours)
+    uint16_t t = (uint16_t)GetTick();
+    uint16_t h = (r + 2) & q->mask;
+    q->buf[r] = (uint8_t)len;
+    q->buf[h] = (uint8_t)t;        h = (h + 1) & q->mask;
+    q->buf[h] = (uint8_t)(t >> 8); h = (h + 1) & q->mask;
+    for (uint16_t i = 0; i < len; i++) {
+        q->buf[h] = data[i];
+        h = (h + 1) & q->mask;
+    }
+
+    // 3. Commit (after every byte of the frame is in place)
+    __DMB();
+    ((volatile uint8_t*)q->buf)[(r + 1) & q->mask] = TX_COMMITTED;
+    UART_EnableInterrupts(TARGET_UART, kUART_TxDataRegEmptyInterruptEnable);
+    return true;
+}
+
+void UART_GetTxStats(UART_TxClass_t cls, UART_TxStats_t* out) {
+    if (cls >= UART_TX_CLASSES || out == NULL) return;
+    uint32_t primask = DisableGlobalIRQ();
+    *out = g_tx_stats[cls];
+    out->depth = Tx_Used(&g_txq[cls]);
+    EnableGlobalIRQ(primask);
+}
+
+uint32_t UART_GetRxOverflows(void) {
+    return g_rx_overflows;
+}
+
+void UART_PrintTxStats(void) {
+    static const char* const names[UART_TX_CLASSES] = { "ALARM ", "ACCESS", "ADMIN ", "DEBUG " };
+    UART_Printf("[TX    ] Class  Depth/Max  MaxLat(ms)  Frames  Dropped\r\n");
+    for (int c = 0; c < UART_TX_CLASSES; c++) {
+        UART_TxStats_t st;
+        UART_GetTxStats((UART_TxClass_t)c, &st);
+        UART_Printf("[TX    ] %s %4u/%4u  %10u  %6u  %7u\r\n", names[c],
+                    st.depth, st.max_depth, st.max_latency_ms, st.frames, st.dropped);
+    }
+    UART_Printf("[RX    ] Overflows %u\r\n", g_rx_overflows);
+}
+
+// ============================================================================
+// LOGGING
+// ============================================================================
+bool UART_IsClientConnected(void) {
+    return (BOARD_GPIO(BT_STATE)->PDIR & BOARD_MASK(BT_STATE)) != 0U;
+}
+
+#if (LOG_IDLE_MODE == LOG_IDLE_RECORD)
+/* Parses one conversion spec; p points just past the '%'.
+ * Returns the end of the spec, its argument type and its '*' count. */
+static const char* Log_ParseSpec(const char* p, LogArg_t* type, int* stars) {
+    bool isLong = false;
+    *stars = 0;
+    *type = LOG_ARG_UNFIT;
+
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') p++;
+    if (*p == '*') { (*stars)++; p++; }
+    else while (*p >= '0' && *p <= '9') p++;
+    if (*p == '.') {
+        p++;
+        if (*p == '*') { (*stars)++; p++; }
+        else while (*p >= '0' && *p <= '9') p++;
+    }
+    if (*p == 'h') { p++; if (*p == 'h') p++; }
+    else if (*p == 'l') {
+        p++;
+        if (*p == 'l') return p + 1;    // long long: two words
+        isLong = true;
+    }
+    else if (*p == 'L' || *p == 'j' || *p == 'z' || *p == 't') return p + 1;
+    if (*p == 0) return p;
+
+    switch (*p) {
+        case '%': *type = LOG_ARG_PERCENT; break;
+        case 'd': case 'i': *type = isLong ? LOG_ARG_LONG : LOG_ARG_INT; break;
+        case 'c': *type = isLong ? LOG_ARG_UNFIT : LOG_ARG_INT; break;
+        case 'u': case 'x': case 'X': case 'o': *type = isLong ? LOG_ARG_ULONG : LOG_ARG_UINT; break;
+        case 's': *type = isLong ? LOG_ARG_UNFIT : LOG_ARG_STR; break;
+        case 'p': *type = LOG_ARG_PTR; break;
+        default: break;                 // f e g a n ...: not replayable from words
+    }
+    return p + 1;
+}
+
+/* Formats one conversion with its words cast back to the type fmt expects */
+static int Log_FormatSpec(char* out, size_t room, const char* spec, LogArg_t type,
+                          int stars, const uint32_t* w) {
+    int s0 = (int)w[0];
+    int s1 = (int)w[1];
+    uint32_t v = w[stars];
+
+#define LOG_EMIT(val) ((stars == 0) ? snprintf(out, room, spec, val) :            \
+                       (stars == 1) ? snprintf(out, room, spec, s0, val) :        \
+                                      snprintf(out, room, spec, s0, s1, val))
+    switch (type) {
+        case LOG_ARG_INT:   return LOG_EMIT((int)v);
+        case LOG_ARG_UINT:  return LOG_EMIT((unsigned)v);
+        case LOG_ARG_LONG:  return LOG_EMIT((long)(int32_t)v);
+        case LOG_ARG_ULONG: return LOG_EMIT((unsigned long)v);
+        case LOG_ARG_STR:   return LOG_EMIT((const char*)(uintptr_t)v);
+        case LOG_ARG_PTR:   return LOG_EMIT((void*)(uintptr_t)v);
+        default:            return 0;
+    }
+#undef LOG_EMIT
+}
+#endif
+
+/* Stores fmt + raw args (no formatting). Cost: one pass over fmt.
+ * Formats that need more than LOG_MAX_ARGS words, or args that are not
+ * one word (64-bit, double), are kept as text only (nargs = LOG_ARGS_UNFIT). */
+static void Log_Record(const char* fmt, va_list args) {
+#if (LOG_IDLE_MODE == LOG_IDLE_RECORD)
+    LogEvent_t ev;
+    ev.tick = WallClock_GetTime();
+    ev.wall = (ev.tick != 0);
+    if (!ev.wall) ev.tick = GetTick();
+    ev.fmt = fmt;
+    memset(ev.args, 0, sizeof(ev.args));
+
+    int n = 0;
+    for (const char* p = fmt; *p != 0; ) {
+        if (*p++ != '%') continue;
+        LogArg_t type;
+        int stars;
+        const char* end = Log_ParseSpec(p, &type, &stars);
+        if (type == LOG_ARG_PERCENT) { p = end; continue; }
+        if (type == LOG_ARG_UNFIT || n + stars + 1 > LOG_MAX_ARGS || end - p + 1 > LOG_SPEC_MAX) {
+            n = LOG_ARGS_UNFIT;         // va_list left unread past this point
+            break;
+        }
+        for (int i = 0; i < stars; i++) ev.args[n++] = (uint32_t)va_arg(args, int);
+
+        switch (type) {
+            case LOG_ARG_STR: {
+                const char* str = va_arg(args, const char*);
+                // RAM strings may be gone at replay time
+                ev.args[n++] = ((uintptr_t)str < LOG_FLASH_END) ? (uint32_t)(uintptr_t)str
+                                                               : (uint32_t)(uintptr_t)"(ram)";
+                break;
+            }
+            case LOG_ARG_PTR:   ev.args[n++] = (uint32_t)(uintptr_t)va_arg(args, void*); break;
+            case LOG_ARG_LONG:  ev.args[n++] = (uint32_t)va_arg(args, long); break;
+            case LOG_ARG_ULONG: ev.args[n++] = (uint32_t)va_arg(args, unsigned long); break;
+            case LOG_ARG_INT:   ev.args[n++] = (uint32_t)va_arg(args, int); break;
+            default:            ev.args[n++] = va_arg(args, unsigned); break;
+        }
+        p = end;
+    }
+    ev.nargs = (uint8_t)n;
+
+    // Claim the slot atomically (ISRs log too)
+    uint32_t primask = DisableGlobalIRQ();
+    g_log_history[g_log_head] = ev;
+    g_log_head = (uint8_t)((g_log_head + 1) % LOG_HISTORY_SIZE);
+    if (g_log_count < LOG_HISTORY_SIZE) g_log_count++;
+    EnableGlobalIRQ(primask);
+#else
+    (void)fmt;
+    (void)args;
+#endif
+}
+
+/* Rebuilds the line: literal text is copied, each conversion is formatted
+ * on its own with its words cast back to the type the format expects. */
+#if (LOG_IDLE_MODE == LOG_IDLE_RECORD)
+static void Log_Replay(char* buf, size_t size, const LogEvent_t* ev) {
+    if (ev->nargs == LOG_ARGS_UNFIT) {
+        snprintf(buf, size, "%s", ev->fmt);
+        return;
+    }
+    size_t len = 0;
+    int n = 0;
+    const char* p = ev->fmt;
+    while (*p != 0 && len + 1 < size) {
+        if (*p != '%') { buf[len++] = *p++; continue; }
+        LogArg_t type;
+        int stars;
+        const char* end = Log_ParseSpec(p + 1, &type, &stars);
+        if (type == LOG_ARG_PERCENT) {
+            buf[len++] = '%';
+        } else {
+            char spec[LOG_SPEC_MAX + 1];
+            memcpy(spec, p, (size_t)(end - p));
+            spec[end - p] = 0;
+            int out = Log_FormatSpec(buf + len, size - len, spec, type, stars, &ev->args[n]);
+            n += stars + 1;
+            if (out > 0) len += ((size_t)out < size - len) ? (size_t)out : size - len - 1;
+        }
+        p = end;
+    }
+    buf[len] = 0;
+}
+#endif
+
+void UART_PrintHistory(void) {
+#if (LOG_IDLE_MODE == LOG_IDLE_RECORD)
+    char* buf = Pool_Alloc(LOG_LINE_SIZE);
+    if (buf == NULL) return;
+
+    uint32_t primask = DisableGlobalIRQ();
+    int count = g_log_count;
+    int start = (g_log_head + LOG_HISTORY_SIZE - count) % LOG_HISTORY_SIZE;
+    EnableGlobalIRQ(primask);
+
+    UART_Printf("[LOG   ] %d buffered events:\r\n", count);
+    for (int i = 0; i < count; i++) {
+        LogEvent_t ev;
+        primask = DisableGlobalIRQ();
+        ev = g_log_history[(start + i) % LOG_HISTORY_SIZE];
+        EnableGlobalIRQ(primask);
+
+        int len = ev.wall ? snprintf(buf, LOG_LINE_SIZE, "[%10u] ", (unsigned)ev.tick)
+                          : snprintf(buf, LOG_LINE_SIZE, "[+%7ums] ", (unsigned)ev.tick);
+        Log_Replay(buf + len, LOG_LINE_SIZE - len, &ev);
+        Tx_Enqueue(UART_TX_ADMIN, (uint8_t*)buf, strlen(buf));
+    }
+
+    // Events logged during the dump stay for the next HISTORY
+    primask = DisableGlobalIRQ();
+    g_log_count = (g_log_count > count) ? (uint8_t)(g_log_count - count) : 0;
+    EnableGlobalIRQ(primask);
+    Pool_Free(buf);
+#else
+    UART_Printf("[LOG   ] History off (LOG_IDLE_DROP)\r\n");
+#endif
+}
+
+/* Queues the summary of a finished run of repeats (count taken under IRQ lock) */
+static void Log_SendRepeats(uint8_t cls, uint16_t count) {
+    char rep[LOG_REPEAT_SIZE];
+    snprintf(rep, sizeof(rep), "[LOG   ] Last message repeated %u times\r\n", count);
+    Tx_Enqueue((UART_TxClass_t)cls, (uint8_t*)rep, strlen(rep));
+}
+
+/* Formats and queues one line; 'collapse' drops exact repeats of the last event line */
+static void UART_VPrintf(UART_TxClass_t cls, bool collapse, const char* fmt, va_list args) {
+    // No client: skip formatting and TX entirely
+    if (!UART_IsClientConnected()) {
+        Log_Record(fmt, args);
+        return;
+    }
+
+    // Line buffer from the pool (callers may be nested ISRs)
+    char* buf = Pool_Alloc(LOG_LINE_SIZE);
+    if (buf == NULL) {
+        g_tx_stats[cls].dropped++;
+        return;
+    }
+    vsnprintf(buf, LOG_LINE_SIZE, fmt, args);
+
+    if (!collapse) {
+        Tx_Enqueue(cls, (uint8_t*)buf, strlen(buf));
+        Pool_Free(buf);
+        return;
+    }
+
+    // Compare and update as one step (ISRs log too); queue outside the lock,
+    // since a full queue is drained by polling
+    uint8_t prevClass = 0;
+    uint16_t repeats = 0;
+    bool isRepeat = false;
+    uint32_t primask = DisableGlobalIRQ();
+    if (cls == g_repeat_class && strcmp(buf, g_last_line) == 0 && g_repeat_count < 0xFFFF) {
+        if (g_repeat_count++ == 0) g_repeat_start = GetTick();
+        isRepeat = true;
+    } else {
+        prevClass = g_repeat_class;
+        repeats = g_repeat_count;
+        g_repeat_count = 0;
+        strcpy(g_last_line, buf);
+        g_repeat_class = (uint8_t)cls;
+    }
+    EnableGlobalIRQ(primask);
+
+    if (!isRepeat) {
+        if (repeats > 0) Log_SendRepeats(prevClass, repeats);
+        Tx_Enqueue(cls, (uint8_t*)buf, strlen(buf));
+    }
+    Pool_Free(buf);
+}
 
 void UART_Printf(const char* fmt, ...) {
-    char buf[128];
     va_list args;
     va_start(args, fmt);
-    vsnprintf(buf, sizeof(buf), fmt, args);
+    UART_VPrintf(UART_TX_ADMIN, false, fmt, args);
+    va_end(args);
+}
+
+void UART_PrintfClass(UART_TxClass_t cls, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    UART_VPrintf(cls, false, fmt, args);
+    va_end(args);
+}
+
+void UART_LogClass(UART_TxClass_t cls, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    UART_VPrintf(cls, true, fmt, args);
     va_end(args);
-    
-    // Send 
-    UART_WriteBlocking(TARGET_UART, (uint8_t*)buf, strlen(buf));
 }
 
 void UART_Bluetooth_Init(void) {
     // 1. Enable Clocks
-    CLOCK_EnableClock(kCLOCK_PortD);
     CLOCK_EnableClock(kCLOCK_Uart2);
 
-    // 2. Configure Pins: PTD2=RX, PTD3=TX (Alt 3 for UART2)
-    PORT_SetPinMux(PORTD, 2U, kPORT_MuxAlt3); 
-    PORT_SetPinMux(PORTD, 3U, kPORT_MuxAlt3);
+    // 2. Pins (RX/TX = UART2, STATE = pulled-up input) are set by BoardPins_Init
 
     // 3. Configure UART2 for HC-05 (9600 Baud)
     uart_config_t config;
@@ -57,43 +538,102 @@ void UART_Bluetooth_Init(void) {
     EnableIRQ(TARGET_IRQ);
 }
 
-// Interrupt Handler for UART2
-void UART2_IRQHandler(void) {
-    uint8_t data;
-    uint32_t flags = UART_GetStatusFlags(TARGET_UART);
+/* Line editor for one received byte (UART2 ISR context) */
+static void Rx_Byte(uint8_t data) {
+    // Echo back to Phone (Optional, helps verify connection)
+    Tx_Enqueue(UART_TX_ADMIN, &data, 1);
 
-    // Check if RX Full
-    if ((flags & kUART_RxDataRegFullFlag) && !(flags & kUART_FramingErrorFlag)) {
-        data = UART_ReadByte(TARGET_UART);
-        
-        // Echo back to Phone (Optional, helps verify connection)
-        UART_WriteByte(TARGET_UART, data); 
-
-        // Handle Backspace/Delete
-        if (data == 0x08 || data == 0x7F) {
-            if (rx_index > 0) rx_index--;
+    if (g_rx_line == NULL) {
+        g_rx_line = Pool_Alloc(RX_BUFFER_SIZE);
+        rx_index = 0;
+        if (g_rx_line == NULL) {
+            g_rx_overflows++; // Pool exhausted: byte lost
             return;
         }
+    }
 
-        // Handle Enter (\r or \n)
-        if (data == '\r' || data == '\n') {
-            if (rx_index > 0) {
-                rx_buffer[rx_index] = 0; // Null terminate
-                Admin_ProcessCommand(rx_buffer); // Process Loop
-                rx_index = 0; // Reset
-            }
-        } 
-        else {
-            if (rx_index < RX_BUFFER_SIZE - 1) {
-                rx_buffer[rx_index++] = (char)data;
+    // Handle Backspace/Delete
+    if (data == 0x08 || data == 0x7F) {
+        if (rx_index > 0) rx_index--;
+        return;
+    }
+
+    // Handle Enter (\r or \n)
+    if (data == '\r' || data == '\n') {
+        if (rx_index > 0) {
+            g_rx_line[rx_index] = 0; // Null terminate
+            if ((uint8_t)(g_rx_head - g_rx_tail) < RX_LINE_SLOTS) {
+                // Hand the block over to the main loop
+                g_rx_ready[g_rx_head & (RX_LINE_SLOTS - 1)] = g_rx_line;
+                g_rx_head++;
+                g_rx_line = NULL;
             } else {
-                rx_index = 0; // Overflow protection
+                g_rx_overflows++; // Main loop behind: line dropped
             }
+            rx_index = 0; // Reset
+        }
+    } 
+    else {
+        if (rx_index < RX_BUFFER_SIZE - 1) {
+            g_rx_line[rx_index++] = (char)data;
+        } else {
+            rx_index = 0; // Overflow protection
+            g_rx_overflows++;
+        }
+    }
+}
+
+void UART_Tick(void) {
+    // A run of repeats still going on: report it instead of waiting for a new line
+    if (g_repeat_count > 0) {
+        uint16_t repeats = 0;
+        uint32_t primask = DisableGlobalIRQ();
+        if (IsTimeout(g_repeat_start, LOG_REPEAT_FLUSH_MS)) {
+            repeats = g_repeat_count;
+            g_repeat_count = 0;
         }
+        uint8_t cls = g_repeat_class;
+        EnableGlobalIRQ(primask);
+        if (repeats > 0) Log_SendRepeats(cls, repeats);
+    }
+
+    if (g_rx_tail == g_rx_head) return;
+
+    // One command per loop pass; the block now belongs to this context
+    char* line = g_rx_ready[g_rx_tail & (RX_LINE_SLOTS - 1)];
+    g_rx_tail++;
+
+    Supervisor_TaskBegin(SUP_TASK_ADMIN);
+    Admin_ProcessCommand(line);
+    Supervisor_TaskEnd(SUP_TASK_ADMIN);
+    Pool_Free(line);
+}
+
+#if SELFTEST_ENABLE
+void UART_InjectRx(uint8_t data) {
+    DisableIRQ(TARGET_IRQ); // Rx_Byte owns the line buffer as if in the ISR
+    Rx_Byte(data);
+    EnableIRQ(TARGET_IRQ);
+}
+#endif
+
+// Interrupt Handler for UART2
+void UART2_IRQHandler(void) {
+    uint32_t flags = UART_GetStatusFlags(TARGET_UART);
+
+    // TX: Feed next queued byte
+    if ((flags & kUART_TxDataRegEmptyFlag) && (TARGET_UART->C2 & UART_C2_TIE_MASK)) {
+        Tx_Service();
+    }
+
+    // Check if RX Full
+    if ((flags & kUART_RxDataRegFullFlag) && !(flags & kUART_FramingErrorFlag)) {
+        Rx_Byte(UART_ReadByte(TARGET_UART));
     }
     
     // Clear functional errors (OR, NF, FE, PF)
     if (flags & (kUART_FramingErrorFlag | kUART_RxOverrunFlag | kUART_NoiseErrorFlag | kUART_ParityErrorFlag)) {
+         if (flags & kUART_RxOverrunFlag) g_rx_overflows++;
          // Clear all error flags
          UART_ClearStatusFlags(TARGET_UART, kUART_FramingErrorFlag | kUART_RxOverrunFlag | kUART_NoiseErrorFlag | kUART_ParityErrorFlag);
     }
@@ -2,13 +2,67 @@
 #define UART_DRIVER_H
 
 #include <stdint.h>
+#include <stdbool.h>
+
+// Logging while no Bluetooth client is connected:
+// LOG_IDLE_RECORD keeps compact binary events for HISTORY, LOG_IDLE_DROP keeps nothing.
+#define LOG_IDLE_DROP    0
+#define LOG_IDLE_RECORD  1
+#ifndef LOG_IDLE_MODE
+#define LOG_IDLE_MODE    LOG_IDLE_RECORD
+#endif
 
 // Initialize UART (Enable Interrupts)
 void UART_Bluetooth_Init(void);
 
-// Helper to Tick input if not fully IRQ based (Optional)
+// Main loop: runs the next complete admin line received by the ISR
+void UART_Tick(void);
+
+// TX Priority Classes (lower value = higher priority)
+typedef enum {
+    UART_TX_ALARM = 0,  // Alarm / Brute Force notifications
+    UART_TX_ACCESS,     // Access granted/denied events
+    UART_TX_ADMIN,      // Admin replies & dumps (default)
+    UART_TX_DEBUG,      // Key echoes, diagnostics (dropped when full)
+    UART_TX_CLASSES
+} UART_TxClass_t;
+
+// Per-Class TX Statistics
+typedef struct {
+    uint16_t depth;           // Bytes queued now
+    uint16_t max_depth;       // High-water mark (bytes)
+    uint16_t max_latency_ms;  // Worst enqueue -> first byte on wire
+    uint32_t frames;          // Frames sent
+    uint32_t dropped;         // Frames dropped (queue full)
+} UART_TxStats_t;
 
 // Send Formatted String to Bluetooth (PRINTF replacement)
+// While disconnected, only records fmt + args (formatted later by UART_PrintHistory).
+// Output is queued in the UART_TX_ADMIN class.
 void UART_Printf(const char* fmt, ...);
 
+// Same as UART_Printf, queued in the given priority class
+void UART_PrintfClass(UART_TxClass_t cls, const char* fmt, ...);
+
+// Event line (LOG()): exact repeats of the last event line are counted, not sent;
+// the count follows as "Last message repeated N times" (next line or UART_Tick, 2s)
+void UART_LogClass(UART_TxClass_t cls, const char* fmt, ...);
+
+// TX Statistics (per class)
+void UART_GetTxStats(UART_TxClass_t cls, UART_TxStats_t* out);
+void UART_PrintTxStats(void);
+
+// RX line-buffer overruns and hardware overruns since boot (also shown by TXSTATS)
+uint32_t UART_GetRxOverflows(void);
+
+// Self-Test: feed one byte to the RX line editor as if received
+void UART_InjectRx(uint8_t data);
+
+// HC-05 STATE pin (True = Phone Paired & Connected)
+bool UART_IsClientConnected(void);
+
+// Format & send the events buffered while disconnected, then clear them.
+// Formats that do not fit the record (over 4 words, 64-bit or float args) are shown unformatted.
+void UART_PrintHistory(void);
+
 #endif // UART_DRIVER_H
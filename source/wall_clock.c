@@ -0,0 +1,69 @@
+/*
+ * wall_clock.c
+ *
+ * [WALL CLOCK - RTC]
+ * The board's ER32K source is the 1kHz LPO, which is too coarse for the RTC.
+ * The 32kHz slow IRC is routed out on CLKOUT (PTC3) and back into
+ * RTC_CLKIN (PTC1) through a jumper wire (standard FRDM-KL25Z trick).
+ */
+
+#include "wall_clock.h"
+#include "fsl_port.h"
+#include "fsl_clock.h"
+#include "MKL25Z4.h"
+
+#define SECONDS_PER_HOUR  3600U
+#define HOURS_PER_DAY     24U
+#define EPOCH_WEEKDAY     3U    // 1970-01-01 was a Thursday (Monday = 0)
+
+// Slot Cache (avoids software divides on the auth hot path)
+static uint32_t g_cached_sec = 0xFFFFFFFFU;
+static int g_cached_slot = -1;
+
+void WallClock_Init(void) {
+    // 1. 32kHz Slow IRC -> CLKOUT (PTC3)
+    MCG->C1 |= MCG_C1_IRCLKEN_MASK | MCG_C1_IREFSTEN_MASK;
+    MCG->C2 &= ~MCG_C2_IRCS_MASK;
+    SIM->SOPT2 = (SIM->SOPT2 & ~SIM_SOPT2_CLKOUTSEL_MASK) | SIM_SOPT2_CLKOUTSEL(4); // MCGIRCLK
+    // CLKOUT / RTC_CLKIN pins are set by BoardPins_Init
+
+    // 2. RTC clocked from RTC_CLKIN
+    SIM->SOPT1 = (SIM->SOPT1 & ~SIM_SOPT1_OSC32KSEL_MASK) | SIM_SOPT1_OSC32KSEL(2);
+    SIM->SCGC6 |= SIM_SCGC6_RTC_MASK;
+
+    // 3. Leave the counter stopped after POR (TIF set) until the admin sets the time
+    if (!(RTC->SR & RTC_SR_TIF_MASK)) {
+        RTC->SR |= RTC_SR_TCE_MASK;
+    }
+}
+
+void WallClock_SetTime(uint32_t unixSeconds) {
+    RTC->SR &= ~RTC_SR_TCE_MASK;  // TSR is writable only while stopped
+    RTC->TPR = 0;
+    RTC->TSR = unixSeconds;       // Clears TIF
+    RTC->SR |= RTC_SR_TCE_MASK;
+    g_cached_sec = 0xFFFFFFFFU;
+}
+
+bool WallClock_IsSet(void) {
+    return !(RTC->SR & RTC_SR_TIF_MASK) && (RTC->SR & RTC_SR_TCE_MASK);
+}
+
+uint32_t WallClock_GetTime(void) {
+    if (!WallClock_IsSet()) return 0;
+    return RTC->TSR;
+}
+
+int WallClock_GetWeekSlot(void) {
+    uint32_t now = WallClock_GetTime();
+    if (now == 0) return -1;
+
+    if (now != g_cached_sec) {
+        uint32_t hours = now / SECONDS_PER_HOUR;
+        uint32_t days = hours / HOURS_PER_DAY;
+        uint32_t weekday = (days + EPOCH_WEEKDAY) % 7U;
+        g_cached_slot = (int)(weekday * HOURS_PER_DAY + (hours - days * HOURS_PER_DAY));
+        g_cached_sec = now;
+    }
+    return g_cached_slot;
+}
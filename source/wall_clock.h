@@ -0,0 +1,29 @@
+/*
+ * wall_clock.h
+ *
+ * RTC-backed Wall Clock (Unix Seconds).
+ */
+
+#ifndef WALL_CLOCK_H
+#define WALL_CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Initialize RTC (32kHz MCGIRCLK -> CLKOUT PTC3 -> jumper -> RTC_CLKIN PTC1)
+void WallClock_Init(void);
+
+// Set time (Unix seconds, local time). Starts the counter.
+void WallClock_SetTime(uint32_t unixSeconds);
+
+// Returns Unix seconds, or 0 if the clock was never set since power-up
+uint32_t WallClock_GetTime(void);
+
+// True once the time has been set (survives warm resets)
+bool WallClock_IsSet(void);
+
+// Hour of week: 0 = Monday 00:00-00:59 ... 167 = Sunday 23:xx.
+// Returns -1 if the clock is not set. Cached: recomputed once per second.
+int WallClock_GetWeekSlot(void);
+
+#endif // WALL_CLOCK_H
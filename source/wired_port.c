@@ -0,0 +1,88 @@
+/*
+ * wired_port.c
+ *
+ * [WIRED PROVISIONING PORT]
+ * Polled line reader on UART0 (LPSCI). No echo, no history: the line is
+ * wiped as soon as it has been handled, and the key never reaches the
+ * Bluetooth log.
+ */
+
+#include "wired_port.h"
+#include "admin_auth.h"
+#include "log_mgr.h"
+#include "fsl_lpsci.h"
+#include "fsl_clock.h"
+#include "MKL25Z4.h"
+#include <string.h>
+
+#define WIRED_BAUD       115200U
+#define WIRED_LINE_SIZE  48      // "ADMINKEY " + 32 hex
+#define WIRED_CMD_KEY    "ADMINKEY "
+
+static char g_line[WIRED_LINE_SIZE];
+static uint8_t g_len = 0;
+
+// ============================================================================
+// INTERNAL HELPERS
+// ============================================================================
+static void Reply(const char* s) {
+    LPSCI_WriteBlocking(UART0, (const uint8_t*)s, strlen(s));
+}
+
+static void Run_Line(void) {
+    uint8_t key[ADMIN_KEY_LEN];
+
+    if (strncmp(g_line, WIRED_CMD_KEY, sizeof(WIRED_CMD_KEY) - 1) != 0 ||
+        !AdminAuth_ParseKey(&g_line[sizeof(WIRED_CMD_KEY) - 1], key)) {
+        Reply("ERR: Usage ADMINKEY <32 hex>\r\n");
+        return;
+    }
+
+    if (AdminAuth_SetKey(key)) {
+        Reply(AdminAuth_IsProvisioned() ? "OK: key installed, counter reset\r\n" : "OK: LOGIN sessions restored\r\n");
+        LOG(ADMIN, INFO, "Admin key changed on the wired port.\r\n");
+    } else {
+        Reply("ERR: Flash save failed\r\n");
+    }
+    memset(key, 0, sizeof(key));
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+void WiredPort_Init(void) {
+    lpsci_config_t config;
+    CLOCK_SetLpsci0Clock(1); // PLLFLLSEL clock, as the SDK debug console
+    LPSCI_GetDefaultConfig(&config);
+    config.baudRate_Bps = WIRED_BAUD;
+    config.enableTx = true;
+    config.enableRx = true;
+    LPSCI_Init(UART0, &config, CLOCK_GetPllFllSelClkFreq());
+}
+
+void WiredPort_Tick(void) {
+    uint32_t flags = LPSCI_GetStatusFlags(UART0);
+    if (flags & kLPSCI_RxOverrunFlag) {
+        LPSCI_ClearStatusFlags(UART0, kLPSCI_RxOverrunFlag);
+        g_len = WIRED_LINE_SIZE; // Bytes lost: discard the line
+    }
+
+    while (LPSCI_GetStatusFlags(UART0) & kLPSCI_RxDataRegFullFlag) {
+        char c = (char)LPSCI_ReadByte(UART0);
+
+        if (c == '\r' || c == '\n') {
+            if (g_len > 0 && g_len < WIRED_LINE_SIZE) {
+                g_line[g_len] = 0;
+                Run_Line();
+            } else if (g_len != 0) {
+                Reply("ERR: Line too long\r\n");
+            }
+            memset(g_line, 0, sizeof(g_line));
+            g_len = 0;
+        } else if (g_len < WIRED_LINE_SIZE - 1) {
+            g_line[g_len++] = c;
+        } else {
+            g_len = WIRED_LINE_SIZE; // Overlong: dropped at the line end
+        }
+    }
+}
@@ -0,0 +1,19 @@
+/*
+ * wired_port.h
+ *
+ * Wired Provisioning Port: OpenSDA USB serial (UART0, 115200 8N1).
+ * The only path that accepts a plaintext admin key. Over Bluetooth a new
+ * key must arrive wrapped under the current one (see admin_auth.h).
+ * Command: ADMINKEY <32 hex>  (all zero = back to LOGIN sessions)
+ */
+
+#ifndef WIRED_PORT_H
+#define WIRED_PORT_H
+
+// Configure UART0 (pins are muxed by BOARD_InitBootPins)
+void WiredPort_Init(void);
+
+// Main loop: polls received bytes, runs a complete line
+void WiredPort_Tick(void);
+
+#endif // WIRED_PORT_H
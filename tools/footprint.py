@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""
+footprint.py
+
+[FOOTPRINT REPORT]
+Per-module Flash/RAM usage from a GNU ld map file (after --gc-sections,
+so only what was actually linked is counted). Run by the Release
+post-build step; usable by hand on any map:
+
+    python3 tools/footprint.py Release/MKL25Z4_SecuritySystem.map
+
+Flash = code + read-only data + initial values of .data.
+RAM   = .data + .bss + .noinit (stack/heap are reported by the linker).
+"""
+
+import re
+import sys
+from collections import defaultdict
+
+# Output section -> (counts in Flash, counts in RAM)
+def classify(section):
+    if section.startswith(('.text', '.rodata', '.ARM', '.init', '.fini', '.isr_vector')):
+        return True, False
+    if section.startswith('.data'):
+        return True, True
+    if section.startswith(('.bss', '.noinit', 'COMMON')):
+        return False, True
+    return False, False
+
+def module_name(path):
+    path = path.strip().replace('\\', '/')
+    m = re.match(r'(.*/)?([^/(]+\.a)\((.+)\)$', path)
+    if m:
+        return m.group(2)                       # Library: one line per archive
+    if path.startswith('./'):
+        path = path[2:]
+    return re.sub(r'\.o(bj)?$', '', path)
+
+def parse(lines):
+    regions = {}
+    usage = defaultdict(lambda: [0, 0])         # module -> [flash, ram]
+    out_section = None
+    pending = None                              # Input section name wrapped onto the next line
+    state = 'head'
+
+    for line in lines:
+        line = line.rstrip('\n')
+        if line.startswith('Memory Configuration'):
+            state = 'regions'
+            continue
+        if line.startswith('Linker script and memory map'):
+            state = 'map'
+            continue
+
+        if state == 'regions':
+            m = re.match(r'(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)', line)
+            if m and m.group(1) != '*default*':
+                regions[m.group(1)] = int(m.group(3), 16)
+            continue
+        if state != 'map' or not line:
+            continue
+
+        if not line[0].isspace():               # Output section header
+            out_section = line.split()[0]
+            pending = None
+            continue
+
+        fields = line.split()
+        if len(fields) == 1 and (fields[0].startswith('.') or fields[0] == 'COMMON'):
+            pending = fields[0]
+            continue
+        if pending is not None and fields[0].startswith('0x'):
+            fields = [pending] + fields
+        pending = None
+
+        if len(fields) < 4 or not fields[1].startswith('0x') or not fields[2].startswith('0x'):
+            continue
+        name, size, obj = fields[0], int(fields[2], 16), ' '.join(fields[3:])
+        if size == 0 or out_section is None:
+            continue
+        if name == '*fill*':
+            obj = '(alignment fill)'
+
+        flash, ram = classify(out_section)
+        if name == 'COMMON':
+            flash, ram = False, True
+        mod = module_name(obj)
+        if flash:
+            usage[mod][0] += size
+        if ram:
+            usage[mod][1] += size
+
+    return regions, usage
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit('usage: footprint.py <file.map>')
+    with open(sys.argv[1], errors='replace') as f:
+        regions, usage = parse(f)
+
+    rows = sorted(usage.items(), key=lambda kv: (-kv[1][0], -kv[1][1], kv[0]))
+    total_flash = sum(v[0] for _, v in rows)
+    total_ram = sum(v[1] for _, v in rows)
+
+    width = max([len('Module')] + [len(k) for k, _ in rows])
+    print('%-*s  %8s  %8s' % (width, 'Module', 'Flash', 'RAM'))
+    print('-' * (width + 20))
+    for mod, (flash, ram) in rows:
+        if flash or ram:
+            print('%-*s  %8u  %8u' % (width, mod, flash, ram))
+    print('-' * (width + 20))
+    print('%-*s  %8u  %8u' % (width, 'Total', total_flash, total_ram))
+
+    # Budget against the memory regions of the link (names as in the MCUXpresso script).
+    # PROGRAM_FLASH ends at 0x1B000: the audit ring, journal and config sectors
+    # above it are not part of the link, so they never count as free space.
+    flash_size = sum(v for k, v in regions.items() if 'FLASH' in k.upper())
+    ram_size = sum(v for k, v in regions.items() if 'RAM' in k.upper())
+    if flash_size:
+        print('Flash free: %u of %u bytes (code region; data sectors reserved)' % (flash_size - total_flash, flash_size))
+    if ram_size:
+        print('RAM free:   %u of %u bytes (before stack/heap)' % (ram_size - total_ram, ram_size))
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,427 @@
+/*
+ * accel_check.c
+ *
+ * [ACCELEROMETER REGISTER MODEL]
+ * Runs the real accel_driver.c on the host against a register model of
+ * the MMA8451Q. The model takes the place of i2c_driver.c (I2C_WriteReg /
+ * I2C_ReadRegs) and simulates the parts of the sensor the driver uses:
+ * Standby-only registers, the high-pass transient engine feeding a
+ * trigger-mode FIFO, the X/Y motion engine, clear-on-read latches and INT1
+ * (active low on PTA14, raising the PORTA interrupt on a falling edge).
+ * Each scenario feeds 50 Hz samples, ticks the driver every 1 ms and checks
+ * the classification and the bus traffic.
+ *
+ * Build and run from the repository root:
+ *
+ *   gcc -std=gnu99 -O2 -DCPU_MKL25Z128VLK4 -D__REDLIB__ -ICMSIS -Idrivers \
+ *       -Iboard -Iutilities -Isource tools/host/accel_check.c -o accel_check
+ *   ./accel_check [-v]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+// Host PORTA / GPIOA: the driver configures the INT1 pin and polls its level
+#include "MKL25Z4.h"
+#undef PORTA
+#undef GPIOA
+static PORT_Type g_hostPortA;
+static struct { uint32_t PDOR, PSOR, PCOR, PTOR, PDIR, PDDR; } g_hostGpioA; // PDIR writable
+#define PORTA (&g_hostPortA)
+#define GPIOA (&g_hostGpioA)
+
+#define ACCEL_ENABLE 1
+#include "accel_driver.c"
+
+// ============================================================================
+// MMA8451Q MODEL
+// ============================================================================
+#define MODEL_REGS          0x32
+#define SAMPLE_MS           20U     // 50 Hz output data rate
+#define ENGINE_TO_SAMPLE    4       // 0.063 g engine count = ~4 sample counts (1/64 g)
+#define HPF_SHIFT           3       // Transient high-pass: x - mean(x), mean tau ~8 samples
+
+#define SRC_TRANS           0x20U
+#define EA                  0x40U   // Event Active (TRANSIENT_SRC / FF_MT_SRC)
+#define F_OVF               0x80U
+#define CTRL1_ACTIVE        0x01U
+#define CTRL1_F_READ        0x02U
+#define TRIG_TRANS          0x20U
+
+typedef struct {
+    uint8_t regs[MODEL_REGS];
+    int8_t fifo[ACCEL_FIFO_SAMPLES][3];
+    uint8_t fifoCount;
+    bool triggered;
+    int32_t hpMean[3];      // Q8 running mean for the high-pass filter
+    bool hpSeeded;          // Mean starts at the first sample after going active
+    uint8_t motionCount;    // FF_MT debounce counter
+    bool present;
+    bool intLine;           // INT1 level (true = high / idle)
+    // Bus and rule checks
+    uint32_t transactions;
+    uint32_t bytesRead;
+    uint32_t standbyViolations;
+} Mma_t;
+
+static Mma_t g_mma;
+static bool g_verbose;
+static char g_lastLog[160];
+
+static bool Mma_Active(void) { return (g_mma.regs[REG_CTRL_REG1] & CTRL1_ACTIVE) != 0U; }
+
+/* INT1 = any enabled source routed to INT1; a falling edge runs the PORTA ISR */
+static void Mma_UpdateInt(void) {
+    uint8_t routed = g_mma.regs[REG_INT_SOURCE] & g_mma.regs[REG_CTRL_REG4] & g_mma.regs[REG_CTRL_REG5];
+    bool line = (routed == 0U);
+    bool fell = g_mma.intLine && !line;
+    g_mma.intLine = line;
+
+    if (line) g_hostGpioA.PDIR |= BOARD_MASK(ACCEL_INT);
+    else g_hostGpioA.PDIR &= ~BOARD_MASK(ACCEL_INT);
+
+    uint32_t irqc = (g_hostPortA.PCR[BOARD_PIN(ACCEL_INT)] & PORT_PCR_IRQC_MASK) >> PORT_PCR_IRQC_SHIFT;
+    if (fell && irqc == kPORT_InterruptFallingEdge) {
+        g_hostPortA.ISFR |= BOARD_MASK(ACCEL_INT);
+        Accel_PortIrq();
+        g_hostPortA.ISFR = 0; // W1C on hardware; the ISR only ever clears its own pin
+    }
+}
+
+static void Mma_Reset(bool present) {
+    memset(&g_mma, 0, sizeof(g_mma));
+    memset(&g_hostPortA, 0, sizeof(g_hostPortA));
+    memset(&g_hostGpioA, 0, sizeof(g_hostGpioA));
+    g_mma.regs[REG_WHO_AM_I] = MMA_WHO_AM_I_VAL;
+    g_mma.present = present;
+    g_mma.intLine = true;
+    g_hostGpioA.PDIR = BOARD_MASK(ACCEL_INT); // Pulled up
+}
+
+static void Fifo_Push(const int8_t s[3]) {
+    uint8_t mode = g_mma.regs[REG_F_SETUP] >> 6;
+    if (mode == 0U) return;
+
+    if (g_mma.triggered) {
+        if (g_mma.fifoCount == ACCEL_FIFO_SAMPLES) return; // Frozen until re-armed
+    } else {
+        // Before the trigger only the newest F_WMRK samples are kept
+        uint8_t keep = g_mma.regs[REG_F_SETUP] & F_CNT_MASK;
+        if (keep == 0U) return;
+        if (g_mma.fifoCount >= keep) {
+            memmove(g_mma.fifo[0], g_mma.fifo[1], (size_t)(g_mma.fifoCount - 1U) * 3U);
+            g_mma.fifoCount--;
+        }
+    }
+    memcpy(g_mma.fifo[g_mma.fifoCount++], s, 3);
+
+    if (g_mma.triggered && g_mma.fifoCount == ACCEL_FIFO_SAMPLES) {
+        g_mma.regs[REG_INT_SOURCE] |= SRC_FIFO;
+    }
+}
+
+/* One output sample (1/64 g per count): engines first, then the FIFO */
+static void Mma_Sample(int x, int y, int z) {
+    int8_t s[3] = { (int8_t)x, (int8_t)y, (int8_t)z };
+    if (!Mma_Active()) return;
+
+    // Transient: high-pass magnitude on enabled axes (bits 1..3 = X, Y, Z)
+    uint8_t tcfg = g_mma.regs[REG_TRANSIENT_CFG];
+    int tths = (g_mma.regs[REG_TRANSIENT_THS] & 0x7F) * ENGINE_TO_SAMPLE;
+    bool transient = false;
+    if (!g_mma.hpSeeded) {
+        for (int a = 0; a < 3; a++) g_mma.hpMean[a] = (int32_t)s[a] * 256;
+        g_mma.hpSeeded = true;
+    }
+    for (int a = 0; a < 3; a++) {
+        int hp = s[a] - (g_mma.hpMean[a] >> 8);
+        g_mma.hpMean[a] += ((int32_t)s[a] * 256 - g_mma.hpMean[a]) >> HPF_SHIFT;
+        if ((tcfg & (0x02U << a)) && Abs(hp) > tths) transient = true;
+    }
+    if (transient) {
+        g_mma.regs[REG_TRANSIENT_SRC] |= EA;
+        g_mma.regs[REG_INT_SOURCE] |= SRC_TRANS;
+        if (!g_mma.triggered && (g_mma.regs[REG_TRIG_CFG] & TRIG_TRANS) && (g_mma.regs[REG_F_SETUP] >> 6) == 3U) {
+            g_mma.triggered = true;
+        }
+    }
+
+    // Motion: X/Y above threshold for FF_MT_COUNT samples (DBCNTM = reset on drop)
+    uint8_t mcfg = g_mma.regs[REG_FF_MT_CFG];
+    int mths = (g_mma.regs[REG_FF_MT_THS] & 0x7F) * ENGINE_TO_SAMPLE;
+    bool over = ((mcfg & 0x08U) && Abs(s[0]) > mths) || ((mcfg & 0x10U) && Abs(s[1]) > mths);
+    if (over) {
+        if (g_mma.motionCount < 0xFF) g_mma.motionCount++;
+        if (g_mma.motionCount >= g_mma.regs[REG_FF_MT_COUNT]) {
+            g_mma.regs[REG_FF_MT_SRC] |= EA;
+            g_mma.regs[REG_INT_SOURCE] |= SRC_FF_MT;
+        }
+    } else {
+        g_mma.motionCount = 0;
+    }
+
+    Fifo_Push(s);
+    Mma_UpdateInt();
+}
+
+static uint8_t Mma_ReadByte(uint8_t reg) {
+    uint8_t v = g_mma.regs[reg];
+    switch (reg) {
+    case REG_F_STATUS:
+        v = (uint8_t)((g_mma.fifoCount == ACCEL_FIFO_SAMPLES && g_mma.triggered ? F_OVF : 0U) | g_mma.fifoCount);
+        g_mma.regs[REG_INT_SOURCE] &= (uint8_t)~SRC_FIFO;
+        break;
+    case REG_TRANSIENT_SRC:
+        g_mma.regs[REG_TRANSIENT_SRC] = 0;
+        g_mma.regs[REG_INT_SOURCE] &= (uint8_t)~SRC_TRANS;
+        break;
+    case REG_FF_MT_SRC:
+        g_mma.regs[REG_FF_MT_SRC] = 0;
+        g_mma.regs[REG_INT_SOURCE] &= (uint8_t)~SRC_FF_MT;
+        break;
+    default:
+        break;
+    }
+    return v;
+}
+
+static void Mma_WriteByte(uint8_t reg, uint8_t value) {
+    bool active = Mma_Active();
+    switch (reg) {
+    case REG_CTRL_REG1:
+        // Only ACTIVE may change while active
+        if (active && ((value ^ g_mma.regs[reg]) & (uint8_t)~CTRL1_ACTIVE)) g_mma.standbyViolations++;
+        if (!(value & CTRL1_ACTIVE)) g_mma.hpSeeded = false;
+        break;
+    case REG_F_SETUP:
+        // Active: F_MODE may only go to or from 00 (cleared FIFO in between)
+        if (active && (value >> 6) != 0U && (g_mma.regs[reg] >> 6) != 0U) g_mma.standbyViolations++;
+        if ((value >> 6) == 0U) {
+            g_mma.fifoCount = 0;
+            g_mma.triggered = false;
+        }
+        break;
+    case REG_XYZ_DATA_CFG: case REG_TRIG_CFG: case REG_FF_MT_CFG: case REG_FF_MT_THS:
+    case REG_FF_MT_COUNT: case REG_TRANSIENT_CFG: case REG_TRANSIENT_THS: case REG_TRANSIENT_COUNT:
+    case REG_CTRL_REG2: case REG_CTRL_REG4: case REG_CTRL_REG5:
+        if (active) g_mma.standbyViolations++;
+        break;
+    default:
+        g_mma.standbyViolations++; // Read-only or unmodelled
+        return;
+    }
+    g_mma.regs[reg] = value;
+}
+
+// ============================================================================
+// I2C STAND-IN (replaces i2c_driver.c)
+// ============================================================================
+void I2C_Init(void) {}
+
+bool I2C_WriteReg(uint8_t devAddr, uint8_t reg, uint8_t value) {
+    g_mma.transactions++;
+    if (!g_mma.present || devAddr != MMA_ADDR || reg >= MODEL_REGS) return false;
+    Mma_WriteByte(reg, value);
+    Mma_UpdateInt();
+    return true;
+}
+
+bool I2C_ReadRegs(uint8_t devAddr, uint8_t reg, uint8_t* buf, uint16_t len) {
+    g_mma.transactions++;
+    if (!g_mma.present || devAddr != MMA_ADDR || reg >= MODEL_REGS) return false;
+    g_mma.bytesRead += len;
+
+    bool fifoRead = (reg == REG_OUT_X_MSB) && (g_mma.regs[REG_F_SETUP] >> 6) != 0U &&
+                    (g_mma.regs[REG_CTRL_REG1] & CTRL1_F_READ);
+    for (uint16_t i = 0; i < len; i++) {
+        if (fifoRead) {
+            // F_READ: X,Y,Z of each FIFO entry in turn, the address stays in the data block
+            uint8_t axis = (uint8_t)(i % 3U);
+            buf[i] = g_mma.fifoCount ? (uint8_t)g_mma.fifo[0][axis] : 0U;
+            if (axis == 2U && g_mma.fifoCount) {
+                memmove(g_mma.fifo[0], g_mma.fifo[1], (size_t)(g_mma.fifoCount - 1U) * 3U);
+                g_mma.fifoCount--;
+            }
+        } else {
+            buf[i] = Mma_ReadByte((uint8_t)((reg + i) % MODEL_REGS));
+        }
+    }
+    Mma_UpdateInt();
+    return true;
+}
+
+// ============================================================================
+// OTHER STUBS
+// ============================================================================
+uint8_t g_logLevel[LOG_CATEGORIES] = { LOG_LVL_DEBUG, LOG_LVL_DEBUG, LOG_LVL_DEBUG, LOG_LVL_DEBUG,
+                                       LOG_LVL_DEBUG, LOG_LVL_DEBUG, LOG_LVL_DEBUG };
+
+void UART_LogClass(UART_TxClass_t cls, const char* format, ...) {
+    va_list args;
+    (void)cls;
+    va_start(args, format);
+    vsnprintf(g_lastLog, sizeof(g_lastLog), format, args);
+    va_end(args);
+    if (g_verbose) printf("    %s", g_lastLog);
+}
+
+// ============================================================================
+// SCENARIOS
+// ============================================================================
+typedef void (*Motion_t)(uint32_t n, int xyz[3]);
+
+static uint32_t g_noise;
+
+/* Board flat and still: Z = 1 g, +/-1 count of noise */
+static void At_Rest(int xyz[3]) {
+    for (int a = 0; a < 3; a++) {
+        g_noise = g_noise * 1103515245U + 12345U;
+        xyz[a] = (int)((g_noise >> 16) % 3U) - 1;
+    }
+    xyz[2] += 64;
+}
+
+static void Still(uint32_t n, int xyz[3]) { (void)n; At_Rest(xyz); }
+
+/* Door slam: one sharp knock that dies out in ~60 ms */
+static void Slam(uint32_t n, int xyz[3]) {
+    static const int knock[] = { 0, 60, -45, 20 };
+    At_Rest(xyz);
+    if (n >= 50 && n < 54) { xyz[0] += knock[n - 50]; xyz[2] -= knock[n - 50] / 2; }
+}
+
+/* Pry bar: a jolt every 100 ms for a second */
+static void Pry(uint32_t n, int xyz[3]) {
+    At_Rest(xyz);
+    if (n >= 50 && n < 100 && (n % 5U) < 2U) { xyz[1] += (n & 1U) ? 50 : -50; }
+}
+
+/* Knocked off the wall: a jolt, then it settles ~25 deg tilted on X */
+static void Knocked(uint32_t n, int xyz[3]) {
+    At_Rest(xyz);
+    if (n >= 50 && n < 53) xyz[0] += 55;
+    else if (n >= 53) { xyz[0] += 27; xyz[2] -= 6; }
+}
+
+/* Slow lift: tilts ~45 deg on Y over 2 s, never a jolt */
+static void Lift(uint32_t n, int xyz[3]) {
+    At_Rest(xyz);
+    if (n >= 50) {
+        int t = (n - 50 > 100U) ? 100 : (int)(n - 50);
+        xyz[1] += 45 * t / 100;
+        xyz[2] -= 19 * t / 100;
+    }
+}
+
+typedef struct {
+    AccelClass_t cls;       // Most severe result seen
+    uint32_t traffic;       // I2C transactions while running
+    uint32_t bytes;
+} Result_t;
+
+static Result_t Run(Motion_t motion, uint32_t samples) {
+    Result_t r = { ACCEL_NONE, 0, 0 };
+    uint32_t t0 = g_mma.transactions, b0 = g_mma.bytesRead;
+    for (uint32_t ms = 0; ms < samples * SAMPLE_MS; ms++) {
+        if (ms % SAMPLE_MS == 0U) {
+            int xyz[3];
+            motion(ms / SAMPLE_MS, xyz);
+            Mma_Sample(xyz[0], xyz[1], xyz[2]);
+        }
+        Accel_Tick();
+        AccelClass_t cls = Accel_CheckEvent();
+        if (cls > r.cls) r.cls = cls;
+    }
+    r.traffic = g_mma.transactions - t0;
+    r.bytes = g_mma.bytesRead - b0;
+    return r;
+}
+
+static int g_failures;
+
+static void Expect(const char* name, bool ok, const char* detail) {
+    printf("  %-50s %s", name, ok ? "ok" : "FAIL");
+    if (!ok && detail) printf("  (%s)", detail);
+    printf("\n");
+    if (!ok) g_failures++;
+}
+
+static const char* Class_Name(AccelClass_t cls) {
+    static const char* const names[] = { "NONE", "AMBIENT", "TAMPER_PRY", "TAMPER_MOVED" };
+    return names[cls];
+}
+
+static void Start(void) {
+    Mma_Reset(true);
+    g_present = false;
+    g_accelIrq = false;
+    g_lastClass = ACCEL_NONE;
+    g_noise = 1;
+    Accel_Init();
+    Run(Still, 50); // Settle the high-pass filter
+}
+
+static void Check_Capture(const char* name, Motion_t motion, AccelClass_t want) {
+    char detail[96];
+    Start();
+    Result_t r = Run(motion, 150);
+    snprintf(detail, sizeof(detail), "got %s", Class_Name(r.cls));
+    Expect(name, r.cls == want, detail);
+}
+
+int main(int argc, char** argv) {
+    char detail[96];
+    g_verbose = (argc > 1 && strcmp(argv[1], "-v") == 0);
+
+    printf("Init\n");
+    Mma_Reset(false);
+    Expect("absent sensor reported", !Accel_Init(), NULL);
+    Start();
+    Expect("sensor found, active at 50 Hz with F_READ",
+           g_present && g_mma.regs[REG_CTRL_REG1] == (CTRL1_50HZ_FREAD | CTRL1_ACTIVE), NULL);
+    Expect("FIFO in trigger mode, 16 pre-trigger samples",
+           g_mma.regs[REG_F_SETUP] == (F_SETUP_TRIGGER | F_PRE_TRIGGER) && (g_mma.regs[REG_TRIG_CFG] & TRIG_TRANS), NULL);
+    Expect("FIFO + motion routed to INT1, falling edge IRQ",
+           (g_mma.regs[REG_CTRL_REG4] & g_mma.regs[REG_CTRL_REG5]) == INT_FIFO_FF_MT &&
+           ((g_hostPortA.PCR[BOARD_PIN(ACCEL_INT)] & PORT_PCR_IRQC_MASK) >> PORT_PCR_IRQC_SHIFT) == kPORT_InterruptFallingEdge, NULL);
+    Expect("no writes to Standby-only registers while active", g_mma.standbyViolations == 0U, NULL);
+
+    printf("Quiet\n");
+    Start();
+    Result_t r = Run(Still, 500);
+    snprintf(detail, sizeof(detail), "%u transactions, %s", r.traffic, Class_Name(r.cls));
+    Expect("10 s at rest: no bus traffic, no event", r.traffic == 0U && r.cls == ACCEL_NONE, detail);
+
+    printf("Captures\n");
+    Start();
+    r = Run(Slam, 150);
+    snprintf(detail, sizeof(detail), "%u transactions, %u bytes", r.traffic, r.bytes);
+    Expect("door slam: FIFO drained in one burst", r.bytes >= ACCEL_FIFO_SAMPLES * 3U && r.traffic <= 8U, detail);
+    Expect("door slam re-armed the FIFO", g_mma.regs[REG_F_SETUP] == (F_SETUP_TRIGGER | F_PRE_TRIGGER) &&
+           !g_mma.triggered && g_mma.standbyViolations == 0U, NULL);
+    Check_Capture("door slam -> AMBIENT", Slam, ACCEL_AMBIENT);
+    Check_Capture("pry bar -> TAMPER_PRY", Pry, ACCEL_TAMPER_PRY);
+    Check_Capture("knocked off the wall -> TAMPER_MOVED", Knocked, ACCEL_TAMPER_MOVED);
+
+    printf("Motion engine\n");
+    Start();
+    r = Run(Lift, 150);
+    snprintf(detail, sizeof(detail), "got %s, %u bytes read", Class_Name(r.cls), r.bytes);
+    Expect("slow lift -> TAMPER_MOVED without a FIFO capture", r.cls == ACCEL_TAMPER_MOVED && r.bytes < ACCEL_FIFO_SAMPLES * 3U, detail);
+
+    printf("Interrupt\n");
+    Start();
+    r = Run(Slam, 150);
+    Result_t r2 = Run(Pry, 150);
+    snprintf(detail, sizeof(detail), "got %s then %s", Class_Name(r.cls), Class_Name(r2.cls));
+    Expect("second event after re-arm is captured", r.cls == ACCEL_AMBIENT && r2.cls == ACCEL_TAMPER_PRY, detail);
+    Start();
+    g_hostPortA.PCR[BOARD_PIN(ACCEL_INT)] &= ~PORT_PCR_IRQC_MASK; // Edge lost
+    r = Run(Slam, 150);
+    Expect("edge lost: level check still drains", r.cls == ACCEL_AMBIENT, NULL);
+
+    printf("%s\n", g_failures ? "FAILED" : "all checks pass");
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,415 @@
+/*
+ * fsm_check.c
+ *
+ * [FSM MODEL CHECKER]
+ * Explicit-state check of the partition FSM on the host. The real
+ * security_manager.c is compiled in with stubbed drivers, and a
+ * breadth-first search applies every input event (PIN, card, motion,
+ * tamper loop trip, time steps, watchdog resets) to every reachable
+ * state. After each step the safety properties below are checked. A
+ * violation prints the shortest event trace that reaches it.
+ *
+ * Build and run from the repository root:
+ *
+ *   gcc -std=gnu99 -O2 -DCPU_MKL25Z128VLK4 -D__REDLIB__ -ICMSIS -Idrivers \
+ *       -Iboard -Iutilities -Isource tools/host/fsm_check.c -o fsm_check
+ *   ./fsm_check [-v]
+ *
+ * Time advances in 500 ms steps (inputs take no time), and timer ages are
+ * clamped above the value the firmware compares them with, so the state
+ * space is finite.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+// Host reset controller: the firmware reads RCM->SRS0 to tell resets apart
+#include "MKL25Z4.h"
+#undef RCM
+static struct { uint8_t SRS0, SRS1; } g_hostRcm;
+#define RCM (&g_hostRcm)
+
+#define TAMPER_ENABLE 1  // Board-wide tamper trips reach every partition state
+#include "security_manager.c"
+
+// ============================================================================
+// STUBBED DRIVERS (inputs are set per event, outputs are observed)
+// ============================================================================
+#define UID_ENROLLED   0x11111111U  // Slot 0, group 0 (24/7)
+#define UID_OFF_HOURS  0x22222222U  // Slot 1, group 1 (closed: clock not set)
+#define UID_UNKNOWN    0x33333333U
+
+typedef struct {
+    int pin;                // Keypad_CheckPassword result (0, 1, -1, 2 = wake)
+    uint32_t card;          // 0 = no card
+    bool motion;
+    bool tamper;            // One TAMPER_EV_OPEN from the tamper manager
+} Inputs_t;
+
+typedef struct {
+    uint32_t tick;
+    bool doorOpen;
+    bool buzzerOn;
+    bool invariantFired;    // Runtime guard in Check_Invariants was needed
+    bool deadlineReset;     // Supervisor_TakeDeadlineReset answer for the next boot
+} Host_t;
+
+static Inputs_t g_in;
+static Host_t g_host;
+static SecurityConfig_t g_config;
+static bool g_verbose;
+
+uint8_t g_logLevel[LOG_CATEGORIES] = { LOG_LVL_DEBUG, LOG_LVL_DEBUG, LOG_LVL_DEBUG, LOG_LVL_DEBUG,
+                                       LOG_LVL_DEBUG, LOG_LVL_DEBUG, LOG_LVL_DEBUG };
+
+uint32_t GetTick(void) { return g_host.tick; }
+uint8_t IsTimeout(uint32_t startTick, uint32_t durationMs) { return (g_host.tick - startTick) >= durationMs; }
+
+int Keypad_CheckPassword(void) { int r = g_in.pin; g_in.pin = 0; return r; }
+char Keypad_GetKeyNonBlocking(void) { g_in.pin = 0; return 0; }
+int RFID_CheckScan(void) { return g_in.card ? 1 : 0; }
+int RFID_GetLastScanResult(void) { g_in.card = 0; return 0; }
+uint32_t RFID_GetLastUID(void) { uint32_t uid = g_in.card; g_in.card = 0; return uid; }
+bool RFID_GetLastCredential(RFID_Credential_t* out) { (void)out; return false; }
+void RFID_HoldOff(uint32_t uid, uint32_t durationMs) { (void)uid; (void)durationMs; }
+bool PIR_CheckTriggered(void) { bool m = g_in.motion; g_in.motion = false; return m; }
+bool Tamper_GetEvent(TamperEvent_t* out) {
+    if (!g_in.tamper) return false;
+    g_in.tamper = false;
+    memset(out, 0, sizeof(*out));
+    out->type = TAMPER_EV_OPEN;
+    return true;
+}
+
+void Servo_Open(void) { g_host.doorOpen = true; }
+void Servo_Close(void) { g_host.doorOpen = false; }
+void Buzzer_On(uint16_t pitch, uint8_t volume) { (void)pitch; (void)volume; g_host.buzzerOn = true; }
+void Buzzer_Off(void) { g_host.buzzerOn = false; }
+void Buzzer_Beep(int duration_ms) { (void)duration_ms; }
+void LED_Alarm_On(void) {}
+void LED_Alarm_Off(void) {}
+
+int Storage_FindRFID(uint32_t uid) {
+    if (uid == UID_ENROLLED) return 0;
+    if (uid == UID_OFF_HOURS) return 1;
+    return -1;
+}
+SecurityConfig_t* Storage_GetConfig(void) { return &g_config; }
+const uint8_t* Storage_GetPolicy(uint16_t* outLen) { *outLen = 0; return NULL; }
+bool Storage_JournalLog(uint16_t type, uint16_t info, uint32_t stamp) { (void)type; (void)info; (void)stamp; return true; }
+bool Storage_JournalGetLast(uint16_t type, uint16_t* outInfo, uint32_t* outStamp) {
+    (void)type; (void)outInfo; (void)outStamp;
+    return false;
+}
+bool Storage_UpdatePIN(const char* newPin) { (void)newPin; return true; }
+bool Storage_UpdateAdminPass(const char* newPass) { (void)newPass; return true; }
+uint8_t Policy_Evaluate(const uint8_t* code, uint16_t len, const PolicyCtx_t* ctx) {
+    (void)code; (void)len; (void)ctx;
+    return POLICY_ALLOW;
+}
+
+uint32_t WallClock_GetTime(void) { return 0; }
+bool WallClock_IsSet(void) { return false; }
+int WallClock_GetWeekSlot(void) { return -1; }
+bool Power_IsFailing(void) { return false; }
+void Audit_Record(AuditEvent_t event, uint32_t uid, uint8_t door) { (void)event; (void)uid; (void)door; }
+void Supervisor_CheckIn(SupTask_t task) { (void)task; }
+bool Supervisor_TakeDeadlineReset(SupTask_t* task) {
+    *task = SUP_TASK_SECURITY;
+    return g_host.deadlineReset;
+}
+
+void UART_LogClass(UART_TxClass_t cls, const char* format, ...) {
+    char line[160];
+    va_list args;
+    (void)cls;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (strstr(line, "INVARIANT") != NULL) g_host.invariantFired = true;
+    if (g_verbose) printf("    %s", line);
+}
+
+// ============================================================================
+// WORLD SNAPSHOT (everything the FSM reads or writes)
+// ============================================================================
+typedef struct {
+    Partition_t partitions[NUM_PARTITIONS];
+    Partition_t* sirenOwner;
+    bool skipStartupDelay;
+    uint32_t lastCheckpoint;
+    uint32_t lastFlashBackup;
+    uint16_t flashedPack;
+    Checkpoint_t checkpoint;
+    Host_t host;
+} World_t;
+
+static void World_Save(World_t* w) {
+    memcpy(w->partitions, g_partitions, sizeof(g_partitions));
+    w->sirenOwner = g_sirenOwner;
+    w->skipStartupDelay = g_skipStartupDelay;
+    w->lastCheckpoint = g_lastCheckpoint;
+    w->lastFlashBackup = g_lastFlashBackup;
+    w->flashedPack = g_flashedPack;
+    w->checkpoint = g_checkpoint;
+    w->host = g_host;
+}
+
+static void World_Load(const World_t* w) {
+    memcpy(g_partitions, w->partitions, sizeof(g_partitions));
+    g_sirenOwner = w->sirenOwner;
+    g_skipStartupDelay = w->skipStartupDelay;
+    g_lastCheckpoint = w->lastCheckpoint;
+    g_lastFlashBackup = w->lastFlashBackup;
+    g_flashedPack = w->flashedPack;
+    g_checkpoint = w->checkpoint;
+    g_host = w->host;
+}
+
+// Ages past what the firmware compares against behave alike: clamp them for the state key
+
+static uint32_t Age(uint32_t now, uint32_t since, uint32_t cap) {
+    uint32_t age = now - since;
+    return (age > cap) ? cap : age;
+}
+
+typedef struct {
+    uint32_t word[NUM_PARTITIONS * 4 + 4];
+} Key_t;
+
+/* Abstract state: discrete fields plus clamped timer ages */
+static void World_Key(const World_t* w, Key_t* k) {
+    uint32_t now = w->host.tick;
+    uint32_t n = 0;
+    memset(k, 0, sizeof(*k));
+    for (uint32_t i = 0; i < NUM_PARTITIONS; i++) {
+        const Partition_t* p = &w->partitions[i];
+        const PartitionCheckpoint_t* c = &w->checkpoint.part[i];
+        k->word[n++] = (uint32_t)p->state | (uint32_t)p->failedAttempts << 4 | (uint32_t)p->alarmVolume << 8 |
+                       (uint32_t)p->authGranted << 16 | (uint32_t)p->doorUnlockedMsg << 17 |
+                       (uint32_t)p->waitingForAutoLock << 18 | (uint32_t)p->blinkPhase << 19;
+        uint32_t cap = State_Limit(p->state) + STUCK_MARGIN_MS;
+        uint32_t saved = State_Limit((SystemState_t)c->state);
+        k->word[n++] = Age(now, p->stateEntryTime, cap) << 16 | Age(now, p->lastAlarmToggle, 1000U);
+        k->word[n++] = (uint32_t)c->state | (uint32_t)c->failedAttempts << 4 | (uint32_t)c->alarmVolume << 8;
+        k->word[n++] = (c->stateAge > saved) ? saved : c->stateAge;
+    }
+    k->word[n++] = (now > STARTUP_DELAY_MS) ? STARTUP_DELAY_MS : now;
+    k->word[n++] = Age(now, w->lastCheckpoint, CHECKPOINT_REFRESH_MS) | (uint32_t)w->skipStartupDelay << 16;
+    k->word[n++] = (uint32_t)w->host.doorOpen | (uint32_t)w->host.buzzerOn << 1 | (uint32_t)w->flashedPack << 16;
+    k->word[n++] = (w->sirenOwner != NULL) ? (uint32_t)(w->sirenOwner - g_partitions) + 1U : 0;
+}
+
+// ============================================================================
+// EVENTS
+// ============================================================================
+typedef enum {
+    EV_WAIT_500MS,
+    EV_WAIT_5S,
+    EV_PIN_OK,
+    EV_PIN_BAD,
+    EV_KEY_WAKE,
+    EV_CARD_OK,
+    EV_CARD_OFF_HOURS,
+    EV_CARD_UNKNOWN,
+    EV_MOTION,
+    EV_TAMPER,
+    EV_WATCHDOG_RESET,
+    EV_DEADLINE_RESET,
+    EV_COUNT
+} Event_t;
+
+static const char* const g_eventName[EV_COUNT] = {
+    "wait 500ms", "wait 5s", "PIN ok", "PIN bad", "key wake", "card enrolled",
+    "card off-hours", "card unknown", "motion", "tamper trip", "watchdog reset",
+    "deadline reset",
+};
+
+static const char* const g_stateName[] = {
+    "ARMED", "ENTRY_DELAY", "EXIT_DELAY", "TRIGGERED", "DISARMED", "LOCKED",
+};
+
+/* One scheduler pass of the firmware under the event */
+static void Apply(Event_t ev) {
+    uint32_t dt = 0;            // Inputs arrive within one pass
+    memset(&g_in, 0, sizeof(g_in));
+    g_host.invariantFired = false;
+
+    switch (ev) {
+        case EV_WAIT_500MS:     dt = 500; break;
+        case EV_WAIT_5S:        dt = 5000; break;
+        case EV_PIN_OK:         g_in.pin = 1; break;
+        case EV_PIN_BAD:        g_in.pin = -1; break;
+        case EV_KEY_WAKE:       g_in.pin = 2; break;
+        case EV_CARD_OK:        g_in.card = UID_ENROLLED; break;
+        case EV_CARD_OFF_HOURS: g_in.card = UID_OFF_HOURS; break;
+        case EV_CARD_UNKNOWN:   g_in.card = UID_UNKNOWN; break;
+        case EV_MOTION:         g_in.motion = true; break;
+        case EV_TAMPER:         g_in.tamper = true; break;
+        case EV_WATCHDOG_RESET:
+        case EV_DEADLINE_RESET:
+            // RAM survives (.noinit checkpoint), the tick restarts, outputs drop
+            g_host.tick = 0;
+            g_host.buzzerOn = false;
+            g_host.deadlineReset = (ev == EV_DEADLINE_RESET);
+            g_hostRcm.SRS0 = RCM_SRS0_WDOG_MASK;
+            Security_Init();
+            return;
+        default:
+            break;
+    }
+    g_host.tick += dt;
+    Security_Update();
+}
+
+// ============================================================================
+// PROPERTIES
+// ============================================================================
+static bool Is_Alarm(SystemState_t s) {
+    return (s == STATE_TRIGGERED || s == STATE_LOCKED);
+}
+
+static bool Is_Auth(Event_t ev) {
+    return (ev == EV_PIN_OK || ev == EV_CARD_OK);
+}
+
+static bool Is_Reset(Event_t ev) {
+    return (ev == EV_WATCHDOG_RESET || ev == EV_DEADLINE_RESET);
+}
+
+/* NULL if the step from `before` under `ev` is safe, else the broken property */
+static const char* Check(const World_t* before, Event_t ev) {
+    if (g_host.invariantFired) return "runtime invariant guard fired";
+
+    for (uint32_t i = 0; i < NUM_PARTITIONS; i++) {
+        const Partition_t* p = &g_partitions[i];
+        SystemState_t was = before->partitions[i].state;
+
+        if (g_host.doorOpen && p->state != STATE_DISARMED) return "door open outside DISARMED";
+        if (p->failedAttempts >= BRUTE_FORCE_LIMIT && p->state != STATE_LOCKED) return "lockout skipped";
+        if (p->state == STATE_LOCKED && !g_host.buzzerOn) return "LOCKED without siren";
+        if (Is_Reset(ev)) {
+            if (Is_Alarm(was) && !Is_Alarm(p->state)) return "reset silenced an alarm";
+            if (p->state == STATE_DISARMED && was != STATE_DISARMED) return "reset disarmed";
+            continue;
+        }
+        if (ev == EV_TAMPER) {
+            // Board-wide trip: outside the per-partition transition table, always ends in an alarm
+            bool running = g_skipStartupDelay || g_host.tick >= STARTUP_DELAY_MS;
+            if (running && !Is_Alarm(p->state)) return "tamper trip did not alarm";
+            continue;
+        }
+        if (p->state != was && !(g_allowedNext[was] & TO(p->state))) return "illegal transition";
+        if (p->state == STATE_DISARMED && was != STATE_DISARMED && !Is_Auth(ev)) return "disarmed without auth";
+        if (Is_Alarm(was) && !Is_Alarm(p->state) && !Is_Auth(ev)) return "alarm cleared without auth";
+    }
+    return NULL;
+}
+
+// ============================================================================
+// SEARCH
+// ============================================================================
+typedef struct {
+    World_t world;
+    int32_t parent;
+    uint8_t event;
+} Node_t;
+
+#define HASH_BITS  20
+#define HASH_SIZE  (1U << HASH_BITS)
+
+static Node_t* g_nodes;
+static uint32_t g_count, g_capacity;
+static Key_t* g_keys;
+static int32_t* g_table;
+
+static uint32_t Key_Hash(const Key_t* k) {
+    const uint8_t* b = (const uint8_t*)k;
+    uint32_t h = 2166136261U;
+    for (uint32_t i = 0; i < sizeof(*k); i++) h = (h ^ b[i]) * 16777619U;
+    return h;
+}
+
+/* Adds the current world unless an equivalent one was seen; false if seen */
+static bool Visit(int32_t parent, Event_t ev) {
+    if (g_count == g_capacity) {
+        g_capacity = g_capacity ? g_capacity * 2 : 4096;
+        g_nodes = realloc(g_nodes, g_capacity * sizeof(Node_t));
+        g_keys = realloc(g_keys, g_capacity * sizeof(Key_t));
+        if (g_nodes == NULL || g_keys == NULL) { fprintf(stderr, "out of memory\n"); exit(2); }
+    }
+    Node_t* n = &g_nodes[g_count];
+    World_Save(&n->world);
+    World_Key(&n->world, &g_keys[g_count]);
+
+    uint32_t slot = Key_Hash(&g_keys[g_count]) & (HASH_SIZE - 1U);
+    while (g_table[slot] >= 0) {
+        if (memcmp(&g_keys[g_table[slot]], &g_keys[g_count], sizeof(Key_t)) == 0) return false;
+        slot = (slot + 1U) & (HASH_SIZE - 1U);
+    }
+    if (g_count >= HASH_SIZE / 2) { fprintf(stderr, "state space too large\n"); exit(2); }
+    g_table[slot] = (int32_t)g_count;
+    n->parent = parent;
+    n->event = (uint8_t)ev;
+    g_count++;
+    return true;
+}
+
+/* Replays the path to `node` plus the failing event, with the firmware log */
+static void Print_Trace(int32_t node, Event_t last) {
+    uint8_t path[256];
+    int depth = 0;
+    for (int32_t i = node; i > 0 && depth < 255; i = g_nodes[i].parent) path[depth++] = g_nodes[i].event;
+
+    World_Load(&g_nodes[0].world);
+    g_verbose = true;
+    printf("Trace (%d steps):\n", depth + 1);
+    for (int d = depth; d >= 0; d--) {
+        Event_t ev = (d == 0) ? last : (Event_t)path[d - 1];
+        printf("  %s\n", g_eventName[ev]);
+        Apply(ev);
+        printf("    -> %s, door %s, siren %s\n", g_stateName[g_partitions[0].state],
+               g_host.doorOpen ? "open" : "closed", g_host.buzzerOn ? "on" : "off");
+    }
+}
+
+int main(int argc, char** argv) {
+    g_verbose = (argc > 1 && strcmp(argv[1], "-v") == 0);
+    g_table = malloc(HASH_SIZE * sizeof(int32_t));
+    if (g_table == NULL) return 2;
+    memset(g_table, 0xFF, HASH_SIZE * sizeof(int32_t));
+    g_config.uid_schedule[0] = 0;
+    g_config.uid_schedule[1] = 1;
+
+    // Power-on boot, then past the sensor settle time
+    g_hostRcm.SRS0 = RCM_SRS0_POR_MASK;
+    Security_Init();
+    g_host.tick = STARTUP_DELAY_MS;
+    bool verbose = g_verbose;
+    g_verbose = false;
+    Visit(-1, EV_WAIT_500MS);
+
+    uint32_t transitions = 0;
+    for (uint32_t head = 0; head < g_count; head++) {
+        for (int ev = 0; ev < EV_COUNT; ev++) {
+            World_Load(&g_nodes[head].world);
+            g_verbose = verbose;
+            Apply((Event_t)ev);
+            g_verbose = false;
+            transitions++;
+
+            const char* broken = Check(&g_nodes[head].world, (Event_t)ev);
+            if (broken != NULL) {
+                printf("VIOLATION: %s\n", broken);
+                Print_Trace((int32_t)head, (Event_t)ev);
+                return 1;
+            }
+            Visit((int32_t)head, (Event_t)ev);
+        }
+    }
+
+    printf("%u states, %u transitions, %u events: all properties hold.\n", g_count, transitions, (unsigned)EV_COUNT);
+    return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * gb_tune.c
+ *
+ * [GLASS-BREAK TUNING FRONT END]
+ * Runs the real glassbreak.c detector (built-in q15 FFT) over recorded
+ * WAV files on the host. Samples are cut to 12 bits like the ADC0 path,
+ * and each block prints the values the thresholds are compared against.
+ *
+ * Build and run from the repository root (any GB_* tuning define can be
+ * overridden with -D to try a new value):
+ *
+ *   gcc -std=gnu99 -O2 -Isource tools/host/gb_tune.c -o gb_tune
+ *   ./gb_tune [-v] shatter.wav slam.wav ...
+ *
+ * Input: 16 kHz, 16-bit PCM WAV (first channel is used). Without -v only
+ * blocks past the energy gate are shown.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GLASSBREAK_ENABLE 1
+#define GLASSBREAK_HOST
+#include "glassbreak.c"
+
+// ============================================================================
+// WAV READER
+// ============================================================================
+typedef struct {
+    int16_t* samples;
+    uint32_t count;
+    uint32_t rate;
+} Wav_t;
+
+static uint32_t Le32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint16_t Le16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+static bool Wav_Load(const char* path, Wav_t* wav) {
+    wav->rate = 0;
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) { perror(path); return false; }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t* d = malloc((size_t)size);
+    bool ok = (d != NULL && fread(d, 1, (size_t)size, f) == (size_t)size);
+    fclose(f);
+
+    if (!ok || size < 12 || memcmp(d, "RIFF", 4) != 0 || memcmp(d + 8, "WAVE", 4) != 0) {
+        fprintf(stderr, "%s: not a RIFF/WAVE file\n", path);
+        free(d);
+        return false;
+    }
+
+    uint16_t format = 0, channels = 0, bits = 0;
+    const uint8_t* data = NULL;
+    uint32_t dataLen = 0;
+    for (long off = 12; off + 8 <= size; ) {
+        uint32_t len = Le32(d + off + 4);
+        if (memcmp(d + off, "fmt ", 4) == 0 && len >= 16) {
+            format = Le16(d + off + 8);
+            channels = Le16(d + off + 10);
+            wav->rate = Le32(d + off + 12);
+            bits = Le16(d + off + 22);
+        } else if (memcmp(d + off, "data", 4) == 0) {
+            data = d + off + 8;
+            dataLen = (off + 8 + (long)len <= size) ? len : (uint32_t)(size - off - 8);
+        }
+        off += 8 + len + (len & 1);
+    }
+
+    if (format != 1 || bits != 16 || channels == 0 || data == NULL) {
+        fprintf(stderr, "%s: need 16-bit PCM (format %u, %u bits)\n", path, format, bits);
+        free(d);
+        return false;
+    }
+
+    wav->count = dataLen / (2U * channels);
+    wav->samples = malloc(wav->count * sizeof(int16_t));
+    for (uint32_t i = 0; i < wav->count; i++) wav->samples[i] = (int16_t)Le16(data + 2U * channels * i);
+    free(d);
+    return true;
+}
+
+// ============================================================================
+// BLOCK ANALYSIS
+// ============================================================================
+static int Run_File(const char* path, bool verbose) {
+    Wav_t wav;
+    if (!Wav_Load(path, &wav)) return -1;
+    if (wav.rate != GB_SAMPLE_RATE_HZ) {
+        fprintf(stderr, "%s: %u Hz, detector runs at %u Hz (resample first)\n", path, wav.rate, GB_SAMPLE_RATE_HZ);
+        free(wav.samples);
+        return -1;
+    }
+
+    // Fresh detector per file
+    g_burst_age = 0;
+    g_glassDetected = false;
+
+    printf("%s: %u blocks of %d ms\n", path, wav.count / GB_BLOCK_SIZE, (int)GB_BLOCK_MS);
+    printf("  %8s  %10s  %8s  %8s  %s\n", "t (ms)", "energy", "HF", "LF", "");
+
+    int detections = 0;
+    int16_t block[GB_BLOCK_SIZE];
+    for (uint32_t b = 0; (b + 1) * GB_BLOCK_SIZE <= wav.count; b++) {
+        // ADC0 path: 12-bit conversion, mean at mid-scale, << 4 to q15
+        for (int i = 0; i < GB_BLOCK_SIZE; i++) block[i] = (int16_t)((wav.samples[b * GB_BLOCK_SIZE + i] >> 4) << 4);
+
+        uint32_t energy = 0;
+        for (int i = 0; i < GB_BLOCK_SIZE; i++) {
+            int32_t s = block[i] >> 4;
+            energy += (uint32_t)(s * s);
+        }
+        uint8_t ageBefore = g_burst_age;
+        bool hit = Glassbreak_ProcessBlock(block);
+        bool gated = (energy < GB_GATE_ENERGY);
+        if (gated && !verbose) continue;
+
+        const char* note = hit ? "GLASS BREAK"
+                         : gated ? "(gated)"
+                         : (ageBefore == 0 && g_burst_age == 1) ? "HF burst"
+                         : (g_burst_age > 0) ? "waiting for thump" : "";
+        if (gated) {
+            printf("  %8u  %10u  %8s  %8s  %s\n", b * (unsigned)GB_BLOCK_MS, energy, "-", "-", note);
+        } else {
+            printf("  %8u  %10u  %8u  %8u  %s\n", b * (unsigned)GB_BLOCK_MS, energy,
+                   Band_Sum(GB_HF_BIN_LO, GB_HF_BIN_HI), Band_Sum(GB_LF_BIN_LO, GB_LF_BIN_HI), note);
+        }
+        if (hit) detections++;
+    }
+    printf("  -> %d detection(s)  [gate %lu, HF > %lu and > %d x LF, then LF > %lu within %u ms]\n\n",
+           detections, (unsigned long)GB_GATE_ENERGY, (unsigned long)GB_HF_THRESHOLD, GB_HF_RATIO,
+           (unsigned long)GB_LF_THRESHOLD, GB_THUMP_WINDOW_MS);
+    free(wav.samples);
+    return detections;
+}
+
+int main(int argc, char** argv) {
+    bool verbose = false;
+    int files = 0, failed = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) { verbose = true; continue; }
+        files++;
+        if (Run_File(argv[i], verbose) < 0) failed++;
+    }
+    if (files == 0) {
+        fprintf(stderr, "usage: gb_tune [-v] file.wav ...\n");
+        return 2;
+    }
+    return failed ? 1 : 0;
+}
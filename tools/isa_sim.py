@@ -0,0 +1,1317 @@
+#!/usr/bin/env python3
+"""
+isa_sim.py
+
+[ISA SIMULATION HARNESS]
+Runs the built firmware ELF on a Cortex-M0+ instruction-set emulator
+(Unicorn 2.x, `pip install unicorn`) with models of the board hardware,
+and reports per-function and per-interrupt cycle counts:
+
+    python3 tools/isa_sim.py Release/MKL25Z4_SecuritySystem.axf --ms 3000 \\
+        --bt 2500:"LOGIN 123456" --keys 1200:1234# --card 1800:526CA904
+
+Models: SIM/MCG/OSC/SMC (clock bring-up), PIT (tick), PORT/GPIO (keypad
+matrix from board_pins.h, PIR edge IRQ), UART2 (HC-05) and UART0 (wired
+port) at their baud rates, SPI0 + RC522 (REQA/anticollision/SELECT/
+MFAuthent/READ/HLTA, CRC coprocessor), TPM (registers), FTFA (program/
+erase with datasheet busy times), PMC LVW (brown-out), RCM, COP.
+The NVIC (enable/pending/priority, PRIMASK, nesting, tail state) is
+modelled here: exceptions are stacked and unstacked by the harness.
+
+Cycles come from the ARMv6-M timing of each executed instruction
+(Cortex-M0+ TRM: loads/stores 2, taken branches 2, BL 3, LDM/STM/PUSH/
+POP 1+N, POP {pc} 3+N, MSR/MRS/barriers 3), 15 cycles per exception
+entry and exit, and no flash wait states (the KL25 prefetch hides most
+of them at 48 MHz). WFI fast-forwards to the next hardware event.
+Runs are deterministic: the same ELF and inputs give the same report.
+"""
+
+import argparse
+import bisect
+import codecs
+import os
+import re
+import struct
+import sys
+
+try:
+    from unicorn import (Uc, UcError, UC_ARCH_ARM, UC_MODE_THUMB, UC_MODE_MCLASS, UC_HOOK_BLOCK,
+                         UC_HOOK_CODE, UC_PROT_READ, UC_PROT_WRITE, UC_PROT_EXEC, UC_PROT_ALL)
+    from unicorn import arm_const as A
+except ImportError:
+    sys.exit('isa_sim.py needs Unicorn 2.x: pip install unicorn')
+
+CORE_HZ = 48000000              # BOARD_BootClockRUN
+BUS_HZ = CORE_HZ // 2           # OUTDIV4 = /2
+FLASH_BASE, FLASH_SIZE = 0x00000000, 0x20000
+SRAM_BASE, SRAM_SIZE = 0x1FFFF000, 0x4000
+PERIPH_BASE, PERIPH_SIZE = 0x40000000, 0x80000
+GPIO_BASE, FGPIO_BASE = 0x400FF000, 0xF80FF000
+PPB_BASE = 0xE000E000
+EXC_RETURN_BASE = 0xFFFFFFF0
+EXC_ENTRY_CYCLES = 15
+EXC_EXIT_CYCLES = 15
+
+IRQ_NAMES = {6: 'LVD_LVW', 12: 'UART0', 14: 'UART2', 22: 'PIT', 30: 'PORTA', 31: 'PORTD',
+             15: 'ADC0', 16: 'CMP0', 0: 'DMA0', 8: 'I2C0', 10: 'SPI0'}
+
+CORE_REGS = [A.UC_ARM_REG_R0, A.UC_ARM_REG_R1, A.UC_ARM_REG_R2, A.UC_ARM_REG_R3, A.UC_ARM_REG_R4,
+             A.UC_ARM_REG_R5, A.UC_ARM_REG_R6, A.UC_ARM_REG_R7, A.UC_ARM_REG_R8, A.UC_ARM_REG_R9,
+             A.UC_ARM_REG_R10, A.UC_ARM_REG_R11, A.UC_ARM_REG_R12, A.UC_ARM_REG_SP, A.UC_ARM_REG_LR,
+             A.UC_ARM_REG_PC]
+
+def us(cycles):
+    return cycles * 1e6 / CORE_HZ
+
+def ms_to_cycles(ms):
+    return int(ms * CORE_HZ / 1000)
+
+# ============================================================================
+# ELF (32-bit little endian: PT_LOAD segments and function symbols)
+# ============================================================================
+class Elf:
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        d = self.data
+        if d[:4] != b'\x7fELF' or d[4] != 1 or d[5] != 1:
+            sys.exit('%s: not a 32-bit little-endian ELF' % path)
+        (self.entry, phoff, shoff, _, _, phentsize, phnum, shentsize, shnum,
+         shstrndx) = struct.unpack_from('<IIIIHHHHHH', d, 24)
+        self.segments = []
+        for i in range(phnum):
+            p_type, p_offset, _, p_paddr, p_filesz, _, p_flags, _ = struct.unpack_from('<IIIIIIII', d, phoff + i * phentsize)
+            if p_type == 1 and p_filesz:
+                self.segments.append((p_paddr, d[p_offset:p_offset + p_filesz], p_flags))
+        sections = [struct.unpack_from('<IIIIIIIIII', d, shoff + i * shentsize) for i in range(shnum)]
+        self.functions = []                     # (start, end, name), sorted
+        for sh in sections:
+            if sh[1] != 2:                      # SHT_SYMTAB
+                continue
+            strtab = sections[sh[6]]
+            for off in range(sh[4], sh[4] + sh[5], 16):
+                name_off, value, size, info, _, shndx = struct.unpack_from('<IIIBBH', d, off)
+                if info & 0xF != 2 or shndx == 0:   # STT_FUNC, defined
+                    continue
+                start = strtab[4] + name_off
+                name = d[start:d.index(b'\0', start)].decode(errors='replace')
+                addr = value & ~1
+                self.functions.append((addr, addr + max(size, 2), name))
+        self.functions.sort()
+        self.starts = [f[0] for f in self.functions]
+
+    def function_at(self, addr):
+        i = bisect.bisect_right(self.starts, addr) - 1
+        if i >= 0 and addr < self.functions[i][1]:
+            return self.functions[i][2]
+        return '0x%08X' % addr
+
+    def symbol(self, name):
+        for start, _, n in self.functions:
+            if n == name:
+                return start
+        return None
+
+# ============================================================================
+# THUMB-1 TIMING (Cortex-M0+)
+# ============================================================================
+def popcount(x):
+    return bin(x).count('1')
+
+def insn_cycles(hw, hw2):
+    """(cycles, length, kind) of one instruction; kind 'cond' = conditional branch"""
+    top5 = hw >> 11
+    if top5 in (0x1D, 0x1E, 0x1F):                      # 32-bit
+        if (hw & 0xF800) == 0xF000 and (hw2 & 0xD000) == 0xD000:
+            return 3, 4, 'call'                         # BL
+        return 3, 4, ''                                 # MSR/MRS/DMB/DSB/ISB
+    if (hw & 0xFF00) == 0x4700:
+        return 2, 2, ('call' if hw & 0x80 else 'jump')  # BLX / BX
+    if (hw & 0xFC00) == 0x4400 and ((hw >> 4) & 8 | hw & 7) == 15 and (hw & 0x0300) != 0x0100:
+        return 2, 2, 'jump'                             # ADD/MOV pc
+    if 0x4800 <= hw <= 0x9FFF:
+        return 2, 2, ''                                 # LDR/STR (all forms)
+    if (hw & 0xFE00) == 0xB400:
+        return 1 + popcount(hw & 0x1FF), 2, ''          # PUSH
+    if (hw & 0xFE00) == 0xBC00:
+        n = popcount(hw & 0xFF)
+        return (3 + n + 1, 2, 'jump') if hw & 0x100 else (1 + n, 2, '')
+    if 0xC000 <= hw <= 0xCFFF:
+        return 1 + popcount(hw & 0xFF), 2, ''           # LDM/STM
+    if 0xD000 <= hw <= 0xDDFF:
+        return 1, 2, 'cond'                             # +1 if taken
+    if (hw & 0xF800) == 0xE000:
+        return 2, 2, 'jump'                             # B
+    return 1, 2, ''
+
+# ============================================================================
+# PERIPHERAL MODELS
+# ============================================================================
+class Regs:
+    """Plain register file (reads return what was written)"""
+    def __init__(self, size, init=None):
+        self.mem = bytearray(size)
+        for off, val, width in (init or []):
+            self.set(off, val, width)
+
+    def get(self, off, size):
+        return int.from_bytes(self.mem[off:off + size], 'little')
+
+    def set(self, off, val, size):
+        self.mem[off:off + size] = (val & ((1 << (8 * size)) - 1)).to_bytes(size, 'little')
+
+    def read(self, sim, off, size):
+        return self.get(off, size)
+
+    def write(self, sim, off, size, val):
+        self.set(off, val, size)
+
+    def next_event(self):
+        return None
+
+    def advance(self, sim):
+        pass
+
+
+class Mcg(Regs):
+    """Status follows the control bits at once (FLL/PLL lock instantly)"""
+    def read(self, sim, off, size):
+        if off == 6:
+            c1, c2, c6 = self.mem[0], self.mem[1], self.mem[5]
+            clks = c1 >> 6
+            clkst = (3 if c6 & 0x40 else 0) if clks == 0 else clks
+            return (0x40 | (c6 & 0x40) >> 1 | (c1 & 0x04) << 2 | clkst << 2 |
+                    (0x02 if c2 & 0x04 else 0) | (c2 & 0x01))
+        return self.get(off, size)
+
+
+class Sim(Regs):
+    """SIM: flash size for the FTFA driver, COP service sequence, write-once COPC"""
+    def __init__(self):
+        super().__init__(0x1108, [(0x104C, 0x07000000, 4), (0x1024, 0x25151C85, 4), (0x1100, 0x0C, 4)])
+        self.srv_last = 0
+        self.copc_written = False
+
+    def write(self, sim, off, size, val):
+        if off == 0x1104:
+            val &= 0xFF
+            if val == 0xAA and self.srv_last == 0x55:
+                sim.cop_kick()
+            self.srv_last = val
+            return
+        if off == 0x1100:
+            if self.copc_written:
+                sim.note('SIM_COPC write 0x%02X ignored (write-once after reset)' % (val & 0xFF))
+                return
+            self.copc_written = True
+            sim.cop_configure(val)
+        self.set(off, val, size)
+
+
+class Pit(Regs):
+    """Two down-counters on the bus clock; TIF per reload, one shared IRQ"""
+    def __init__(self):
+        super().__init__(0x120)
+        self.start = [0, 0]
+
+    def _ch(self, off):
+        return (off - 0x100) // 16, (off - 0x100) % 16
+
+    def _running(self, ch):
+        return not (self.mem[0] & 0x02) and self.get(0x108 + 16 * ch, 4) & 1
+
+    def _period(self, ch):
+        return (self.get(0x100 + 16 * ch, 4) + 1) * (CORE_HZ // BUS_HZ)
+
+    def read(self, sim, off, size):
+        if off >= 0x100:
+            ch, reg = self._ch(off)
+            if reg == 4:
+                if not self._running(ch):
+                    return 0
+                ldval = self.get(0x100 + 16 * ch, 4)
+                bus = (sim.cycles - self.start[ch]) // (CORE_HZ // BUS_HZ)
+                return ldval - bus % (ldval + 1)
+        return self.get(off, size)
+
+    def write(self, sim, off, size, val):
+        if off >= 0x100:
+            ch, reg = self._ch(off)
+            if reg == 0xC:
+                self.set(off, self.get(off, 4) & ~val, 4)      # TIF: write 1 to clear
+                return
+            if reg == 8 and (val & 1) and not (self.get(off, 4) & 1):
+                self.start[ch] = sim.cycles                     # TEN 0->1 reloads
+        self.set(off, val, size)
+
+    def next_event(self):
+        times = []
+        for ch in range(2):
+            if self._running(ch):
+                p = self._period(ch)
+                times.append(self.start[ch] + p)
+        return min(times) if times else None
+
+    def advance(self, sim):
+        for ch in range(2):
+            if not self._running(ch):
+                continue
+            p = self._period(ch)
+            while sim.cycles >= self.start[ch] + p:
+                self.start[ch] += p
+                self.set(0x10C + 16 * ch, 1, 4)
+        irq = any(self.get(0x10C + 16 * ch, 4) & 1 and self.get(0x108 + 16 * ch, 4) & 2 for ch in range(2))
+        sim.nvic.set_line(22, irq)
+
+
+class Uart(Regs):
+    """8N1 UART: holding + shift register at the programmed baud, RX from a script"""
+    def __init__(self, irq, name, lpsci):
+        super().__init__(0x10)
+        self.irq, self.name, self.lpsci = irq, name, lpsci
+        self.holding = None
+        self.shift_end = None
+        self.shifting = None
+        self.rx_queue = []                  # (cycle, byte)
+        self.rx_data = None
+        self.line = ''
+
+    def char_cycles(self):
+        sbr = ((self.mem[0] & 0x1F) << 8) | self.mem[1]
+        if sbr == 0:
+            return ms_to_cycles(10.0 / 9600 * 1000)
+        osr = ((self.mem[0xA] & 0x1F) + 1) if self.lpsci else 16
+        clock = CORE_HZ if self.lpsci else BUS_HZ
+        return max(1, int(10 * osr * sbr * CORE_HZ / clock))
+
+    def status(self):
+        s = 0
+        if self.holding is None:
+            s |= 0x80                                       # TDRE
+        if self.holding is None and self.shifting is None:
+            s |= 0x40                                       # TC
+        if self.rx_data is not None:
+            s |= 0x20                                       # RDRF
+        return s
+
+    def read(self, sim, off, size):
+        if off == 4:
+            return self.status()
+        if off == 7:
+            val = self.rx_data or 0
+            self.rx_data = None
+            self.update(sim)
+            return val
+        return self.get(off, size)
+
+    def write(self, sim, off, size, val):
+        if off == 7:
+            if self.shifting is None:
+                self.shifting, self.shift_end = val & 0xFF, sim.cycles + self.char_cycles()
+            else:
+                self.holding = val & 0xFF
+            self.update(sim)
+            return
+        self.set(off, val, size)
+        self.update(sim)
+
+    def emit(self, byte):
+        ch = chr(byte)
+        if ch == '\n':
+            print('%s< %s' % (self.name, self.line.rstrip('\r')))
+            self.line = ''
+        else:
+            self.line += ch
+
+    def next_event(self):
+        times = [t for t in (self.shift_end,) if t is not None]
+        if self.rx_queue:
+            times.append(self.rx_queue[0][0])
+        return min(times) if times else None
+
+    def advance(self, sim):
+        while self.shift_end is not None and sim.cycles >= self.shift_end:
+            self.emit(self.shifting)
+            if self.holding is not None:
+                self.shifting, self.holding = self.holding, None
+                self.shift_end += self.char_cycles()
+            else:
+                self.shifting = self.shift_end = None
+        while self.rx_queue and sim.cycles >= self.rx_queue[0][0]:
+            _, byte = self.rx_queue.pop(0)
+            if self.mem[3] & 0x04:                          # RE
+                self.rx_data = byte                         # Overrun drops the old byte
+        self.update(sim)
+
+    def update(self, sim):
+        c2, s = self.mem[3], self.status()
+        sim.nvic.set_line(self.irq, bool((c2 & 0x80 and s & 0x80) or (c2 & 0x40 and s & 0x40) or
+                                         (c2 & 0x20 and s & 0x20)))
+
+    def send(self, at, text):
+        gap = self.char_cycles()
+        for i, b in enumerate(text.encode()):
+            self.rx_queue.append((at + i * gap, b))
+        self.rx_queue.sort()
+
+
+class Gpio:
+    """Ports A-E: output latch, direction, inputs (pulls, script, keypad matrix)"""
+    def __init__(self, sim):
+        self.sim = sim
+        self.pdor = [0] * 5
+        self.pddr = [0] * 5
+        self.forced = {}                    # (port, pin) -> level
+        self.keys_down = set()              # (row, col) indices
+
+    def level(self, port, pin):
+        bit = 1 << pin
+        if self.pddr[port] & bit:
+            return 1 if self.pdor[port] & bit else 0
+        if (port, pin) in self.forced:
+            return self.forced[(port, pin)]
+        kp = self.sim.keypad
+        if kp and port == kp['col_port'] and pin in kp['cols']:
+            c = kp['cols'].index(pin)
+            for r, rpin in enumerate(kp['rows']):
+                if (r, c) in self.keys_down and not self.level(kp['row_port'], rpin):
+                    return 0
+        pcr = self.sim.ports[port].get(4 * pin, 4)
+        return 1 if (pcr & 0x3) == 0x3 else 0               # PE + PS = pull-up
+
+    def pdir(self, port):
+        return sum(self.level(port, pin) << pin for pin in range(32))
+
+    def read(self, sim, off, size):
+        port, reg = off // 0x40, off % 0x40
+        if port > 4:
+            return 0
+        if reg == 0x00: return self.pdor[port]
+        if reg == 0x10: return self.pdir(port)
+        if reg == 0x14: return self.pddr[port]
+        return 0
+
+    def write(self, sim, off, size, val):
+        port, reg = off // 0x40, off % 0x40
+        if port > 4:
+            return
+        before = self.pdor[port]
+        if reg == 0x00: self.pdor[port] = val
+        elif reg == 0x04: self.pdor[port] |= val
+        elif reg == 0x08: self.pdor[port] &= ~val & 0xFFFFFFFF
+        elif reg == 0x0C: self.pdor[port] ^= val
+        elif reg == 0x14: self.pddr[port] = val
+        sim.rc522.gpio_changed(port, before, self.pdor[port])
+
+    def force(self, port, pin, level):
+        old = self.level(port, pin)
+        self.forced[(port, pin)] = level
+        self.sim.ports[port].edge(self.sim, pin, old, level)
+
+
+class Port(Regs):
+    """PCR per pin, pin interrupt flags (edge/level per IRQC)"""
+    def __init__(self, index, irq):
+        super().__init__(0xA4)
+        self.index, self.irq = index, irq
+
+    def write(self, sim, off, size, val):
+        if off == 0xA0:                                     # ISFR: write 1 to clear
+            self.set(0xA0, self.get(0xA0, 4) & ~val, 4)
+            for pin in range(32):
+                if val & (1 << pin):
+                    self.set(4 * pin, self.get(4 * pin, 4) & ~(1 << 24), 4)
+        elif off < 0x80:
+            keep = self.get(off, 4) & (1 << 24) & ~val
+            self.set(off, (val & ~(1 << 24)) | keep, 4)
+        else:
+            self.set(off, val, size)                        # GPCLR/GPCHR
+            if off in (0x80, 0x84):
+                mask, pcr = val >> 16, val & 0xFFFF
+                for i in range(16):
+                    if mask & (1 << i):
+                        pin = i + (16 if off == 0x84 else 0)
+                        self.set(4 * pin, (self.get(4 * pin, 4) & ~0xFFFF) | pcr, 4)
+        self.update(sim)
+
+    def edge(self, sim, pin, old, new):
+        irqc = (self.get(4 * pin, 4) >> 16) & 0xF
+        hit = ((irqc == 0x9 and not old and new) or (irqc == 0xA and old and not new) or
+               (irqc == 0xB and old != new) or (irqc == 0x8 and not new) or (irqc == 0xC and new))
+        if hit:
+            self.set(4 * pin, self.get(4 * pin, 4) | (1 << 24), 4)
+            self.set(0xA0, self.get(0xA0, 4) | (1 << pin), 4)
+        self.update(sim)
+
+    def update(self, sim):
+        if self.irq is not None:
+            sim.nvic.set_line(self.irq, self.get(0xA0, 4) != 0)
+
+
+class Rc522:
+    """MFRC522 behind SPI0 (CS = PTC4, NRSTPD = PTC0) with one MIFARE Classic card"""
+    VERSION = 0x92
+
+    def __init__(self):
+        self.regs = bytearray(64)
+        self.fifo = []
+        self.frame = None                   # Bytes of the current CS-low frame
+        self.powered = True
+        self.card = None                    # dict(uid, key, block, halted)
+        self.crypto = False
+        self.reset()
+
+    def reset(self):
+        self.regs = bytearray(64)
+        self.regs[0x37] = self.VERSION
+        self.fifo = []
+        self.crypto = False
+
+    def gpio_changed(self, port, before, after):
+        if port != 2:
+            return
+        if (before ^ after) & (1 << 4):
+            self.frame = [] if not after & (1 << 4) else None
+        if (before ^ after) & 1:
+            self.powered = bool(after & 1)
+            if self.powered:
+                self.reset()
+
+    def spi(self, mosi):
+        if self.frame is None or not self.powered:
+            return 0
+        self.frame.append(mosi)
+        addr_byte = self.frame[0]
+        addr = (addr_byte >> 1) & 0x3F
+        if len(self.frame) == 1:
+            return 0
+        if addr_byte & 0x80:
+            return self.read_reg(addr)
+        self.write_reg(addr, mosi)
+        return 0
+
+    def read_reg(self, addr):
+        if addr == 0x09:
+            return self.fifo.pop(0) if self.fifo else 0
+        if addr == 0x0A:
+            return len(self.fifo)
+        if addr == 0x08:
+            return (self.regs[8] & ~0x08) | (0x08 if self.crypto else 0)
+        return self.regs[addr]
+
+    def write_reg(self, addr, val):
+        if addr == 0x09:
+            self.fifo.append(val)
+        elif addr == 0x0A:
+            if val & 0x80:
+                self.fifo = []
+        elif addr in (0x04, 0x05):                          # ComIrq/DivIrq: Set1 bit
+            if val & 0x80:
+                self.regs[addr] |= val & 0x7F
+            else:
+                self.regs[addr] &= ~val & 0x7F
+        elif addr == 0x08:
+            self.regs[8] = val
+            self.crypto = bool(val & 0x08) and self.crypto
+        elif addr == 0x01:
+            self.regs[1] = val & 0x1F
+            self.command(val & 0x0F)
+        elif addr == 0x0D:
+            self.regs[0x0D] = val & 0x7F
+            if val & 0x80 and self.regs[1] == 0x0C:
+                self.transceive()
+        else:
+            self.regs[addr] = val
+
+    def command(self, cmd):
+        if cmd == 0x0F:
+            self.reset()
+        elif cmd == 0x03:                                   # CalcCRC
+            crc = crc_a(self.fifo)
+            self.regs[0x22], self.regs[0x21] = crc & 0xFF, crc >> 8
+            self.fifo = []
+            self.regs[0x05] |= 0x04
+        elif cmd == 0x0E:                                   # MFAuthent
+            data, self.fifo = self.fifo, []
+            c = self.card
+            self.crypto = bool(c and not c['halted'] and len(data) == 12 and
+                               bytes(data[2:8]) == c['key'] and bytes(data[8:12]) == c['uid'])
+            self.regs[0x04] |= 0x10
+
+    def answer(self, data):
+        self.fifo = list(data)
+        self.regs[0x06] = 0
+        self.regs[0x04] |= 0x30                             # RxIRq | IdleIRq
+
+    def transceive(self):
+        data, self.fifo = self.fifo, []
+        c = self.card
+        if c is None or (c['halted'] and data[:1] != [0x52]):
+            self.regs[0x04] |= 0x01                         # TimerIRq: no answer
+            return
+        uid = list(c['uid'])
+        bcc = uid[0] ^ uid[1] ^ uid[2] ^ uid[3]
+        if data[:1] in ([0x26], [0x52]):
+            c['halted'] = False
+            self.answer([0x04, 0x00])
+        elif data[:2] == [0x93, 0x20]:
+            self.answer(uid + [bcc])
+        elif data[:2] == [0x93, 0x70]:
+            crc = crc_a([0x08])
+            self.answer([0x08, crc & 0xFF, crc >> 8])
+        elif data[:1] == [0x50]:
+            c['halted'] = True
+            self.crypto = False
+            self.regs[0x04] |= 0x01
+        elif data[:1] == [0x30] and self.crypto:
+            blk = list(c['block'])
+            crc = crc_a(blk)
+            self.answer(blk + [crc & 0xFF, crc >> 8])
+        else:
+            self.regs[0x04] |= 0x01
+
+
+def crc_a(data):
+    """ISO 14443-3 CRC_A (init 0x6363), as computed by the RC522 coprocessor"""
+    crc = 0x6363
+    for b in data:
+        b ^= crc & 0xFF
+        b = (b ^ (b << 4)) & 0xFF
+        crc = (crc >> 8) ^ (b << 8) ^ (b << 3) ^ (b >> 4)
+    return crc & 0xFFFF
+
+
+class Spi(Regs):
+    """SPI0 master, one byte per D write (transfer time not modelled)"""
+    def __init__(self, rc522):
+        super().__init__(8, [(3, 0x20, 1)])
+        self.rc522 = rc522
+        self.rx = 0
+
+    def read(self, sim, off, size):
+        if off == 5:
+            self.mem[3] &= ~0x80
+            return self.rx
+        return self.get(off, size)
+
+    def write(self, sim, off, size, val):
+        if off == 5:
+            self.rx = self.rc522.spi(val & 0xFF)
+            self.mem[3] |= 0xA0                             # SPRF | SPTEF
+            return
+        if off == 3:
+            return
+        self.set(off, val, size)
+
+
+class Ftfa(Regs):
+    """Flash controller: PGM4 / ERSSCR on the emulated flash with busy times"""
+    PGM4_US, ERSSCR_US = 65, 14000          # Datasheet typical values
+
+    def __init__(self):
+        super().__init__(0x14, [(0, 0x80, 1), (2, 0x02, 1)])
+        self.busy_until = None
+        self.commands = {'program': 0, 'erase': 0}
+
+    def write(self, sim, off, size, val):
+        if off == 0:
+            self.mem[0] &= ~(val & 0x30)                    # ACCERR/FPVIOL: write 1 to clear
+            if val & 0x80 and self.mem[0] & 0x80:
+                self.launch(sim)
+            return
+        self.set(off, val, size)
+
+    def launch(self, sim):
+        cmd = self.mem[7]
+        addr = (self.mem[6] << 16) | (self.mem[5] << 8) | self.mem[4]
+        busy_us = 1
+        if cmd == 0x06:
+            data = self.get(8, 4).to_bytes(4, 'little')
+            old = sim.uc.mem_read(addr, 4)
+            sim.uc.mem_write(addr, bytes(a & b for a, b in zip(old, data)))
+            busy_us = self.PGM4_US
+            self.commands['program'] += 1
+        elif cmd == 0x09:
+            sim.uc.mem_write(addr & ~0x3FF, b'\xff' * 0x400)
+            busy_us = self.ERSSCR_US
+            self.commands['erase'] += 1
+        elif cmd not in (0x00, 0x01, 0x02, 0x03, 0x41):
+            self.mem[0] |= 0x20                             # ACCERR
+            return
+        self.mem[0] &= ~0x80
+        self.busy_until = sim.cycles + ms_to_cycles(busy_us / 1000.0)
+
+    def next_event(self):
+        return self.busy_until
+
+    def advance(self, sim):
+        if self.busy_until is not None and sim.cycles >= self.busy_until:
+            self.mem[0] |= 0x80
+            self.busy_until = None
+
+
+class Pmc(Regs):
+    """LVDSC2: LVWF (bit 7, LVWACK bit 6 clears), LVWIE (bit 5) -> LVD_LVW IRQ"""
+    def __init__(self):
+        super().__init__(3, [(0, 0x10, 1)])
+
+    def write(self, sim, off, size, val):
+        if off == 1:
+            flag = self.mem[1] & 0x80
+            if val & 0x40:
+                flag = 0 if not sim.supply_low else 0x80
+            self.mem[1] = (val & 0x23) | flag
+        else:
+            self.set(off, val & 0x7F, size)
+        self.update(sim)
+
+    def warn(self, sim):
+        self.mem[1] |= 0x80
+        self.update(sim)
+
+    def update(self, sim):
+        sim.nvic.set_line(6, bool(self.mem[1] & 0x80 and self.mem[1] & 0x20))
+
+
+class Nvic:
+    """NVIC + SCB + SysTick registers; delivery is done by Sim.take_exception"""
+    def __init__(self, sim):
+        self.sim = sim
+        self.enabled = 0
+        self.pending = 0
+        self.lines = 0                      # Level of each peripheral request
+        self.prio = bytearray(32)
+        self.shpr3 = 0
+        self.vtor = 0
+        self.systick = [0, 0, 0]            # CSR, RVR, start cycle
+        self.reset_request = False
+
+    def set_line(self, irq, level):
+        bit = 1 << irq
+        if level and not self.lines & bit:
+            self.pend(irq)
+        self.lines = (self.lines | bit) if level else (self.lines & ~bit)
+
+    def pend(self, irq):
+        """Mark pending; stop the current batch so delivery is not deferred to its end"""
+        bit = 1 << irq
+        if not self.pending & bit:
+            self.pending |= bit
+            self.sim.pend_time.setdefault(irq + 16, self.sim.cycles)
+        if self.enabled & bit:
+            self.sim.uc.emu_stop()
+
+    def read(self, sim, off, size):
+        if off == 0x010: return self.systick[0]
+        if off == 0x014: return self.systick[1]
+        if off == 0x018:
+            period = self.systick[1] + 1
+            return self.systick[1] - (sim.cycles - self.systick[2]) % period if self.systick[0] & 1 else 0
+        if off in (0x100, 0x180): return self.enabled
+        if off in (0x200, 0x280): return self.pending
+        if 0x400 <= off < 0x420: return int.from_bytes(self.prio[off - 0x400:off - 0x400 + size], 'little')
+        if off == 0xD00: return 0x410CC601
+        if off == 0xD08: return self.vtor
+        if off == 0xD20: return self.shpr3
+        return 0
+
+    def write(self, sim, off, size, val):
+        if off == 0x010:
+            if val & 1 and not self.systick[0] & 1:
+                self.systick[2] = sim.cycles
+            self.systick[0] = val & 7
+        elif off == 0x014: self.systick[1] = val & 0xFFFFFF
+        elif off == 0x100: self.enabled |= val
+        elif off == 0x180: self.enabled &= ~val
+        elif off == 0x200:
+            for irq in range(32):
+                if val & (1 << irq):
+                    self.pend(irq)
+        elif off == 0x280: self.pending &= ~val | self.lines
+        elif 0x400 <= off < 0x420:
+            self.prio[off - 0x400:off - 0x400 + size] = val.to_bytes(size, 'little')
+        elif off == 0xD08: self.vtor = val & ~0x7F
+        elif off == 0xD0C and (val >> 16) == 0x05FA and val & 4: self.reset_request = True
+        elif off == 0xD20: self.shpr3 = val
+
+    def irq_priority(self, irq):
+        return self.prio[irq] >> 6
+
+    def next_event(self):
+        return None
+
+    def advance(self, sim):
+        pass
+
+
+class Bus:
+    """Routes an MMIO window to the models by address (unknown space = plain registers)"""
+    def __init__(self, sim, base, size):
+        self.sim, self.base = sim, base
+        self.ranges = []                    # (start, end, model)
+        self.fallback = Regs(size)
+
+    def add(self, addr, size, model):
+        self.ranges.append((addr - self.base, addr - self.base + size, model))
+
+    def find(self, off):
+        for start, end, model in self.ranges:
+            if start <= off < end:
+                return model, off - start
+        return self.fallback, off
+
+    def read(self, uc, off, size, _):
+        model, rel = self.find(off)
+        return model.read(self.sim, rel, size)
+
+    def write(self, uc, off, size, val, _):
+        model, rel = self.find(off)
+        model.write(self.sim, rel, size, val)
+
+# ============================================================================
+# SIMULATOR
+# ============================================================================
+class Simulator:
+    def __init__(self, elf, keypad, flash_image=None):
+        self.elf = elf
+        self.keypad = keypad
+        self.cycles = 0
+        self.sleep_cycles = 0
+        self.uc = Uc(UC_ARCH_ARM, UC_MODE_THUMB | UC_MODE_MCLASS)
+        try:
+            self.uc.ctl_set_cpu_model(A.UC_CPU_ARM_CORTEX_M0)
+        except (AttributeError, UcError):
+            pass
+        self.uc.mem_map(FLASH_BASE, FLASH_SIZE, UC_PROT_READ | UC_PROT_EXEC)
+        self.uc.mem_map(SRAM_BASE, SRAM_SIZE, UC_PROT_ALL)
+        self.uc.mem_map(0xF0000000, 0x4000, UC_PROT_READ | UC_PROT_WRITE)   # MTB / MCM (plain RAM)
+
+        image = bytearray(b'\xff' * FLASH_SIZE)
+        for paddr, data, _ in elf.segments:
+            if FLASH_BASE <= paddr < FLASH_BASE + FLASH_SIZE:
+                image[paddr:paddr + len(data)] = data
+        self.wfi, self.unmask = set(), set()
+        for start, end, _ in elf.functions:             # WFI -> NOP + hook (sleep is fast-forwarded)
+            for a in range(start, min(end, FLASH_SIZE) - 1, 2):
+                if image[a:a + 2] == b'\x30\xbf':
+                    image[a:a + 2] = b'\x00\xbf'
+                    self.wfi.add(a)
+                elif image[a:a + 2] == b'\x62\xb6':       # CPSIE i
+                    self.unmask.add(a + 2)
+                elif image[a:a + 4] == b'\x80\xf3\x10\x88':  # MSR PRIMASK, r0
+                    self.unmask.add(a + 4)
+        if flash_image and os.path.exists(flash_image):
+            with open(flash_image, 'rb') as f:
+                data = f.read()
+            data_start = 0x1B000
+            image[data_start:] = data[data_start:FLASH_SIZE]
+        self.uc.mem_write(FLASH_BASE, bytes(image))
+
+        # Peripherals
+        self.pend_time = {}
+        self.nvic = Nvic(self)
+        self.rc522 = Rc522()
+        self.ports = [Port(i, {0: 30, 3: 31}.get(i)) for i in range(5)]
+        self.gpio = Gpio(self)
+        self.sim_regs = Sim()
+        self.pit = Pit()
+        self.uart2 = Uart(14, 'BT ', lpsci=False)
+        self.uart0 = Uart(12, 'USB', lpsci=True)
+        self.ftfa = Ftfa()
+        self.pmc = Pmc()
+        self.rcm = Regs(8, [(0, 0x82, 1)])              # POR + LVD
+        self.cop_configure(0x0C)
+        self.models = [self.pit, self.uart2, self.uart0, self.ftfa]
+        self.supply_low = False
+
+        periph = Bus(self, PERIPH_BASE, PERIPH_SIZE)
+        periph.add(0x40047000, 0x1108, self.sim_regs)
+        periph.add(0x40064000, 0x10, Mcg(0x10, [(0, 0x04, 1), (1, 0x80, 1), (6, 0x10, 1)]))
+        periph.add(0x4007E000, 4, Regs(4, [(3, 0x01, 1)]))          # SMC: PMSTAT = RUN
+        periph.add(0x40037000, 0x120, self.pit)
+        periph.add(0x4006C000, 0x10, self.uart2)
+        periph.add(0x4006A000, 0x10, self.uart0)
+        periph.add(0x40076000, 8, Spi(self.rc522))
+        periph.add(0x40020000, 0x14, self.ftfa)
+        periph.add(0x4007D000, 3, self.pmc)
+        periph.add(0x4007F000, 8, self.rcm)
+        for i in range(5):
+            periph.add(0x40049000 + 0x1000 * i, 0xA4, self.ports[i])
+        self.uc.mmio_map(PERIPH_BASE, PERIPH_SIZE, periph.read, None, periph.write, None)
+        gpio = Bus(self, GPIO_BASE, 0x1000)
+        gpio.add(GPIO_BASE, 0x140, self.gpio)
+        self.uc.mmio_map(GPIO_BASE, 0x1000, gpio.read, None, gpio.write, None)
+        fgpio = Bus(self, FGPIO_BASE, 0x1000)
+        fgpio.add(FGPIO_BASE, 0x140, self.gpio)
+        self.uc.mmio_map(FGPIO_BASE, 0x1000, fgpio.read, None, fgpio.write, None)
+        ppb = Bus(self, PPB_BASE, 0x1000)
+        ppb.add(PPB_BASE, 0x1000, self.nvic)
+        self.uc.mmio_map(PPB_BASE, 0x1000, ppb.read, None, ppb.write, None)
+
+        # Profiling
+        self.blocks = {}                    # addr -> (func, [(offset, cycles)], last kind, size)
+        self.func_cycles = {}
+        self.func_calls = {}
+        self.last_block = None
+        self.pending_cond = None            # (fallthrough addr, func) of a conditional branch
+        self.active = []                    # [exception number, entry cycle, cycles in nested]
+        self.irq_stats = {}                 # exc -> [count, cycles, max cycles, max latency]
+        self.pend_time = {}
+        self.uc.hook_add(UC_HOOK_BLOCK, self.on_block)
+        for a in self.wfi:
+            self.uc.hook_add(UC_HOOK_CODE, self.on_wfi, begin=a, end=a)
+        for a in self.unmask:
+            self.uc.hook_add(UC_HOOK_CODE, self.on_unmask, begin=a, end=a)
+        self.in_wfi = False
+        self.systick_pending = False
+
+        # Watchdog
+        self.kicks = 0
+        self.resets = []
+        self.events = []                    # (cycle, callable, description)
+        self.reset_cpu()
+
+    # ----- Reset --------------------------------------------------------------
+    def reset_cpu(self):
+        vtor = 0
+        sp, pc = struct.unpack('<II', self.uc.mem_read(vtor, 8))
+        for reg in CORE_REGS[:13]:
+            self.uc.reg_write(reg, 0)
+        self.uc.reg_write(A.UC_ARM_REG_SP, sp)
+        self.uc.reg_write(A.UC_ARM_REG_LR, 0xFFFFFFFF)
+        self.uc.reg_write(A.UC_ARM_REG_PC, pc & ~1)
+        self.active = []
+        self.pc = pc & ~1
+
+    def reset(self, kind, lose_ram=False):
+        """WDOG / SW keep RAM (.noinit checkpoint); POR after a brown-out clears it"""
+        self.resets.append((self.cycles, kind))
+        print('--- %s reset @ %.3f ms ---' % (kind, self.cycles * 1000.0 / CORE_HZ))
+        if lose_ram:
+            self.uc.mem_write(SRAM_BASE, b'\xa5' * SRAM_SIZE)
+        self.rcm.set(0, {'WDOG': 0x20, 'POR': 0x82, 'SW': 0x00}[kind], 1)
+        self.rcm.set(1, 0x04 if kind == 'SW' else 0, 1)
+        self.nvic.__init__(self)
+        for port in self.ports:
+            port.mem[:] = bytes(len(port.mem))
+        self.gpio.pdor, self.gpio.pddr = [0] * 5, [0] * 5
+        self.pit.mem[:] = bytes(len(self.pit.mem))
+        self.uart2.mem[:] = bytes(0x10)
+        self.uart0.mem[:] = bytes(0x10)
+        self.pmc.mem[1] = 0x10 | (0x80 if self.supply_low else 0)
+        self.sim_regs.set(0x1100, 0x0C, 4)              # COP enabled out of reset
+        self.sim_regs.copc_written = False
+        self.cop_configure(0x0C)
+        self.ftfa.busy_until = None
+        self.ftfa.mem[0] = 0x80
+        self.pend_time = {}
+        self.in_wfi = False
+        self.pending_cond = None
+        self.last_block = None
+        self.rc522.reset()
+        self.reset_cpu()
+
+    def cop_configure(self, val):
+        """COPT 1/2/3 = 2^5/2^8/2^10 LPO (1 kHz) or 2^13/2^16/2^18 bus clocks (COPCLKS)"""
+        copt = (val >> 2) & 3
+        if copt == 0:
+            self.cop_timeout = None
+        elif val & 2:
+            self.cop_timeout = (1 << (13, 16, 18)[copt - 1]) * (CORE_HZ // BUS_HZ)
+        else:
+            self.cop_timeout = ms_to_cycles(1 << (5, 8, 10)[copt - 1])
+        self.last_kick = self.cycles
+
+    def note(self, text):
+        print('--- %.3f ms: %s ---' % (self.cycles * 1000.0 / CORE_HZ, text))
+
+    def cop_kick(self):
+        self.kicks += 1
+        self.last_kick = self.cycles
+
+    # ----- Profiling ----------------------------------------------------------
+    def decode_block(self, addr, size):
+        code = bytes(self.uc.mem_read(addr, size + 2))
+        insns, off, kind = [], 0, ''
+        while off < size:
+            hw, hw2 = struct.unpack_from('<HH', code, off)
+            cyc, length, kind = insn_cycles(hw, hw2)
+            insns.append((off, cyc))
+            off += length
+        return (self.elf.function_at(addr), insns, kind, size)
+
+    def on_block(self, uc, addr, size, _):
+        if self.pending_cond is not None:
+            fallthrough, func = self.pending_cond
+            if addr != fallthrough:
+                self.charge(func, 1)                        # Taken conditional branch
+            self.pending_cond = None
+        blk = self.blocks.get(addr)
+        if blk is None:
+            blk = self.blocks[addr] = self.decode_block(addr, size)
+        func, insns, kind, size = blk
+        if self.elf.starts and addr == self.func_start(addr):
+            self.func_calls[func] = self.func_calls.get(func, 0) + 1
+        self.charge(func, sum(c for _, c in insns))
+        self.last_block = (addr, blk)
+        if kind == 'cond':
+            self.pending_cond = (addr + size, func)
+
+    def func_start(self, addr):
+        i = bisect.bisect_right(self.elf.starts, addr) - 1
+        return self.elf.starts[i] if i >= 0 else None
+
+    def charge(self, func, cyc):
+        self.cycles += cyc
+        self.func_cycles[func] = self.func_cycles.get(func, 0) + cyc
+
+    def uncharge_tail(self, pc):
+        """Emulation stopped inside the last block: refund instructions not executed"""
+        if self.last_block is None:
+            return
+        addr, (func, insns, kind, size) = self.last_block
+        if addr <= pc < addr + size:
+            refund = sum(c for off, c in insns if addr + off >= pc)
+            self.charge(func, -refund)
+            if kind == 'cond':
+                self.pending_cond = None
+        self.last_block = None
+
+    def on_wfi(self, uc, addr, size, _):
+        self.in_wfi = True
+        uc.emu_stop()
+
+    def on_unmask(self, uc, addr, size, _):
+        if self.nvic.pending & self.nvic.enabled and not uc.reg_read(A.UC_ARM_REG_PRIMASK) & 1:
+            uc.emu_stop()
+
+    # ----- Exceptions ---------------------------------------------------------
+    def current_priority(self):
+        """Execution priority: 4 = thread, PRIMASK masks every configurable exception"""
+        if self.uc.reg_read(A.UC_ARM_REG_PRIMASK) & 1:
+            return -1
+        prio = 4
+        for exc, _, _ in self.active:
+            prio = min(prio, self.exc_priority(exc))
+        return prio
+
+    def exc_priority(self, exc):
+        if exc == 15:
+            return self.nvic.shpr3 >> 30
+        return self.nvic.irq_priority(exc - 16)
+
+    def next_exception(self):
+        ready = self.nvic.pending & self.nvic.enabled
+        best = None
+        for irq in range(32):
+            if ready & (1 << irq):
+                p = self.nvic.irq_priority(irq)
+                if best is None or p < best[0]:
+                    best = (p, irq + 16)
+        if self.nvic.systick[0] & 2 and self.systick_pending:
+            p = self.nvic.shpr3 >> 30
+            if best is None or p < best[0]:
+                best = (p, 15)
+        if best is not None and best[0] < self.current_priority():
+            return best[1]
+        return None
+
+    def take_exception(self, exc):
+        uc = self.uc
+        if self.pending_cond is not None:
+            if self.pc != self.pending_cond[0]:
+                self.charge(self.pending_cond[1], 1)
+            self.pending_cond = None
+        self.last_block = None
+        self.in_wfi = False
+        sp = uc.reg_read(A.UC_ARM_REG_SP)
+        xpsr = uc.reg_read(A.UC_ARM_REG_XPSR)
+        align = sp & 4
+        if align:
+            sp -= 4
+            xpsr |= 1 << 9
+        regs = [uc.reg_read(r) for r in (A.UC_ARM_REG_R0, A.UC_ARM_REG_R1, A.UC_ARM_REG_R2,
+                                         A.UC_ARM_REG_R3, A.UC_ARM_REG_R12, A.UC_ARM_REG_LR)]
+        sp -= 32
+        uc.mem_write(sp, struct.pack('<8I', *(regs + [self.pc, xpsr])))
+        uc.reg_write(A.UC_ARM_REG_SP, sp)
+        uc.reg_write(A.UC_ARM_REG_LR, 0xFFFFFFF9 if not self.active else 0xFFFFFFF1)
+        vector = struct.unpack('<I', uc.mem_read(self.nvic.vtor + 4 * exc, 4))[0]
+        self.pc = vector & ~1
+        if exc >= 16:
+            self.nvic.pending &= ~(1 << (exc - 16))
+        else:
+            self.systick_pending = False
+        latency = self.cycles - self.pend_time.pop(exc, self.cycles)
+        self.charge(self.name_of(exc), EXC_ENTRY_CYCLES)
+        self.active.append([exc, self.cycles, 0])
+        st = self.irq_stats.setdefault(exc, [0, 0, 0, 0])
+        st[0] += 1
+        st[3] = max(st[3], latency)
+
+    def return_from_exception(self):
+        uc = self.uc
+        exc, entered, nested = self.active.pop()
+        self.charge(self.name_of(exc), EXC_EXIT_CYCLES)
+        run = self.cycles - entered - nested
+        st = self.irq_stats[exc]
+        st[1] += run
+        st[2] = max(st[2], run)
+        if self.active:
+            self.active[-1][2] += self.cycles - entered
+        sp = uc.reg_read(A.UC_ARM_REG_SP)
+        r0, r1, r2, r3, r12, lr, pc, xpsr = struct.unpack('<8I', uc.mem_read(sp, 32))
+        sp += 32 + (4 if xpsr & (1 << 9) else 0)
+        for reg, val in zip((A.UC_ARM_REG_R0, A.UC_ARM_REG_R1, A.UC_ARM_REG_R2, A.UC_ARM_REG_R3,
+                             A.UC_ARM_REG_R12, A.UC_ARM_REG_LR), (r0, r1, r2, r3, r12, lr)):
+            uc.reg_write(reg, val)
+        uc.reg_write(A.UC_ARM_REG_SP, sp)
+        try:
+            uc.reg_write(A.UC_ARM_REG_XPSR, (xpsr & 0xF8000000) | (1 << 24))
+        except UcError:
+            uc.reg_write(A.UC_ARM_REG_APSR, xpsr & 0xF8000000)
+        self.pc = pc & ~1
+
+    def exception_return_at(self, pc):
+        """True if the core stopped on an EXC_RETURN branch (BX / POP {pc}); completes it"""
+        if (pc & EXC_RETURN_BASE) == EXC_RETURN_BASE:
+            return True
+        hw = struct.unpack('<H', self.uc.mem_read(pc, 2))[0]
+        if (hw & 0xFF87) == 0x4700:                             # BX rm
+            return (self.uc.reg_read(CORE_REGS[(hw >> 3) & 15]) & EXC_RETURN_BASE) == EXC_RETURN_BASE
+        if (hw & 0xFF00) == 0xBD00:                             # POP {..., pc}
+            sp = self.uc.reg_read(A.UC_ARM_REG_SP)
+            regs = [r for r in range(8) if hw & (1 << r)]
+            values = struct.unpack('<%uI' % (len(regs) + 1), self.uc.mem_read(sp, 4 * (len(regs) + 1)))
+            if (values[-1] & EXC_RETURN_BASE) != EXC_RETURN_BASE:
+                return False
+            for r, v in zip(regs, values):
+                self.uc.reg_write(CORE_REGS[r], v)
+            self.uc.reg_write(A.UC_ARM_REG_SP, sp + 4 * len(values))
+            return True
+        return False
+
+    def name_of(self, exc):
+        if exc == 15:
+            return 'SysTick_Handler'
+        vector = struct.unpack('<I', self.uc.mem_read(self.nvic.vtor + 4 * exc, 4))[0]
+        return self.elf.function_at(vector & ~1)
+
+    # ----- Main loop ----------------------------------------------------------
+    def schedule(self, at, action, what):
+        self.events.append((at, action, what))
+        self.events.sort(key=lambda e: e[0])
+
+    def next_event(self):
+        times = [m.next_event() for m in self.models]
+        times = [t for t in times if t is not None]
+        if self.events:
+            times.append(self.events[0][0])
+        if self.cop_timeout is not None:
+            times.append(self.last_kick + self.cop_timeout)
+        if self.nvic.systick[0] & 1:
+            period = self.nvic.systick[1] + 1
+            times.append(self.cycles + period - (self.cycles - self.nvic.systick[2]) % period)
+        return min(times) if times else None
+
+    def advance(self):
+        for m in self.models:
+            m.advance(self)
+        for port in self.ports:
+            port.update(self)
+        self.pmc.update(self)
+        if self.nvic.systick[0] & 1:
+            period = self.nvic.systick[1] + 1
+            if self.cycles - self.nvic.systick[2] >= period:
+                self.nvic.systick[2] += period * ((self.cycles - self.nvic.systick[2]) // period)
+                self.systick_pending = True
+        while self.events and self.cycles >= self.events[0][0]:
+            _, action, _ = self.events.pop(0)
+            action()
+        active = sum(1 << (exc - 16) for exc, _, _ in self.active if exc >= 16)
+        for irq in range(32):                                   # Level-sensitive lines re-pend
+            if self.nvic.lines & ~active & ~self.nvic.pending & (1 << irq):
+                self.nvic.pend(irq)
+        if self.cop_timeout is not None and self.cycles - self.last_kick >= self.cop_timeout:
+            self.reset('WDOG')
+        if self.nvic.reset_request:
+            self.reset('SW')
+
+    def run(self, end):
+        while self.cycles < end:
+            self.advance()
+            exc = self.next_exception()
+            if exc is not None:
+                self.take_exception(exc)
+                continue
+
+            if self.in_wfi:
+                self.in_wfi = False
+                if self.nvic.pending & self.nvic.enabled:
+                    continue                                    # WFI wakes on masked pending too
+                nxt = self.next_event()
+                target = min(nxt if nxt is not None else end, end)
+                if target > self.cycles:
+                    self.sleep_cycles += target - self.cycles
+                    self.func_cycles['(sleep)'] = self.func_cycles.get('(sleep)', 0) + target - self.cycles
+                    self.cycles = target
+                continue
+
+            nxt = self.next_event()
+            budget = (min(nxt, end) if nxt is not None else end) - self.cycles
+            count = max(1, min(budget, 20000) // 2)
+            try:
+                self.uc.emu_start(self.pc | 1, 0xFFFFFFFF, count=count)
+                self.pc = self.uc.reg_read(A.UC_ARM_REG_PC)
+                self.uncharge_tail(self.pc)
+                if self.in_wfi and self.pc in self.wfi:
+                    self.pc += 2
+            except UcError as err:
+                pc = self.uc.reg_read(A.UC_ARM_REG_PC)
+                if self.active and self.exception_return_at(pc):
+                    self.last_block = None
+                    self.pending_cond = None
+                    self.return_from_exception()
+                    continue
+                print('*** CPU fault at 0x%08X (%s): %s' % (pc, self.elf.function_at(pc), err))
+                return False
+        return True
+
+    # ----- Report -------------------------------------------------------------
+    def report(self, top):
+        busy = self.cycles - self.sleep_cycles
+        print()
+        print('Simulated %.1f ms, %u cycles @ %u MHz, CPU busy %.1f%%' %
+              (self.cycles * 1000.0 / CORE_HZ, self.cycles, CORE_HZ // 1000000,
+               100.0 * busy / max(1, self.cycles)))
+        print('COP kicks %u, resets: %s' % (self.kicks, ', '.join(k for _, k in self.resets) or 'none'))
+        print('Flash: %u longword programs, %u sector erases' %
+              (self.ftfa.commands['program'], self.ftfa.commands['erase']))
+        print()
+        rows = sorted(((c, f) for f, c in self.func_cycles.items() if f != '(sleep)'), reverse=True)[:top]
+        width = max([len('Function')] + [len(f) for _, f in rows])
+        print('%-*s  %8s  %12s  %6s' % (width, 'Function', 'Calls', 'Cycles', 'Busy%'))
+        print('-' * (width + 34))
+        for cyc, func in rows:
+            print('%-*s  %8u  %12u  %5.1f%%' % (width, func, self.func_calls.get(func, 0), cyc,
+                                                100.0 * cyc / max(1, busy)))
+        if self.irq_stats:
+            print()
+            print('%-22s  %7s  %10s  %10s  %12s' % ('Exception', 'Count', 'Avg (us)', 'Max (us)', 'Max lat (us)'))
+            print('-' * 68)
+            for exc, (n, cyc, mx, lat) in sorted(self.irq_stats.items()):
+                name = IRQ_NAMES.get(exc - 16, self.name_of(exc))
+                print('%-22s  %7u  %10.2f  %10.2f  %12.2f' % (name, n, us(cyc / max(1, n)), us(mx), us(lat)))
+
+    def save_flash(self, path):
+        with open(path, 'wb') as f:
+            f.write(bytes(self.uc.mem_read(FLASH_BASE, FLASH_SIZE)))
+
+# ============================================================================
+# BOARD DESCRIPTION (keypad matrix from source/board_pins.h)
+# ============================================================================
+def load_keypad(root):
+    path = os.path.join(root, 'source', 'board_pins.h')
+    try:
+        text = open(path).read()
+    except OSError:
+        return None
+    def grab(name):
+        m = re.search(r'#define\s+BOARD_KP_MAIN_%s\s+(.*)' % name, text)
+        return m.group(1).strip() if m else None
+    rows, cols = grab(r'ROWS\(X\)'), grab(r'COLS\(X\)')
+    row_port, col_port, keymap = grab('ROW_PORT'), grab('COL_PORT'), grab('KEYMAP')
+    if None in (rows, cols, row_port, col_port, keymap):
+        return None
+    keymap = ''.join(re.findall(r'"([^"]*)"', keymap))
+    rows = [int(x) for x in re.findall(r'X\((\d+)\)', rows)]
+    cols = [int(x) for x in re.findall(r'X\((\d+)\)', cols)]
+    return {'row_port': 'ABCDE'.index(row_port), 'col_port': 'ABCDE'.index(col_port),
+            'rows': rows, 'cols': cols, 'keymap': keymap}
+
+# ============================================================================
+# SCRIPTED INPUTS
+# ============================================================================
+def split_at(spec):
+    at, _, rest = spec.partition(':')
+    return ms_to_cycles(float(at)), rest
+
+def parse_text(text):
+    text = codecs.decode(text, 'unicode_escape')
+    return text if text.endswith('\n') else text + '\r\n'
+
+def credential_block(site, user):
+    blk = [site >> 8, site & 0xFF, (user >> 24) & 0xFF, (user >> 16) & 0xFF, (user >> 8) & 0xFF,
+           user & 0xFF, 0, 0, 0, 0, 0, 0, 0, 0, 0]
+    chk = 0
+    for b in blk:
+        chk ^= b
+    return bytes(blk + [chk])
+
+def main():
+    ap = argparse.ArgumentParser(description='Run the firmware ELF on a Cortex-M0+ ISA emulator.')
+    ap.add_argument('elf')
+    ap.add_argument('--ms', type=float, default=3000, help='simulated time (default 3000 ms)')
+    ap.add_argument('--top', type=int, default=25, help='functions in the report')
+    ap.add_argument('--bt', action='append', default=[], metavar='MS:TEXT', help='line received by UART2 (HC-05)')
+    ap.add_argument('--usb', action='append', default=[], metavar='MS:TEXT', help='line received by UART0 (wired port)')
+    ap.add_argument('--keys', action='append', default=[], metavar='MS:KEYS', help='keypad presses (100 ms each)')
+    ap.add_argument('--card', action='append', default=[], metavar='MS:UID[:SITE:USER]',
+                    help='card held at the reader for 300 ms (transport key FF..FF)')
+    ap.add_argument('--pir', action='append', default=[], metavar='MS', help='PIR pulse on PTA5 (200 ms)')
+    ap.add_argument('--lvw', type=float, metavar='MS', help='supply sags: LVW at MS, power lost 4 ms later')
+    ap.add_argument('--flash', metavar='FILE', help='load/save the data sectors (config, journal, audit)')
+    args = ap.parse_args()
+
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    sim = Simulator(Elf(args.elf), load_keypad(root), args.flash)
+    end = ms_to_cycles(args.ms)
+
+    for spec in args.bt:
+        at, text = split_at(spec)
+        sim.schedule(at, lambda t=parse_text(text), a=at: sim.uart2.send(max(a, sim.cycles), t), 'bt')
+    for spec in args.usb:
+        at, text = split_at(spec)
+        sim.schedule(at, lambda t=parse_text(text), a=at: sim.uart0.send(max(a, sim.cycles), t), 'usb')
+    for spec in args.keys:
+        at, keys = split_at(spec)
+        kp = sim.keypad
+        if kp is None:
+            sys.exit('keypad layout not found in source/board_pins.h')
+        for i, key in enumerate(keys):
+            idx = kp['keymap'].index(key)
+            rc = (idx // len(kp['cols']), idx % len(kp['cols']))
+            t = at + i * ms_to_cycles(200)
+            sim.schedule(t, lambda rc=rc: sim.gpio.keys_down.add(rc), 'key down')
+            sim.schedule(t + ms_to_cycles(100), lambda rc=rc: sim.gpio.keys_down.discard(rc), 'key up')
+    for spec in args.card:
+        at, rest = split_at(spec)
+        parts = rest.split(':')
+        uid = bytes.fromhex(parts[0])
+        site, user = (int(parts[1], 0), int(parts[2], 0)) if len(parts) == 3 else (1, 0)   # RFID_DEFAULT_SITE
+        card = {'uid': uid, 'key': b'\xff' * 6, 'block': credential_block(site, user), 'halted': False}
+        sim.schedule(at, lambda c=card: setattr(sim.rc522, 'card', c), 'card on')
+        sim.schedule(at + ms_to_cycles(300), lambda: setattr(sim.rc522, 'card', None), 'card off')
+    for spec in args.pir:
+        at = ms_to_cycles(float(spec))
+        sim.schedule(at, lambda: sim.gpio.force(0, 5, 1), 'pir on')
+        sim.schedule(at + ms_to_cycles(200), lambda: sim.gpio.force(0, 5, 0), 'pir off')
+    if args.lvw is not None:
+        at = ms_to_cycles(args.lvw)
+        def sag():
+            sim.supply_low = True
+            sim.pmc.warn(sim)
+        def restore():
+            sim.supply_low = False
+            sim.reset('POR', lose_ram=True)
+        sim.schedule(at, sag, 'lvw')
+        sim.schedule(at + ms_to_cycles(4), restore, 'power lost')
+
+    ok = sim.run(end)
+    sim.report(args.top)
+    if args.flash:
+        sim.save_flash(args.flash)
+    sys.exit(0 if ok else 1)
+
+if __name__ == '__main__':
+    main()
@@ -91,6 +91,9 @@
 #include "fsl_usart.h"
 #endif /* FSL_FEATURE_SOC_FLEXCOMM_COUNT */
 
+/* DEBUGCONSOLE_DISABLE: the header provides inline stubs, nothing to build here. */
+#if (SDK_DEBUGCONSOLE != DEBUGCONSOLE_DISABLE)
+
 /*! @brief Keil: suppress ellipsis warning in va_arg usage below. */
 #if defined(__CC_ARM)
 #pragma diag_suppress 1256
@@ -216,7 +219,7 @@ static debug_console_state_t s_debugConsole = {.type = DEBUG_CONSOLE_DEVICE_TYPE
 /*******************************************************************************
  * Prototypes
  ******************************************************************************/
-#if SDK_DEBUGCONSOLE
+#if (SDK_DEBUGCONSOLE == DEBUGCONSOLE_REDIRECT_TO_SDK)
 static int DbgConsole_PrintfFormattedData(PUTCHAR_FUNC func_ptr, const char *fmt, va_list ap);
 static int DbgConsole_ScanfFormattedData(const char *line_ptr, char *format, va_list args_ptr);
 double modf(double input_dbl, double *intpart_ptr);
@@ -388,7 +391,7 @@ status_t DbgConsole_Deinit(void)
     return kStatus_Success;
 }
 
-#if SDK_DEBUGCONSOLE
+#if (SDK_DEBUGCONSOLE == DEBUGCONSOLE_REDIRECT_TO_SDK)
 /* See fsl_debug_console.h for documentation of this function. */
 int DbgConsole_Printf(const char *fmt_s, ...)
 {
@@ -1957,3 +1960,5 @@ int fgetc(FILE *f)
     return ch;
 }
 #endif /* __ICCARM__ */
+
+#endif /* SDK_DEBUGCONSOLE != DEBUGCONSOLE_DISABLE */
@@ -55,12 +55,17 @@
  * Definitions
  ******************************************************************************/
 
+/*! @brief Definition select redirect toolchain printf, scanf to uart or not. */
+#define DEBUGCONSOLE_REDIRECT_TO_TOOLCHAIN 0U /*!< Select toolchain printf and scanf. */
+#define DEBUGCONSOLE_REDIRECT_TO_SDK 1U       /*!< Select SDK version printf, scanf. */
+#define DEBUGCONSOLE_DISABLE 2U               /*!< Disable debugconsole function (stub backend). */
+
 /*! @brief Definition to select sdk or toolchain printf, scanf. */
 #ifndef SDK_DEBUGCONSOLE
-#define SDK_DEBUGCONSOLE 1U
+#define SDK_DEBUGCONSOLE DEBUGCONSOLE_REDIRECT_TO_SDK
 #endif
 
-#if defined(SDK_DEBUGCONSOLE) && !(SDK_DEBUGCONSOLE)
+#if defined(SDK_DEBUGCONSOLE) && (SDK_DEBUGCONSOLE == DEBUGCONSOLE_REDIRECT_TO_TOOLCHAIN)
 #include <stdio.h>
 #endif
 
@@ -84,7 +89,12 @@
 #define SCANF_ADVANCED_ENABLE 0U
 #endif /* SCANF_ADVANCED_ENABLE */
 
-#if SDK_DEBUGCONSOLE /* Select printf, scanf, putchar, getchar of SDK version. */
+#if SDK_DEBUGCONSOLE == DEBUGCONSOLE_DISABLE /* Disable debug console: calls compile to nothing. */
+#define PRINTF(...) ((void)0)
+#define SCANF(...) (0)
+#define PUTCHAR(...) ((void)0)
+#define GETCHAR() (0)
+#elif SDK_DEBUGCONSOLE == DEBUGCONSOLE_REDIRECT_TO_SDK /* Select printf, scanf, putchar, getchar of SDK version. */
 #define PRINTF DbgConsole_Printf
 #define SCANF DbgConsole_Scanf
 #define PUTCHAR DbgConsole_Putchar
@@ -128,7 +138,14 @@ extern "C" {
  * @retval kStatus_Fail             Execution failure
  * @retval kStatus_InvalidArgument  Invalid argument existed
  */
+#if SDK_DEBUGCONSOLE == DEBUGCONSOLE_DISABLE
+static inline status_t DbgConsole_Init(uint32_t baseAddr, uint32_t baudRate, uint8_t device, uint32_t clkSrcFreq)
+{
+    return kStatus_Success;
+}
+#else
 status_t DbgConsole_Init(uint32_t baseAddr, uint32_t baudRate, uint8_t device, uint32_t clkSrcFreq);
+#endif
 
 /*!
  * @brief De-initializes the peripheral used for debug messages.
@@ -138,9 +155,16 @@ status_t DbgConsole_Init(uint32_t baseAddr, uint32_t baudRate, uint8_t device, u
  *
  * @return Indicates whether de-initialization was successful or not.
  */
+#if SDK_DEBUGCONSOLE == DEBUGCONSOLE_DISABLE
+static inline status_t DbgConsole_Deinit(void)
+{
+    return kStatus_Success;
+}
+#else
 status_t DbgConsole_Deinit(void);
+#endif
 
-#if SDK_DEBUGCONSOLE
+#if SDK_DEBUGCONSOLE == DEBUGCONSOLE_REDIRECT_TO_SDK
 /*!
  * @brief Writes formatted output to the standard output stream.
  *